@@ -615,8 +615,7 @@ void WorldSession::HandleAuctionListItems(WorldPacket & recv_data)
     if (sortCount >= MAX_AUCTION_SORT)
         return;
 
-    uint8 Sort[MAX_AUCTION_SORT];
-    memset(Sort, MAX_AUCTION_SORT, MAX_AUCTION_SORT);
+    AuctionListFilter filter;
 
     // auction columns sorting
     for (uint32 i = 0; i < sortCount; ++i)
@@ -628,9 +627,12 @@ void WorldSession::HandleAuctionListItems(WorldPacket & recv_data)
             return;
 
         recv_data >> reversed;
-        Sort[i] = (reversed > 0) ? (column |= AUCTION_SORT_REVERSED) : column;
+        filter.sort[i] = (reversed > 0) ? (column |= AUCTION_SORT_REVERSED) : column;
     }
 
+    if (!sWorld.getConfig(CONFIG_ENABLE_SORT_AUCTIONS))
+        memset(filter.sort, MAX_AUCTION_SORT, MAX_AUCTION_SORT);
+
     AuctionHouseEntry const* auctionHouseEntry = GetCheckedAuctionHouseForAuctioneer(auctioneerGuid);
     if (!auctionHouseEntry)
         return;
@@ -638,22 +640,6 @@ void WorldSession::HandleAuctionListItems(WorldPacket & recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
-    std::vector<AuctionEntry*> auctions;
-
-    bool sortEnabled = sWorld.getConfig(CONFIG_ENABLE_SORT_AUCTIONS);
-
-    if (sortEnabled)
-    {
-        auctions.reserve(aucs.size());
-        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = aucs.begin(); itr != aucs.end(); ++itr)
-            auctions.push_back(itr->second);
-
-        AuctionSorter sorter(Sort, GetPlayer());
-        std::sort(auctions.begin(), auctions.end(), sorter);
-    }
-
     // remove fake death
     if (GetPlayer()->hasUnitState(UNIT_STAT_DIED))
         GetPlayer()->RemoveSpellsCausingAura(SPELL_AURA_FEIGN_DEATH);
@@ -667,22 +653,20 @@ void WorldSession::HandleAuctionListItems(WorldPacket & recv_data)
     data << uint32(0);
 
     // converting string that we try to find to lower case
-    std::wstring wsearchedname;
-    if (!Utf8toWStr(searchedname, wsearchedname))
+    if (!Utf8toWStr(searchedname, filter.name))
         return;
 
-    wstrToLower(wsearchedname);
+    wstrToLower(filter.name);
 
-    if (sortEnabled)
-    {
-        BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
-            auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull);
-    }
-    else
-    {
-        BuildListAuctionItems(aucs, data, wsearchedname, listfrom, levelmin, levelmax, usable,
-            auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull);
-    }
+    filter.levelMin = levelmin;
+    filter.levelMax = levelmax;
+    filter.inventoryType = auctionSlotID;
+    filter.itemClass = auctionMainCategory;
+    filter.itemSubClass = auctionSubCategory;
+    filter.quality = quality;
+    filter.locIdx = GetSessionDbLocaleIndex();
+
+    BuildListAuctionItems(auctionHouse, filter, data, listfrom, usable, count, totalcount, isFull);
 
     data.put<uint32>(0, count);
     data << uint32(totalcount);
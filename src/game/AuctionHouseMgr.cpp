@@ -563,6 +563,24 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
+std::wstring const& AuctionHouseMgr::GetItemSearchName(ItemPrototype const* proto, int32 locIdx)
+{
+    uint64 key = (uint64(locIdx + 1) << 32) | proto->ItemId;
+
+    ItemSearchNameMap::const_iterator itr = mItemSearchNames.find(key);
+    if (itr != mItemSearchNames.end())
+        return itr->second;
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, locIdx, &name);
+
+    std::wstring& wname = mItemSearchNames[key];
+    if (Utf8toWStr(name, wname))
+        wstrToLower(wname);
+
+    return wname;
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
@@ -580,12 +598,15 @@ void AuctionHouseObject::Update()
             ///- cancel the auction if there was no bidder and clear the auction
             else
             {
-                sAuctionMgr.SendAuctionExpiredMail(itr->second);
+                AuctionEntry* auction = itr->second;
+                ++itr;
 
-                itr->second->DeleteFromDB();
-                sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
-                delete itr->second;
-                AuctionsMap.erase(itr++);
+                sAuctionMgr.SendAuctionExpiredMail(auction);
+
+                auction->DeleteFromDB();
+                sAuctionMgr.RemoveAItem(auction->itemGuidLow);
+                RemoveAuction(auction->Id);
+                delete auction;
             }
         }
         else
@@ -621,7 +642,7 @@ void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player,
     }
 }
 
-int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry *auc, Player* viewPlayer) const
+int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry *auc, int32 locIdx) const
 {
     switch (column)
     {
@@ -684,13 +705,11 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry *auc, Pl
             if (!itemProto2 || !itemProto1)
                 return 0;
 
-            int32 loc_idx = viewPlayer->GetSession()->GetSessionDbLocaleIndex();
-
             std::string name1 = itemProto1->Name1;
-            sObjectMgr.GetItemLocaleStrings(itemProto1->ItemId, loc_idx, &name1);
+            sObjectMgr.GetItemLocaleStrings(itemProto1->ItemId, locIdx, &name1);
 
             std::string name2 = itemProto2->Name1;
-            sObjectMgr.GetItemLocaleStrings(itemProto2->ItemId, loc_idx, &name2);
+            sObjectMgr.GetItemLocaleStrings(itemProto2->ItemId, locIdx, &name2);
 
             std::wstring wname1, wname2;
             Utf8toWStr(name1, wname1);
@@ -764,7 +783,7 @@ bool AuctionSorter::operator()(const AuctionEntry *auc1, const AuctionEntry *auc
         if (m_sort[i] == MAX_AUCTION_SORT)                  // end of sort
             return false;
 
-        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_viewPlayer);
+        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_locIdx);
         // "equal" by used column
         if (res == 0)
             continue;
@@ -775,122 +794,303 @@ bool AuctionSorter::operator()(const AuctionEntry *auc1, const AuctionEntry *auc
     return false;                                           // "equal" by all sorts
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
-    uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull)
+void WorldSession::BuildListAuctionItems(AuctionHouseObject* auctionHouse, AuctionListFilter const& filter, WorldPacket& data, uint32 listfrom, uint32 usable,
+    uint32& count, uint32& totalcount, bool isFull)
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
+    if (isFull)
+    {
+        AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = aucs.begin(); itr != aucs.end(); ++itr)
+        {
+            if (itr->second->BuildAuctionInfo(data))
+                ++count;
+        }
+
+        totalcount = count;
+        return;
+    }
 
-    for (std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+    std::vector<uint32> const& auctions = auctionHouse->GetAuctionList(filter);
+
+    // without usable check result list is final (only auctions with item), only requested page has to be visited
+    if (!usable)
+    {
+        for (uint32 i = listfrom; i < auctions.size() && count < AUCTION_LIST_PAGE_SIZE; ++i)
+        {
+            if (AuctionEntry* Aentry = auctionHouse->GetAuction(auctions[i]))
+            {
+                if (Aentry->BuildAuctionInfo(data))
+                    ++count;
+            }
+        }
+
+        totalcount = auctions.size();
+        return;
+    }
+
+    for (std::vector<uint32>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
     {
-        AuctionEntry *Aentry = *itr;
+        AuctionEntry *Aentry = auctionHouse->GetAuction(*itr);
+        if (!Aentry)
+            continue;
+
         Item *item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
+        if (!item || !_player->CanUseItem(item))
             continue;
 
-        if (isFull)
+        if (count < AUCTION_LIST_PAGE_SIZE && totalcount >= listfrom)
         {
             ++count;
             Aentry->BuildAuctionInfo(data);
         }
-        else
-        {
-            ItemPrototype const *proto = item->GetProto();
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+        ++totalcount;
+    }
+}
+
+AuctionListFilter::AuctionListFilter() : levelMin(0), levelMax(0), inventoryType(AUCTION_FILTER_ANY), itemClass(AUCTION_FILTER_ANY),
+    itemSubClass(AUCTION_FILTER_ANY), quality(AUCTION_FILTER_ANY), locIdx(-1)
+{
+    memset(sort, MAX_AUCTION_SORT, MAX_AUCTION_SORT);
+}
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+bool AuctionListFilter::operator<(AuctionListFilter const& other) const
+{
+    if (itemClass != other.itemClass)
+        return itemClass < other.itemClass;
+    if (itemSubClass != other.itemSubClass)
+        return itemSubClass < other.itemSubClass;
+    if (inventoryType != other.inventoryType)
+        return inventoryType < other.inventoryType;
+    if (quality != other.quality)
+        return quality < other.quality;
+    if (levelMin != other.levelMin)
+        return levelMin < other.levelMin;
+    if (levelMax != other.levelMax)
+        return levelMax < other.levelMax;
+    if (locIdx != other.locIdx)
+        return locIdx < other.locIdx;
+    if (int res = memcmp(sort, other.sort, MAX_AUCTION_SORT))
+        return res < 0;
+    return name < other.name;
+}
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
+bool AuctionListFilter::IsSortedByBid() const
+{
+    for (uint32 i = 0; i < MAX_AUCTION_SORT && sort[i] != MAX_AUCTION_SORT; ++i)
+    {
+        switch (sort[i] & ~AUCTION_SORT_REVERSED)
+        {
+            case 2:                                         // buyoutthenbid
+            case 4:                                         // status
+            case 6:                                         // minbidbuyout
+            case 8:                                         // bid
+                return true;
+            default:
+                break;
+        }
+    }
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+    return false;
+}
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+void AuctionHouseObject::AddAuction(AuctionEntry *ah)
+{
+    ASSERT(ah);
+    AuctionsMap[ah->Id] = ah;
+    IndexAuction(ah, true);
 
-            if (usable != 0x00 && !_player->CanUseItem(item))
-                continue;
+    // new auction has to appear in cached results it matches
+    for (AuctionListCache::iterator itr = m_listCache.begin(); itr != m_listCache.end();)
+    {
+        if (MatchesFilter(ah, itr->first))
+            m_listCache.erase(itr++);
+        else
+            ++itr;
+    }
+}
 
-            std::string name = proto->Name1;
-            if (name.empty())
-                continue;
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator auction = AuctionsMap.find(id);
+    if (auction == AuctionsMap.end())
+        return false;
 
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+    // removed auction has to disappear from cached results it matches, lists are rebuilt on next browse
+    for (AuctionListCache::iterator itr = m_listCache.begin(); itr != m_listCache.end();)
+    {
+        if (MatchesFilter(auction->second, itr->first))
+            m_listCache.erase(itr++);
+        else
+            ++itr;
+    }
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+    IndexAuction(auction->second, false);
+    AuctionsMap.erase(auction);
 
-            if (count < 50 && totalcount >= listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
-            }
-        }
+    return true;
+}
 
-        ++totalcount;
+void AuctionHouseObject::UpdateAuctionBid(AuctionEntry const* auction)
+{
+    for (AuctionListCache::iterator itr = m_listCache.begin(); itr != m_listCache.end();)
+    {
+        if (itr->first.IsSortedByBid() && MatchesFilter(auction, itr->first))
+            m_listCache.erase(itr++);
+        else
+            ++itr;
     }
 }
 
-void WorldSession::BuildListAuctionItems(AuctionHouseObject::AuctionEntryMap const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
-    uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull)
+void AuctionHouseObject::IndexAuction(AuctionEntry const* auction, bool add)
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return;
 
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+    AuctionIdSet* sets[4] =
     {
-        AuctionEntry *Aentry = itr->second;
-        Item *item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
+        &m_classIndex[proto->Class],
+        &m_subClassIndex[(proto->Class << 16) | proto->SubClass],
+        &m_levelIndex[proto->RequiredLevel],
+        proto->Quality < MAX_ITEM_QUALITY ? &m_qualityIndex[proto->Quality] : NULL
+    };
+
+    for (uint8 i = 0; i < 4; ++i)
+    {
+        if (!sets[i])
             continue;
 
-        if (isFull)
-        {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
-        }
+        if (add)
+            sets[i]->insert(auction->Id);
         else
+            sets[i]->erase(auction->Id);
+    }
+}
+
+void AuctionHouseObject::SelectCandidates(AuctionListFilter const& filter, std::vector<AuctionEntry*>& candidates) const
+{
+    std::vector<AuctionIdSet const*> sets;
+
+    // most selective index available for the filter, other conditions are checked per auction
+    if (filter.itemClass != AUCTION_FILTER_ANY)
+    {
+        AuctionIndex const& index = filter.itemSubClass != AUCTION_FILTER_ANY ? m_subClassIndex : m_classIndex;
+        AuctionIndex::const_iterator itr = index.find(filter.itemSubClass != AUCTION_FILTER_ANY ? (filter.itemClass << 16) | filter.itemSubClass : filter.itemClass);
+        if (itr != index.end())
+            sets.push_back(&itr->second);
+    }
+    else if (filter.levelMin)
+    {
+        AuctionIndex::const_iterator end = filter.levelMax ? m_levelIndex.upper_bound(filter.levelMax) : m_levelIndex.end();
+        for (AuctionIndex::const_iterator itr = m_levelIndex.lower_bound(filter.levelMin); itr != end; ++itr)
+            sets.push_back(&itr->second);
+    }
+    else if (filter.quality != AUCTION_FILTER_ANY && filter.quality > 0)
+    {
+        for (uint32 quality = filter.quality; quality < MAX_ITEM_QUALITY; ++quality)
+            sets.push_back(&m_qualityIndex[quality]);
+    }
+    else
+    {
+        candidates.reserve(AuctionsMap.size());
+        for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+            candidates.push_back(itr->second);
+        return;
+    }
+
+    for (std::vector<AuctionIdSet const*>::const_iterator set = sets.begin(); set != sets.end(); ++set)
+    {
+        for (AuctionIdSet::const_iterator itr = (*set)->begin(); itr != (*set)->end(); ++itr)
         {
-            ItemPrototype const *proto = item->GetProto();
+            if (AuctionEntry* auction = GetAuction(*itr))
+                candidates.push_back(auction);
+        }
+    }
+}
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+bool AuctionHouseObject::MatchesFilter(AuctionEntry const* auction, AuctionListFilter const& filter)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return false;
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+    if (filter.itemClass != AUCTION_FILTER_ANY && proto->Class != filter.itemClass)
+        return false;
+
+    if (filter.itemSubClass != AUCTION_FILTER_ANY && proto->SubClass != filter.itemSubClass)
+        return false;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
+    if (filter.inventoryType != AUCTION_FILTER_ANY && proto->InventoryType != filter.inventoryType)
+        return false;
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+    if (filter.quality != AUCTION_FILTER_ANY && proto->Quality < filter.quality)
+        return false;
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+    if (filter.levelMin != 0x00 && (proto->RequiredLevel < filter.levelMin || (filter.levelMax != 0x00 && proto->RequiredLevel > filter.levelMax)))
+        return false;
 
-            if (usable != 0x00 && !_player->CanUseItem(proto))
-                continue;
+    if (!proto->Name1 || !*proto->Name1)
+        return false;
 
-            std::string name = proto->Name1;
-            if (name.empty())
-                continue;
+    if (!filter.name.empty() && sAuctionMgr.GetItemSearchName(proto, filter.locIdx).find(filter.name) == std::wstring::npos)
+        return false;
 
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+    return true;
+}
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+static bool AuctionIdLess(AuctionEntry const* auc1, AuctionEntry const* auc2)
+{
+    return auc1->Id < auc2->Id;
+}
 
-            if (count < 50 && totalcount >= listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
-            }
+std::vector<uint32> const& AuctionHouseObject::GetAuctionList(AuctionListFilter const& filter)
+{
+    ++m_listCacheTick;
+
+    AuctionListCache::iterator cached = m_listCache.find(filter);
+    if (cached != m_listCache.end())
+    {
+        cached->second.lastUse = m_listCacheTick;
+        return cached->second.auctions;
+    }
+
+    if (m_listCache.size() >= AUCTION_LIST_CACHE_SIZE)
+    {
+        AuctionListCache::iterator oldest = m_listCache.begin();
+        for (AuctionListCache::iterator itr = m_listCache.begin(); itr != m_listCache.end(); ++itr)
+        {
+            if (itr->second.lastUse < oldest->second.lastUse)
+                oldest = itr;
         }
 
-        ++totalcount;
+        m_listCache.erase(oldest);
+    }
+
+    std::vector<AuctionEntry*> candidates;
+    SelectCandidates(filter, candidates);
+
+    std::vector<AuctionEntry*> matching;
+    for (std::vector<AuctionEntry*>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+    {
+        // auction without item can't be listed, keep it out of total count too
+        if (MatchesFilter(*itr, filter) && sAuctionMgr.GetAItem((*itr)->itemGuidLow))
+            matching.push_back(*itr);
     }
+
+    // unsorted results keep auction id order, candidates from several index sets aren't in it
+    if (filter.IsSorted())
+        std::stable_sort(matching.begin(), matching.end(), AuctionSorter(filter.sort, filter.locIdx));
+    else
+        std::sort(matching.begin(), matching.end(), AuctionIdLess);
+
+    CachedAuctionList& list = m_listCache[filter];
+    list.lastUse = m_listCacheTick;
+    list.auctions.reserve(matching.size());
+    for (std::vector<AuctionEntry*>::const_iterator itr = matching.begin(); itr != matching.end(); ++itr)
+        list.auctions.push_back((*itr)->Id);
+
+    return list.auctions;
 }
 
 AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* it, uint32 etime, uint32 bid, uint32 buyout, uint32 deposit, Player * pl /*= NULL*/)
@@ -1060,6 +1260,8 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=NULL*/)
 
     if ((newbid < buyout) || (buyout == 0))                 // bid
     {
+        sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->UpdateAuctionBid(this);
+
         if (auction_owner)
             auction_owner->GetSession()->SendAuctionOwnerNotification(this, false);
 
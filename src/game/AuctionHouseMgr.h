@@ -31,11 +31,16 @@ class Item;
 class Player;
 class Unit;
 class WorldPacket;
+struct ItemPrototype;
 
 #define MIN_AUCTION_TIME (12*HOUR)
 #define MAX_AUCTION_SORT 12
 #define AUCTION_SORT_REVERSED 0x10
 
+#define AUCTION_LIST_PAGE_SIZE 50                           // auctions sent per browse page
+#define AUCTION_LIST_CACHE_SIZE 32                          // cached browse results per auction house
+#define AUCTION_FILTER_ANY 0xffffffff
+
 enum AuctionError
 {
     AUCTION_OK                          = 0,                // depends on enum AuctionAction
@@ -83,17 +88,38 @@ struct AuctionEntry
     void SaveToDB() const;
     void AuctionBidWinning(Player* bidder = NULL);
 
-    // -1,0,+1 order result
-    int CompareAuctionEntry(uint32 column, const AuctionEntry *auc, Player* viewPlayer) const;
+    // -1,0,+1 order result, item names compared in given locale
+    int CompareAuctionEntry(uint32 column, const AuctionEntry *auc, int32 locIdx) const;
 
     bool UpdateBid(uint32 newbid, Player* newbidder = NULL);// true if normal bid, false if buyout, bidder==NULL for generated bid
 };
 
+// browse request of CMSG_AUCTION_LIST_ITEMS without viewer dependent parts, AUCTION_FILTER_ANY matches anything
+struct AuctionListFilter
+{
+    AuctionListFilter();
+
+    std::wstring name;                                      // lower case
+    uint32 levelMin;                                        // 0 for any
+    uint32 levelMax;                                        // 0 for any
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;                                         // minimal quality
+    int32 locIdx;                                           // locale of item names
+    uint8 sort[MAX_AUCTION_SORT];
+
+    bool operator<(AuctionListFilter const& other) const;
+
+    bool IsSorted() const { return sort[0] != MAX_AUCTION_SORT; }
+    bool IsSortedByBid() const;
+};
+
 //this class is used as auctionhouse instance
 class AuctionHouseObject
 {
     public:
-        AuctionHouseObject() {}
+        AuctionHouseObject() : m_listCacheTick(0) {}
         ~AuctionHouseObject()
         {
             for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
@@ -109,11 +135,7 @@ class AuctionHouseObject
 
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry *ah)
-        {
-            ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry *ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -121,10 +143,13 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : NULL;
         }
 
-        bool RemoveAuction(uint32 id)
-        {
-            return AuctionsMap.erase(id);
-        }
+        bool RemoveAuction(uint32 id);
+
+        // called after bid of auction still in house changed
+        void UpdateAuctionBid(AuctionEntry const* auction);
+
+        // ids of listable auctions matching filter in requested order, cached until auction affecting it is added, removed or rebid
+        std::vector<uint32> const& GetAuctionList(AuctionListFilter const& filter);
 
         void Update();
 
@@ -133,19 +158,42 @@ class AuctionHouseObject
 
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player * pl = NULL);
     private:
+        typedef std::set<uint32> AuctionIdSet;              // ordered by id like AuctionsMap
+        typedef std::map<uint32, AuctionIdSet> AuctionIndex;
+
+        struct CachedAuctionList
+        {
+            std::vector<uint32> auctions;
+            uint32 lastUse;
+        };
+        typedef std::map<AuctionListFilter, CachedAuctionList> AuctionListCache;
+
+        void IndexAuction(AuctionEntry const* auction, bool add);
+        void SelectCandidates(AuctionListFilter const& filter, std::vector<AuctionEntry*>& candidates) const;
+        static bool MatchesFilter(AuctionEntry const* auction, AuctionListFilter const& filter);
+
         AuctionEntryMap AuctionsMap;
+
+        // secondary indexes for browsing
+        AuctionIndex m_classIndex;                          // item class
+        AuctionIndex m_subClassIndex;                       // item class << 16 | subclass
+        AuctionIndex m_levelIndex;                          // required level
+        AuctionIdSet m_qualityIndex[MAX_ITEM_QUALITY];
+
+        AuctionListCache m_listCache;
+        uint32 m_listCacheTick;
 };
 
 class AuctionSorter
 {
     public:
-        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer) {}
-        AuctionSorter(uint8 *sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
+        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_locIdx(sorter.m_locIdx) {}
+        AuctionSorter(uint8 const* sort, int32 locIdx) : m_sort(sort), m_locIdx(locIdx) {}
         bool operator()(const AuctionEntry *auc1, const AuctionEntry *auc2) const;
 
     private:
-        uint8* m_sort;
-        Player* m_viewPlayer;
+        uint8 const* m_sort;
+        int32 m_locIdx;
 };
 
 enum AuctionHouseType
@@ -190,6 +238,9 @@ class AuctionHouseMgr
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
 
+        // lower case item name in locale, converted once per item
+        std::wstring const& GetItemSearchName(ItemPrototype const* proto, int32 locIdx);
+
     public:
         //load first auction items, because of check if item exists, when loading
         void LoadAuctionItems();
@@ -204,6 +255,9 @@ class AuctionHouseMgr
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
 
         ItemMap             mAitems;
+
+        typedef UNORDERED_MAP<uint64, std::wstring> ItemSearchNameMap;
+        ItemSearchNameMap   mItemSearchNames;               // locale index + 1 << 32 | item id
 };
 
 #define sAuctionMgr (*ACE_Singleton<AuctionHouseMgr, ACE_Null_Mutex>::instance())
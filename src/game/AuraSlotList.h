@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_AURASLOTLIST_H
+#define HELLGROUND_AURASLOTLIST_H
+
+#include "Common.h"
+
+#include <iterator>
+
+class Aura;
+
+/*
+ * AuraSlotList - contiguous replacement for std::list<Aura*> used for unit aura lists.
+ *
+ * Aura lists are iterated while auras get applied and removed (procs, dispels, stacking),
+ * so iterators are index based and removal only clears the slot. Cleared slots are skipped
+ * by iteration and packed by Compact(), which must be called only when no iteration
+ * over the list can be in progress (Unit::Update).
+ */
+class AuraSlotList
+{
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* reference;
+
+                const_iterator() : m_list(NULL), m_index(0) {}
+                const_iterator(AuraSlotList const* list, uint32 index) : m_list(list), m_index(index) { SkipEmpty(); }
+
+                Aura* operator*() const { return m_list->m_data[m_index]; }
+
+                const_iterator& operator++() { ++m_index; SkipEmpty(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+
+                // every position past current list size is end(), list may shrink with clear() during iteration
+                bool operator==(const_iterator const& right) const
+                {
+                    bool atEnd = IsAtEnd();
+                    return atEnd == right.IsAtEnd() && (atEnd || m_index == right.m_index);
+                }
+                bool operator!=(const_iterator const& right) const { return !(*this == right); }
+
+            private:
+                friend class AuraSlotList;
+
+                bool IsAtEnd() const { return !m_list || m_index >= m_list->m_size; }
+                void SkipEmpty()
+                {
+                    while (m_index < m_list->m_size && !m_list->m_data[m_index])
+                        ++m_index;
+                }
+
+                AuraSlotList const* m_list;
+                uint32 m_index;
+        };
+
+        typedef const_iterator iterator;
+        typedef Aura* value_type;
+
+        AuraSlotList() : m_data(NULL), m_size(0), m_capacity(0), m_count(0) {}
+        AuraSlotList(AuraSlotList const& right) : m_data(NULL), m_size(0), m_capacity(0), m_count(0) { Assign(right); }
+        ~AuraSlotList() { delete [] m_data; }
+
+        AuraSlotList& operator=(AuraSlotList const& right)
+        {
+            if (this != &right)
+            {
+                clear();
+                Assign(right);
+            }
+            return *this;
+        }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_size); }
+
+        bool empty() const { return !m_count; }
+        uint32 size() const { return m_count; }
+
+        Aura* front() const { return *begin(); }
+        Aura* back() const
+        {
+            for (uint32 i = m_size; i > 0; --i)
+                if (m_data[i - 1])
+                    return m_data[i - 1];
+            return NULL;
+        }
+
+        void push_back(Aura* aura)
+        {
+            if (!aura)
+                return;
+
+            // slots cleared while list may be iterated are reused only by Compact()
+            if (m_size == m_capacity)
+                Grow();
+
+            m_data[m_size++] = aura;
+            ++m_count;
+        }
+
+        void pop_front() { erase(begin()); }
+
+        const_iterator erase(const_iterator itr)
+        {
+            if (itr.IsAtEnd())
+                return end();
+
+            if (m_data[itr.m_index])
+            {
+                m_data[itr.m_index] = NULL;
+                --m_count;
+            }
+            return const_iterator(this, itr.m_index + 1);
+        }
+
+        void remove(Aura* aura)
+        {
+            for (uint32 i = 0; i < m_size; ++i)
+            {
+                if (m_data[i] == aura)
+                {
+                    m_data[i] = NULL;
+                    --m_count;
+                }
+            }
+        }
+
+        // keeps allocated storage, auras are usually reapplied soon
+        void clear() { m_size = 0; m_count = 0; }
+
+        // packs cleared slots, invalidates iterators
+        void Compact()
+        {
+            if (m_count == m_size)
+                return;
+
+            uint32 dest = 0;
+            for (uint32 i = 0; i < m_size; ++i)
+                if (m_data[i])
+                    m_data[dest++] = m_data[i];
+
+            m_size = dest;
+        }
+
+    private:
+        void Grow()
+        {
+            uint32 capacity = m_capacity ? m_capacity * 2 : 4;
+            Aura** data = new Aura*[capacity];
+            for (uint32 i = 0; i < m_size; ++i)
+                data[i] = m_data[i];
+
+            delete [] m_data;
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        void Assign(AuraSlotList const& right)
+        {
+            for (const_iterator itr = right.begin(); itr != right.end(); ++itr)
+                push_back(*itr);
+        }
+
+        Aura** m_data;
+        uint32 m_size;
+        uint32 m_capacity;
+        uint32 m_count;
+};
+
+#endif
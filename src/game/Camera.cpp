@@ -160,6 +160,13 @@ void Camera::UpdateVisibilityForOwner()
     notifier.SendToSelf();
 }
 
+void Camera::UpdateVisibilityForOwnerNearBand()
+{
+    Hellground::VisibleNotifier notifier(*this, true);
+    Cell::VisitAllObjects(_source, notifier, _source->GetMap()->GetVisibilityNearBandDistance(), false);
+    notifier.SendToSelf();
+}
+
 //////////////////
 
 ViewPoint::~ViewPoint()
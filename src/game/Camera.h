@@ -58,6 +58,8 @@ class HELLGROUND_IMPORT_EXPORT Camera
 
         // updates visibility of worldobjects around viewpoint for camera's owner
         void UpdateVisibilityForOwner();
+        // same as above but only for near band of visibility distance, farther objects are left untouched
+        void UpdateVisibilityForOwnerNearBand();
 
         const uint64& getOwnerGuid();
     private:
@@ -131,6 +133,11 @@ public:
     {
         CameraCall(&Camera::UpdateVisibilityForOwner);
     }
+
+    void Call_UpdateVisibilityForOwnerNearBand()
+    {
+        CameraCall(&Camera::UpdateVisibilityForOwnerNearBand);
+    }
 };
 
 #endif
@@ -22,6 +22,9 @@
 #include "ObjectMgr.h"
 #include "World.h"
 #include "SocialMgr.h"
+#include "ChatFanout.h"
+#include "Chat.h"
+#include "Language.h"
 
 Channel::Channel(const std::string& name, uint32 channel_id)
 : m_announce(true), m_moderate(false), m_name(name), m_flags(0), m_channelId(channel_id), m_ownerGUID(0)
@@ -129,7 +132,11 @@ void Channel::Join(uint64 p, const char *pass)
     PlayerInfo pinfo;
     pinfo.player = p;
     pinfo.flags = 0;
+    pinfo.rateLimitTime = 0;
+    pinfo.rateLimitCount = 0;
     players[p] = pinfo;
+    if (plr)
+        m_onlinePlayers.push_back(plr);
 
     MakeYouJoined(&data);
     SendToOne(&data, p);
@@ -172,6 +179,7 @@ void Channel::Leave(uint64 p, bool send)
         bool changeowner = players[p].IsOwner();
 
         players.erase(p);
+        RemoveOnlinePlayer(p);
         if (m_announce && (!plr || !plr->GetSession()->HasPermissions(PERM_GMT) || !sWorld.getConfig(CONFIG_SILENTLY_GM_JOIN_TO_CHANNEL)))
         {
             WorldPacket data;
@@ -236,6 +244,7 @@ void Channel::KickOrBan(uint64 good, const char *badname, bool ban)
 
             SendToAll(&data);
             players.erase(bad->GetGUID());
+            RemoveOnlinePlayer(bad->GetGUID());
             bad->LeftChannel(this);
 
             if (changeowner)
@@ -586,6 +595,12 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
         MakeNotModerator(&data);
         SendToOne(&data, p);
     }
+    else if (!(sec & PERM_GMT) && !CheckRateLimit(players[p]))
+    {
+        ++sChatFanout.GetStats().rateLimited;
+        if (plr)
+            ChatHandler(plr).PSendSysMessage(LANG_CHANNEL_RATE_LIMITED, m_name.c_str());
+    }
     else
     {
         uint32 messageLength = strlen(what) + 1;
@@ -607,15 +622,17 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
             if (sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_CHANNEL) && IsLFG() && plr)
             {
                 uint32 fromteam = plr->GetTeam();
-                for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+                ChatFanoutMessage message(&data);
+                for (OnlinePlayerList::iterator i = m_onlinePlayers.begin(); i != m_onlinePlayers.end(); ++i)
                 {
-                    Player *to = sObjectMgr.GetPlayer(i->first);
-                    if (!to || to->GetTeam() != fromteam)
+                    Player *to = *i;
+                    if (to->GetTeam() != fromteam)
                         continue;
 
                     if (!p || !to->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                        to->SendPacketToSelf(&data);
+                        message.AddRecipient(to->GetSession());
                 }
+                message.Send();
             }
             else 
             SendToAll(&data, !players[p].IsModerator() ? p : false);
@@ -705,26 +722,51 @@ void Channel::SetOwner(uint64 guid, bool exclaim)
 
 void Channel::SendToAll(WorldPacket *data, uint64 p)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    ChatFanoutMessage message(data);
+    for (OnlinePlayerList::iterator i = m_onlinePlayers.begin(); i != m_onlinePlayers.end(); ++i)
     {
-        Player *plr = sObjectMgr.GetPlayer(i->first);
-        if (plr)
-        {
-            if (!p || !plr->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                plr->SendPacketToSelf(data);
-        }
+        if (!p || !(*i)->GetSocial()->HasIgnore(GUID_LOPART(p)))
+            message.AddRecipient((*i)->GetSession());
     }
+    message.Send();
 }
 
 void Channel::SendToAllButOne(WorldPacket *data, uint64 who)
 {
-    for (PlayerList::iterator i = players.begin(); i != players.end(); ++i)
+    ChatFanoutMessage message(data);
+    for (OnlinePlayerList::iterator i = m_onlinePlayers.begin(); i != m_onlinePlayers.end(); ++i)
     {
-        if (i->first != who)
+        if ((*i)->GetGUID() != who)
+            message.AddRecipient((*i)->GetSession());
+    }
+    message.Send();
+}
+
+bool Channel::CheckRateLimit(PlayerInfo& info)
+{
+    uint32 limit = sWorld.getConfig(CONFIG_CHAT_CHANNEL_RATE_LIMIT);
+    if (!limit)
+        return true;
+
+    uint32 now = WorldTimer::getMSTime();
+    if (WorldTimer::getMSTimeDiff(info.rateLimitTime, now) >= IN_MILISECONDS)
+    {
+        info.rateLimitTime = now;
+        info.rateLimitCount = 0;
+    }
+
+    return ++info.rateLimitCount <= limit;
+}
+
+void Channel::RemoveOnlinePlayer(uint64 guid)
+{
+    for (OnlinePlayerList::iterator i = m_onlinePlayers.begin(); i != m_onlinePlayers.end(); ++i)
+    {
+        if ((*i)->GetGUID() == guid)
         {
-            Player *plr = sObjectMgr.GetPlayer(i->first);
-            if (plr)
-                plr->SendPacketToSelf(data);
+            *i = m_onlinePlayers.back();
+            m_onlinePlayers.pop_back();
+            return;
         }
     }
 }
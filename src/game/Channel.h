@@ -124,6 +124,8 @@ class Channel
     {
         uint64 player;
         uint8 flags;
+        uint32 rateLimitTime;                               // start of member's current Chat.Channel.RateLimit second
+        uint32 rateLimitCount;
 
         bool HasFlag(uint8 flag) { return flags & flag; }
         void SetFlag(uint8 flag) { if (!HasFlag(flag)) flags |= flag; }
@@ -149,6 +151,8 @@ class Channel
 
     typedef     std::map<uint64, PlayerInfo> PlayerList;
     PlayerList  players;
+    typedef     std::vector<Player*> OnlinePlayerList;
+    OnlinePlayerList m_onlinePlayers;                       // members in game, used to send to all without lookups
     typedef     std::set<uint64> BannedList;
     BannedList  banned;
     bool        m_announce;
@@ -161,6 +165,8 @@ class Channel
 
     private:
         void ChangeOwner();
+        // false when member already sent Chat.Channel.RateLimit messages to channel this second
+        bool CheckRateLimit(PlayerInfo& info);
         // initial packet data (notify type and channel name)
         void MakeNotifyPacket(WorldPacket *data, uint8 notify_type);
         // type specific packet data
@@ -204,6 +210,7 @@ class Channel
         void SendToAll(WorldPacket *data, uint64 p = 0);
         void SendToAllButOne(WorldPacket *data, uint64 who);
         void SendToOne(WorldPacket *data, uint64 who);
+        void RemoveOnlinePlayer(uint64 guid);
 
         bool IsOn(uint64 who) const { return players.find(who) != players.end(); }
         bool IsBanned(uint64 guid) const { return banned.find(guid) != banned.end(); }
@@ -608,6 +608,7 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder * holder)
 
             // Increment online members of the guild
             guild->IncOnlineMemberCount();
+            guild->AddOnlineMember(pCurrChar);
         }
         else
         {
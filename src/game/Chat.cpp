@@ -132,21 +132,48 @@ ChatCommand * ChatHandler::getCommandTable()
         { NULL,             0,              0,            false,  NULL,                                           "", NULL }
     };
 
+    static ChatCommand serverCaptureCommandTable[] =
+    {
+        { "start",          PERM_CONSOLE,   PERM_CONSOLE, true,   &ChatHandler::HandleServerCaptureStartCommand,  "", NULL },
+        { "stop",           PERM_CONSOLE,   PERM_CONSOLE, true,   &ChatHandler::HandleServerCaptureStopCommand,   "", NULL },
+        { "",               PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerCaptureCommand,       "", NULL },
+        { NULL,             0,              0,            false,  NULL,                                           "", NULL }
+    };
+
+    static ChatCommand serverReplayCommandTable[] =
+    {
+        { "start",          PERM_CONSOLE,   PERM_CONSOLE, true,   &ChatHandler::HandleServerReplayStartCommand,   "", NULL },
+        { "stop",           PERM_CONSOLE,   PERM_CONSOLE, true,   &ChatHandler::HandleServerReplayStopCommand,    "", NULL },
+        { "",               PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerReplayCommand,        "", NULL },
+        { NULL,             0,              0,            false,  NULL,                                           "", NULL }
+    };
+
     static ChatCommand serverCommandTable[] =
     {
+        { "capture",        PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverCaptureCommandTable },
         { "corpses",        PERM_HIGH_GMT,  PERM_CONSOLE, true,   &ChatHandler::HandleServerCorpsesCommand,       "", NULL },
         { "exit",           PERM_CONSOLE,   PERM_CONSOLE, true,   &ChatHandler::HandleServerExitCommand,          "", NULL },
         { "idlerestart",    PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverIdleRestartCommandTable },
+        { "chatfanout",     PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerChatFanoutCommand,    "", NULL },
         { "idleshutdown",   PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverShutdownCommandTable },
         { "info",           PERM_PLAYER,    PERM_CONSOLE, true,   &ChatHandler::HandleServerInfoCommand,          "", NULL },
         { "events",         PERM_PLAYER,    PERM_CONSOLE, true,   &ChatHandler::HandleServerEventsCommand,        "", NULL },
+        { "loscache",       PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerLoSCacheCommand,      "", NULL },
+        { "mapload",        PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerMapLoadCommand,       "", NULL },
+        { "memory",         PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerMemoryCommand,        "", NULL },
         { "motd",           PERM_PLAYER,    PERM_CONSOLE, true,   &ChatHandler::HandleServerMotdCommand,          "", NULL },
         { "mute",           PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerMuteCommand,          "", NULL },
+        { "packetstats",    PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerPacketStatsCommand,   "", NULL },
         { "pvp",            PERM_PLAYER,    PERM_CONSOLE, false,  &ChatHandler::HandleServerPVPCommand,           "", NULL },
+        { "replay",         PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverReplayCommandTable },
         { "restart",        PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverRestartCommandTable },
         { "rollshutdown",   PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerRollShutDownCommand,  "", NULL},
         { "set",            PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverSetCommandTable },
         { "shutdown",       PERM_ADM,       PERM_CONSOLE, true,   NULL,                                           "", serverShutdownCommandTable },
+        { "splinebench",    PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerSplineBenchCommand,   "", NULL },
+        { "tickreport",     PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerTickReportCommand,    "", NULL },
+        { "trace",          PERM_ADM,       PERM_CONSOLE, true,   &ChatHandler::HandleServerTraceCommand,         "", NULL },
+        { "vmapbench",      PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleServerVMapBenchCommand,     "", NULL },
         { NULL,             0,              0,            false,  NULL,                                           "", NULL }
     };
 
@@ -268,6 +295,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "addformation",   PERM_DEVELOPER, PERM_CONSOLE, false,  &ChatHandler::HandleDebugAddFormationToFileCommand, "", NULL },
         { "anim",           PERM_GMT_DEV,   PERM_CONSOLE, false,  &ChatHandler::HandleDebugAnimCommand,               "", NULL },
         { "arena",          PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugArenaCommand,              "", NULL },
+        { "aurabench",      PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugAuraBenchCommand,          "", NULL },
         { "bg",             PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugBattleGroundCommand,       "", NULL },
         { "getitemstate",   PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugGetItemState,              "", NULL },
         { "getinstdata",    PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugGetInstanceDataCommand,    "", NULL },
@@ -279,6 +307,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "play",           PERM_DEVELOPER, PERM_CONSOLE, false,  NULL,                                               "", debugPlayCommandTable },
         { "poolstats",      PERM_GMT_DEV,   PERM_CONSOLE, false,  &ChatHandler::HandleGetPoolObjectStatsCommand,      "", NULL },
         { "rel",            PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleRelocateCreatureCommand,        "", NULL },
+        { "searchbench",    PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugSearchBenchCommand,        "", NULL },
         { "send",           PERM_ADM,       PERM_CONSOLE, false,  NULL,                                               "", debugSendCommandTable },
         { "setinstdata",    PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugSetInstanceDataCommand,    "", NULL },
         { "setinstdata64",  PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugSetInstanceData64Command,  "", NULL },
@@ -286,6 +315,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "setvalue",       PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugSetValue,                  "", NULL },
         { "showcombatstats",PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugShowCombatStats,           "", NULL },
         { "threatlist",     PERM_GMT_DEV,   PERM_CONSOLE, false,  &ChatHandler::HandleDebugThreatList,                "", NULL },
+        { "procbench",      PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugProcBenchCommand,          "", NULL },
         { "printstate",     PERM_PLAYER,    PERM_CONSOLE, false,  &ChatHandler::HandleDebugUnitState,                 "", NULL },
         { "update",         PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugUpdate,                    "", NULL },
         { "uws",            PERM_ADM,       PERM_CONSOLE, false,  &ChatHandler::HandleDebugUpdateWorldStateCommand,   "", NULL },
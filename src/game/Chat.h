@@ -150,6 +150,9 @@ class ChatHandler
         bool HandleDebugSetInstanceDataCommand(const char* args);
         bool HandleDebugSetInstanceData64Command(const char* args);
         bool HandleDebugSetItemFlagCommand(const char * args);
+        bool HandleDebugSearchBenchCommand(const char* args);
+        bool HandleDebugAuraBenchCommand(const char* args);
+        bool HandleDebugProcBenchCommand(const char* args);
         bool HandleDebugSetValue(const char* args);
         bool HandleDebugShowCombatStats(const char* args);
         bool HandleDebugThreatList(const char * args);
@@ -422,6 +425,21 @@ class ChatHandler
         bool HandleServerEventsCommand(const char* args);
         bool HandleServerMotdCommand(const char* args);
         bool HandleServerMuteCommand(const char* args);
+        bool HandleServerPacketStatsCommand(const char* args);
+        bool HandleServerLoSCacheCommand(const char* args);
+        bool HandleServerMapLoadCommand(const char* args);
+        bool HandleServerMemoryCommand(const char* args);
+        bool HandleServerVMapBenchCommand(const char* args);
+        bool HandleServerSplineBenchCommand(const char* args);
+        bool HandleServerChatFanoutCommand(const char* args);
+        bool HandleServerCaptureCommand(const char* args);
+        bool HandleServerCaptureStartCommand(const char* args);
+        bool HandleServerCaptureStopCommand(const char* args);
+        bool HandleServerReplayCommand(const char* args);
+        bool HandleServerReplayStartCommand(const char* args);
+        bool HandleServerReplayStopCommand(const char* args);
+        bool HandleServerTraceCommand(const char* args);
+        bool HandleServerTickReportCommand(const char* args);
         bool HandleServerRestartCommand(const char* args);
         bool HandleServerSetMotdCommand(const char* args);
         bool HandleServerSetDiffTimeCommand(const char* args);
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "ChatFanout.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include "WorldSocket.h"
+#include "World.h"
+#include "Log.h"
+#include "Timer.h"
+
+class ChatFanoutRequest : public ACE_Method_Request
+{
+    public:
+        ChatFanoutRequest(WorldPacket const& packet, uint32 queueTime) : m_packet(packet), m_queueTime(queueTime) {}
+
+        ~ChatFanoutRequest()
+        {
+            // not delivered, executor failed or was stopped
+            for (std::vector<WorldSocket*>::iterator itr = m_sockets.begin(); itr != m_sockets.end(); ++itr)
+            {
+                (*itr)->FanoutSent();
+                (*itr)->RemoveReference();
+            }
+        }
+
+        void AddSocket(WorldSocket* socket)
+        {
+            socket->FanoutQueued();
+            m_sockets.push_back(socket);
+        }
+
+        void Reserve(size_t count) { m_sockets.reserve(count); }
+        uint32 Size() const { return m_sockets.size(); }
+
+        virtual int call()
+        {
+            for (std::vector<WorldSocket*>::iterator itr = m_sockets.begin(); itr != m_sockets.end(); ++itr)
+            {
+                if ((*itr)->SendPacket(m_packet) == -1)
+                    (*itr)->CloseSocket();
+
+                (*itr)->FanoutSent();
+                (*itr)->RemoveReference();
+            }
+
+            sChatFanout.Delivered(m_sockets.size(), m_queueTime);
+            m_sockets.clear();
+            return 0;
+        }
+
+    private:
+        WorldPacket m_packet;
+        uint32 m_queueTime;
+        std::vector<WorldSocket*> m_sockets;
+};
+
+ChatFanout::ChatFanout()
+{
+    m_stats.queuedMessages = 0;
+    m_stats.queuedRecipients = 0;
+    m_stats.peakRecipients = 0;
+    m_stats.delayMax = 0;
+    m_stats.messages = 0;
+    m_stats.recipients = 0;
+    m_stats.inlineMessages = 0;
+    m_stats.orderedPackets = 0;
+    m_stats.rateLimited = 0;
+}
+
+ChatFanout::~ChatFanout()
+{
+    Deactivate();
+}
+
+void ChatFanout::Activate()
+{
+    if (m_executor.activate(1) == -1)
+        sLog.outLog(LOG_DEFAULT, "ERROR: ChatFanout: can't start delivery thread, chat is sent by callers");
+}
+
+void ChatFanout::Deactivate()
+{
+    if (m_executor.activated())
+        m_executor.deactivate();
+}
+
+bool ChatFanout::Queue(WorldPacket const& packet, ChatRecipientList const& recipients)
+{
+    if (!m_executor.activated())
+        return false;
+
+    ChatFanoutRequest* request = new ChatFanoutRequest(packet, WorldTimer::getMSTime());
+    request->Reserve(recipients.size());
+    for (ChatRecipientList::const_iterator itr = recipients.begin(); itr != recipients.end(); ++itr)
+    {
+        if (WorldSocket* socket = (*itr)->AcquireSocket())
+            request->AddSocket(socket);
+        // replay sessions have no socket, their output is only recorded by session
+        else if ((*itr)->IsReplay())
+            (*itr)->SendPacket(&packet);
+    }
+
+    // counted before execute, delivery thread may finish it before execute returns
+    uint32 count = request->Size();
+    ++m_stats.queuedMessages;
+    uint32 depth = m_stats.queuedRecipients += count;
+
+    uint32 peak = m_stats.peakRecipients;
+    while (depth > peak)
+        peak = m_stats.peakRecipients.compare_and_swap(depth, peak);
+
+    // executor deletes request on failure, dropping socket references
+    if (m_executor.execute(request) == -1)
+    {
+        --m_stats.queuedMessages;
+        m_stats.queuedRecipients -= count;
+        return false;
+    }
+
+    return true;
+}
+
+bool ChatFanout::QueueOrdered(WorldPacket const& packet, WorldSocket* socket)
+{
+    if (!m_executor.activated())
+    {
+        socket->RemoveReference();
+        return false;
+    }
+
+    ChatFanoutRequest* request = new ChatFanoutRequest(packet, WorldTimer::getMSTime());
+    request->AddSocket(socket);
+
+    ++m_stats.queuedMessages;
+    ++m_stats.queuedRecipients;
+
+    // executor deletes request on failure, dropping socket reference
+    if (m_executor.execute(request) == -1)
+    {
+        --m_stats.queuedMessages;
+        --m_stats.queuedRecipients;
+        return false;
+    }
+
+    ++m_stats.orderedPackets;
+    return true;
+}
+
+void ChatFanout::Delivered(uint32 recipients, uint32 queueTime)
+{
+    --m_stats.queuedMessages;
+    m_stats.queuedRecipients -= recipients;
+    ++m_stats.messages;
+    m_stats.recipients += recipients;
+
+    uint32 delay = WorldTimer::getMSTimeDiffToNow(queueTime);
+    uint32 delayMax = m_stats.delayMax;
+    while (delay > delayMax)
+        delayMax = m_stats.delayMax.compare_and_swap(delay, delayMax);
+}
+
+void ChatFanoutMessage::Send()
+{
+    if (m_recipients.size() >= sWorld.getConfig(CONFIG_CHAT_FANOUT_MIN_RECIPIENTS) && sChatFanout.Queue(*m_packet, m_recipients))
+    {
+        m_recipients.clear();
+        return;
+    }
+
+    for (ChatRecipientList::iterator itr = m_recipients.begin(); itr != m_recipients.end(); ++itr)
+        (*itr)->SendPacket(m_packet);
+
+    if (!m_recipients.empty())
+        ++sChatFanout.GetStats().inlineMessages;
+
+    m_recipients.clear();
+}
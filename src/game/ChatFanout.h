@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_CHATFANOUT_H
+#define HELLGROUND_CHATFANOUT_H
+
+#include "Common.h"
+#include "DelayExecutor.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <tbb/atomic.h>
+
+class WorldPacket;
+class WorldSession;
+class WorldSocket;
+
+typedef std::vector<WorldSession*> ChatRecipientList;
+
+/// Counters of chat delivery thread, reported by .server chatfanout
+struct ChatFanoutStats
+{
+    tbb::atomic<uint32> queuedMessages;                    // messages waiting for delivery thread
+    tbb::atomic<uint32> queuedRecipients;                  // socket sends waiting for delivery thread
+    tbb::atomic<uint32> peakRecipients;                    // highest queuedRecipients since last report
+    tbb::atomic<uint32> delayMax;                          // longest ms from queue to delivery since last report
+    tbb::atomic<uint64> messages;
+    tbb::atomic<uint64> recipients;
+    tbb::atomic<uint64> inlineMessages;                    // sent by caller, too few recipients or thread not running
+    tbb::atomic<uint64> orderedPackets;                    // direct packets sent behind pending fanout to the same client
+    tbb::atomic<uint64> rateLimited;                       // channel messages refused by Chat.Channel.RateLimit
+};
+
+/**
+ * ChatFanout - delivers chat messages with many recipients on its own thread.
+ *
+ * Recipients are still chosen by the caller: guild and channel member lists have no locks and
+ * are only used from world thread. Copying the packet into each recipient socket (header
+ * encryption, socket lock, output buffer) is the part growing with audience, that part runs
+ * on delivery thread, so a message to whole realm doesn't stretch the tick it was said in.
+ *
+ * Messages are delivered in queue order, each recipient socket is referenced until its copy is sent.
+ * While a socket has copies queued, WorldSession::SendPacket queues its other packets behind
+ * them (QueueOrdered), so a client never gets a packet sent after the broadcast before it.
+ */
+class ChatFanout
+{
+    public:
+        ChatFanout();
+        ~ChatFanout();
+
+        void Activate();
+        void Deactivate();
+        bool IsActive() { return m_executor.activated(); }
+
+        // false when message wasn't queued and caller has to send it
+        bool Queue(WorldPacket const& packet, ChatRecipientList const& recipients);
+        // takes referenced socket with fanout pending, false when caller has to send packet itself
+        bool QueueOrdered(WorldPacket const& packet, WorldSocket* socket);
+        void Delivered(uint32 recipients, uint32 queueTime);
+
+        ChatFanoutStats& GetStats() { return m_stats; }
+
+    private:
+        DelayExecutor m_executor;
+        ChatFanoutStats m_stats;
+};
+
+#define sChatFanout (*ACE_Singleton<ChatFanout, ACE_Thread_Mutex>::instance())
+
+/// Recipients of one chat packet, collected on stack and handed to ChatFanout by Send()
+class ChatFanoutMessage
+{
+    public:
+        explicit ChatFanoutMessage(WorldPacket const* packet) : m_packet(packet) {}
+
+        void AddRecipient(WorldSession* session) { m_recipients.push_back(session); }
+        void AddRecipients(ChatRecipientList const& sessions) { m_recipients.insert(m_recipients.end(), sessions.begin(), sessions.end()); }
+        // queued when there are at least Chat.Fanout.MinRecipients recipients, sent right away otherwise
+        void Send();
+
+    private:
+        WorldPacket const* m_packet;
+        ChatRecipientList m_recipients;
+};
+
+#endif
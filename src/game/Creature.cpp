@@ -56,6 +56,7 @@
 
 // apply implementation of the singletons
 #include "Map.h"
+#include "ObjectPool.h"
 
 std::map<uint32, uint32> CreatureAIReInitialize;
 
@@ -184,6 +185,16 @@ Creature::~Creature()
         sLog.outDetail("Deconstruct Creature Entry = %u", GetEntry());
 }
 
+void* Creature::operator new(size_t size)
+{
+    return sObjectPoolMgr.GetCreaturePool().Allocate(size);
+}
+
+void Creature::operator delete(void* ptr)
+{
+    ObjectSlabPool::Deallocate(ptr);
+}
+
 void Creature::AddToWorld()
 {
     ///- Register the creature for guid lookup
@@ -586,6 +597,7 @@ void Creature::Update(uint32 update_diff, uint32 diff)
             {
                 // do not allow the AI to be changed during update
                 m_AI_locked = true;
+                TraceZone traceAI("CreatureAI::UpdateAI", GetEntry());
                 i_AI->UpdateAI(diff);
                 m_AI_locked = false;
             }
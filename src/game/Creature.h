@@ -448,6 +448,10 @@ class HELLGROUND_IMPORT_EXPORT Creature : public Unit
         explicit Creature();
         virtual ~Creature();
 
+        // allocated from sObjectPoolMgr creature pool, also for derived classes
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
         void AddToWorld();
         void RemoveFromWorld();
         void DisappearAndDie();
@@ -40,7 +40,7 @@ bool CreatureEventAIHolder::UpdateRepeatTimer(Creature* creature, uint32 repeatM
         Time = urand(repeatMin, repeatMax);
     else
     {
-        sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Creature %u using Event %u (Type = %u) has RandomMax < RandomMin. Event repeating disabled.", creature->GetEntry(), Event.event_id, Event.event_type);
+        sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Creature %u using Event %u (Type = %u) has RandomMax < RandomMin. Event repeating disabled.", creature->GetEntry(), Event->event_id, Event->event_type);
         Enabled = false;
         return false;
     }
@@ -57,108 +57,95 @@ int CreatureEventAI::Permissible(const Creature *creature)
 
 CreatureEventAI::CreatureEventAI(Creature *c) : CreatureAI(c)
 {
-    // Need make copy for filter unneeded steps and safe in case table reload
-    CreatureEventAI_Event_Map::const_iterator CreatureEvents = sCreatureEAIMgr.GetCreatureEventAIMap().find(int64(me->GetEntry()));
-    if (CreatureEvents != sCreatureEAIMgr.GetCreatureEventAIMap().end())
-    {
-        std::vector<CreatureEventAI_Event>::const_iterator i;
-        for (i = (*CreatureEvents).second.begin(); i != (*CreatureEvents).second.end(); ++i)
-        {
-            //Debug check
-            #ifndef HELLGROUND_DEBUG
-            if ((*i).event_flags & EFLAG_DEBUG_ONLY)
-                continue;
-            #endif
-            if (((*i).event_flags & (EFLAG_HEROIC | EFLAG_NORMAL)) && m_creature->GetMap()->IsDungeon())
-            {
-                if ((m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_HEROIC) ||
-                    (!m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_NORMAL))
-                {
-                    //event flagged for instance mode
-                    CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
-                }
-                continue;
-            }
-            CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
-        }
-    }
+    // table stays valid for us also after events reload
+    EventTable = sCreatureEAIMgr.AcquireEventTable(c);
 
-    // Need make copy for filter unneeded steps and safe in case table reload
-    CreatureEvents = sCreatureEAIMgr.GetCreatureEventAIMap().find(-int64(me->GetGUIDLow()));
-    if (CreatureEvents != sCreatureEAIMgr.GetCreatureEventAIMap().end())
-    {
-        std::vector<CreatureEventAI_Event>::const_iterator i;
-        for (i = (*CreatureEvents).second.begin(); i != (*CreatureEvents).second.end(); ++i)
-        {
-
-            //Debug check
-            #ifndef HELLGROUND_DEBUG
-            if ((*i).event_flags & EFLAG_DEBUG_ONLY)
-                continue;
-            #endif
-            if (((*i).event_flags & (EFLAG_HEROIC | EFLAG_NORMAL)) && m_creature->GetMap()->IsDungeon())
-            {
-                if ((m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_HEROIC) ||
-                    (!m_creature->GetMap()->IsHeroic() && (*i).event_flags & EFLAG_NORMAL))
-                {
-                    //event flagged for instance mode
-                    CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
-                }
-                continue;
-            }
-            CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
-        }
-    }
+    CreatureEventAIList.reserve(EventTable->events.size());
+    for (CreatureEventAI_Event_Vec::const_iterator i = EventTable->events.begin(); i != EventTable->events.end(); ++i)
+        CreatureEventAIList.push_back(CreatureEventAIHolder(&*i));
 
     // EventMap had events but they were not added because they must be for instance
-    if (CreatureEventAIList.empty())
+    if (!EventTable->hasScriptEvents)
         sLog.outLog(LOG_DEFAULT, "ERROR: CreatureEventAI: Creature %u has events but no events added to list because of instance flags.", m_creature->GetEntry());
 
-    bEmptyList = CreatureEventAIList.empty();
+    bEmptyList = !EventTable->hasScriptEvents;
     Phase = 0;
     CombatMovementEnabled = true;
     MeleeEnabled = true;
     AttackDistance = 0.0f;
     AttackAngle = 0.0f;
     summoned = NULL;
+    EventUpdateTime = EVENT_UPDATE_TIME;
+    EventDiff = 0;
+    NextEventTime = 0;
+    EventCombatState = 0;
 
     eventAISummonedList.clear();
 
     InvinceabilityHpLevel = 0;
 
-    CreatureEventAI_Event cevent;
-    cevent.event_type = EVENT_T_TIMER;
-    cevent.event_inverse_phase_mask = 0;
-    cevent.event_chance = 100;
-    cevent.timer.initialMin = 0;
-    cevent.timer.initialMax = 2000;
-    cevent.timer.repeatMin = 2000;
-    cevent.timer.repeatMax = 3000;
-    cevent.action[0].type = ACTION_T_CHECK_OUT_OF_THREAT;
-    cevent.action[1].type = ACTION_T_NONE;
-    cevent.action[2].type = ACTION_T_NONE;
-
-    CreatureEventAIList.push_back(CreatureEventAIHolder(cevent));
-
     //Handle Spawned Events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-            if (SpawnedEventConditionsCheck((*i).Event))
-                ProcessEvent(*i);
+        std::vector<uint16> const& spawned = EventTable->eventsByType[EVENT_T_SPAWNED];
+        for (std::vector<uint16>::const_iterator i = spawned.begin(); i != spawned.end(); ++i)
+            if (SpawnedEventConditionsCheck(*CreatureEventAIList[*i].Event))
+                ProcessEvent(CreatureEventAIList[*i]);
     }
 }
 
+CreatureEventAI::~CreatureEventAI()
+{
+    sCreatureEAIMgr.ReleaseEventTable(EventTable);
+}
+
+void CreatureEventAI::ProcessEventsOfType(EventAI_Type type, Unit* pActionInvoker)
+{
+    std::vector<uint16> const& events = EventTable->eventsByType[type];
+    for (std::vector<uint16>::const_iterator i = events.begin(); i != events.end(); ++i)
+        ProcessEvent(CreatureEventAIList[*i], pActionInvoker);
+}
+
+void CreatureEventAI::UpdateEventTimers()
+{
+    for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    {
+        if (!(*i).Time)
+            continue;
+
+        if ((*i).Time > EventDiff)
+        {
+            //Do not decrement timers if event cannot trigger in this phase
+            if (!((*i).Event->event_inverse_phase_mask & (1 << Phase)))
+                (*i).Time -= EventDiff;
+        }
+        else
+            (*i).Time = 0;
+    }
+
+    EventDiff = 0;
+    NextEventTime = 0;
+}
+
+uint8 CreatureEventAI::GetEventCombatState() const
+{
+    return (m_creature->isInCombat() ? 0x01 : 0) | (m_creature->getVictim() ? 0x02 : 0);
+}
+
 bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pActionInvoker)
 {
+    // timers are not updated between event updates when nothing is due
+    if (EventDiff)
+        UpdateEventTimers();
+
     if (!pHolder.Enabled || pHolder.Time)
         return false;
 
     //Check the inverse phase mask (event doesn't trigger if current phase bit is set in mask)
-    if (pHolder.Event.event_inverse_phase_mask & (1 << Phase))
+    if (pHolder.Event->event_inverse_phase_mask & (1 << Phase))
         return false;
 
-    CreatureEventAI_Event const& event = pHolder.Event;
+    CreatureEventAI_Event const& event = *pHolder.Event;
 
     //Check event conditions based on the event type, also reset events
     switch (event.event_type)
@@ -362,24 +349,27 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
             break;
         }
         default:
-            sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Creature %u using Event %u has invalid Event Type(%u), missing from ProcessEvent() Switch.", m_creature->GetEntry(), pHolder.Event.event_id, pHolder.Event.event_type);
+            sLog.outLog(LOG_DB_ERR, "CreatureEventAI: Creature %u using Event %u has invalid Event Type(%u), missing from ProcessEvent() Switch.", m_creature->GetEntry(), pHolder.Event->event_id, pHolder.Event->event_type);
             break;
     }
 
+    //Repeat timer changed, reevaluate due events at next update
+    NextEventTime = 0;
+
     //Disable non-repeatable events
-    if (!(pHolder.Event.event_flags & EFLAG_REPEATABLE))
+    if (!(pHolder.Event->event_flags & EFLAG_REPEATABLE))
         pHolder.Enabled = false;
 
     //Store random here so that all random actions match up
     uint32 rnd = rand();
 
     //Return if chance for event is not met
-    if (pHolder.Event.event_chance <= rnd % 100)
+    if (pHolder.Event->event_chance <= rnd % 100)
         return false;
 
     //Process actions
     for (uint32 j = 0; j < MAX_ACTIONS; j++)
-        ProcessAction(pHolder.Event.action[j], rnd, pHolder.Event.event_id, pActionInvoker);
+        ProcessAction(pHolder.Event->action[j], rnd, pHolder.Event->event_id, pActionInvoker);
 
     return true;
 }
@@ -938,29 +928,27 @@ void CreatureEventAI::JustRespawned()
         return;
 
     //Handle Spawned Events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if (SpawnedEventConditionsCheck((*i).Event))
-            ProcessEvent(*i);
+    std::vector<uint16> const& spawned = EventTable->eventsByType[EVENT_T_SPAWNED];
+    for (std::vector<uint16>::const_iterator i = spawned.begin(); i != spawned.end(); ++i)
+        if (SpawnedEventConditionsCheck(*CreatureEventAIList[*i].Event))
+            ProcessEvent(CreatureEventAIList[*i]);
 }
 
 void CreatureEventAI::Reset()
 {
+    // apply pending time first, timers not restarted below keep running
+    UpdateEventTimers();
     EventUpdateTime = EVENT_UPDATE_TIME;
-    EventDiff = 0;
 
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_RESET)
-            ProcessEvent(*i);
-    }
+    ProcessEventsOfType(EVENT_T_RESET);
 
     //Reset all events to enabled
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
     {
-        CreatureEventAI_Event const& event = (*i).Event;
+        CreatureEventAI_Event const& event = *(*i).Event;
         switch (event.event_type)
         {
             //Reset all out of combat timers
@@ -984,13 +972,8 @@ void CreatureEventAI::JustReachedHome()
     m_creature->LoadCreaturesAddon();
 
     if (!bEmptyList)
-    {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        {
-            if ((*i).Event.event_type == EVENT_T_REACHED_HOME)
-                ProcessEvent(*i);
-        }
-    }
+        ProcessEventsOfType(EVENT_T_REACHED_HOME);
+
     Reset();
 }
 
@@ -1002,11 +985,7 @@ void CreatureEventAI::EnterEvadeMode()
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_EVADE)
-            ProcessEvent(*i);
-    }
+    ProcessEventsOfType(EVENT_T_EVADE);
 }
 
 void CreatureEventAI::JustDied(Unit* killer)
@@ -1017,11 +996,7 @@ void CreatureEventAI::JustDied(Unit* killer)
         return;
 
     //Handle Evade events
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_DEATH)
-            ProcessEvent(*i, killer);
-    }
+    ProcessEventsOfType(EVENT_T_DEATH, killer);
 
     eventAISummonedList.clear();
 
@@ -1034,11 +1009,7 @@ void CreatureEventAI::KilledUnit(Unit* victim)
     if (bEmptyList || victim->GetTypeId() != TYPEID_PLAYER)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_KILL)
-            ProcessEvent(*i, victim);
-    }
+    ProcessEventsOfType(EVENT_T_KILL, victim);
 }
 
 void CreatureEventAI::JustSummoned(Creature* pUnit)
@@ -1076,21 +1047,20 @@ void CreatureEventAI::JustSummoned(Creature* pUnit)
 
     eventAISummonedList.push_back(pUnit->GetGUID());
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-    {
-        if ((*i).Event.event_type == EVENT_T_SUMMONED_UNIT)
-            ProcessEvent(*i, pUnit);
-    }
+    ProcessEventsOfType(EVENT_T_SUMMONED_UNIT, pUnit);
 }
 
 void CreatureEventAI::EnterCombat(Unit *enemy)
 {
+    // apply pending time before timers are restarted
+    UpdateEventTimers();
+
     //Check for on combat start events
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+        for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
         {
-            CreatureEventAI_Event const& event = (*i).Event;
+            CreatureEventAI_Event const& event = *(*i).Event;
             switch (event.event_type)
             {
                 case EVENT_T_AGGRO:
@@ -1112,7 +1082,7 @@ void CreatureEventAI::EnterCombat(Unit *enemy)
     }
 
     EventUpdateTime = EVENT_UPDATE_TIME;
-    EventDiff = 0;
+    NextEventTime = 0;
 }
 
 void CreatureEventAI::AttackStart(Unit *who)
@@ -1135,21 +1105,21 @@ void CreatureEventAI::MoveInLineOfSight(Unit *who)
     //Check for OOC LOS Event
     if (!bEmptyList)
     {
-        for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+        std::vector<uint16> const& events = EventTable->eventsByType[EVENT_T_OOC_LOS];
+        for (std::vector<uint16>::const_iterator itr = events.begin(); itr != events.end(); ++itr)
         {
-            if ((*itr).Event.event_type == EVENT_T_OOC_LOS)
-            {
-                //can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (*itr).Event.ooc_los.maxRange;
+            CreatureEventAIHolder& holder = CreatureEventAIList[*itr];
 
-                //if range is ok and we are actually in LOS
-                if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                {
-                    //if friendly event&&who is not hostile OR hostile event&&who is hostile
-                    if (((*itr).Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
-                        ((!(*itr).Event.ooc_los.noHostile) && (me->IsHostileTo(who) || who->IsHostileTo(me))))
-                        ProcessEvent(*itr, who);
-                }
+            //can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = holder.Event->ooc_los.maxRange;
+
+            //if range is ok and we are actually in LOS
+            if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
+            {
+                //if friendly event&&who is not hostile OR hostile event&&who is hostile
+                if ((holder.Event->ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
+                    ((!holder.Event->ooc_los.noHostile) && (me->IsHostileTo(who) || who->IsHostileTo(me))))
+                    ProcessEvent(holder, who);
             }
         }
     }
@@ -1163,12 +1133,16 @@ void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
-        if ((*i).Event.event_type == EVENT_T_SPELLHIT)
-            //If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!(*i).Event.spell_hit.spellId || pSpell->Id == (*i).Event.spell_hit.spellId)
-                if (pSpell->SchoolMask & (*i).Event.spell_hit.schoolMask)
-                    ProcessEvent(*i, pUnit);
+    std::vector<uint16> const& events = EventTable->eventsByType[EVENT_T_SPELLHIT];
+    for (std::vector<uint16>::const_iterator i = events.begin(); i != events.end(); ++i)
+    {
+        CreatureEventAIHolder& holder = CreatureEventAIList[*i];
+
+        //If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.Event->spell_hit.spellId || pSpell->Id == holder.Event->spell_hit.spellId)
+            if (pSpell->SchoolMask & holder.Event->spell_hit.schoolMask)
+                ProcessEvent(holder, pUnit);
+    }
 }
 
 void CreatureEventAI::UpdateAI(const uint32 diff)
@@ -1182,55 +1156,68 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
         if (EventUpdateTime < diff)
         {
             EventDiff += diff;
+            EventUpdateTime = EVENT_UPDATE_TIME;
 
-            //Check for time based events
-            for (std::list<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+            //Only evaluate events when some timer expired, event is polled or combat state changed
+            uint8 combatState = GetEventCombatState();
+            if (EventDiff >= NextEventTime || combatState != EventCombatState)
             {
-                //Decrement Timers
-                if ((*i).Time)
+                EventCombatState = combatState;
+
+                //Decrement Timers by time since last update
+                UpdateEventTimers();
+                NextEventTime = std::numeric_limits<uint32>::max();
+
+                //Check for time based events
+                for (std::vector<CreatureEventAIHolder>::iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
                 {
-                    if ((*i).Time > EventDiff)
+                    //Skip processing of events that have time remaining
+                    if ((*i).Time)
                     {
-                        //Do not decrement timers if event cannot trigger in this phase
-                        if (!((*i).Event.event_inverse_phase_mask & (1 << Phase)))
-                            (*i).Time -= EventDiff;
-
-                        //Skip processing of events that have time remaining
+                        NextEventTime = std::min(NextEventTime, (*i).Time);
                         continue;
                     }
-                    else (*i).Time = 0;
-                }
 
-                //Events that are updated every EVENT_UPDATE_TIME
-                switch ((*i).Event.event_type)
-                {
-                    case EVENT_T_TIMER_OOC:
-                        ProcessEvent(*i);
-                        break;
-                    case EVENT_T_TIMER:
-                    case EVENT_T_MANA:
-                    case EVENT_T_HP:
-                    case EVENT_T_TARGET_HP:
-                    case EVENT_T_TARGET_CASTING:
-                    case EVENT_T_FRIENDLY_HP:
-                        if (me->getVictim())
+                    //Events that are updated every EVENT_UPDATE_TIME
+                    bool polled = false;
+                    switch ((*i).Event->event_type)
+                    {
+                        case EVENT_T_TIMER_OOC:
                             ProcessEvent(*i);
-                        break;
-                    case EVENT_T_RANGE:
-                        if (me->getVictim())
-                        {
-                            if (m_creature->IsInMap(m_creature->getVictim()))
+                            polled = !m_creature->isInCombat();
+                            break;
+                        case EVENT_T_TIMER:
+                        case EVENT_T_MANA:
+                        case EVENT_T_HP:
+                        case EVENT_T_TARGET_HP:
+                        case EVENT_T_TARGET_CASTING:
+                        case EVENT_T_FRIENDLY_HP:
+                            if (me->getVictim())
                             {
-                                if (m_creature->IsInRange(m_creature->getVictim(),(float)(*i).Event.range.minDist,(float)(*i).Event.range.maxDist))
-                                    ProcessEvent(*i);
+                                ProcessEvent(*i);
+                                polled = true;
                             }
-                        }
-                        break;
+                            break;
+                        case EVENT_T_RANGE:
+                            if (me->getVictim())
+                            {
+                                if (m_creature->IsInMap(m_creature->getVictim()))
+                                {
+                                    if (m_creature->IsInRange(m_creature->getVictim(),(float)(*i).Event->range.minDist,(float)(*i).Event->range.maxDist))
+                                        ProcessEvent(*i);
+                                }
+                                polled = true;
+                            }
+                            break;
+                    }
+
+                    //Event got new timer or waits for its condition each update
+                    if ((*i).Time)
+                        NextEventTime = std::min(NextEventTime, (*i).Time);
+                    else if (polled && (*i).Enabled)
+                        NextEventTime = 0;
                 }
             }
-
-            EventDiff = 0;
-            EventUpdateTime = EVENT_UPDATE_TIME;
         }
         else
         {
@@ -1433,19 +1420,19 @@ void CreatureEventAI::ReceiveEmote(Player* pPlayer, uint32 text_emote)
     if (bEmptyList)
         return;
 
-    for (std::list<CreatureEventAIHolder>::iterator itr = CreatureEventAIList.begin(); itr != CreatureEventAIList.end(); ++itr)
+    std::vector<uint16> const& events = EventTable->eventsByType[EVENT_T_RECEIVE_EMOTE];
+    for (std::vector<uint16>::const_iterator i = events.begin(); i != events.end(); ++i)
     {
-        if ((*itr).Event.event_type == EVENT_T_RECEIVE_EMOTE)
-        {
-            if ((*itr).Event.receive_emote.emoteId != text_emote)
-                return;
+        CreatureEventAIHolder& holder = CreatureEventAIList[*i];
 
-            PlayerCondition pcon((*itr).Event.receive_emote.condition,(*itr).Event.receive_emote.conditionValue1,(*itr).Event.receive_emote.conditionValue2);
-            if (pcon.Meets(pPlayer))
-            {
-                sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
-                ProcessEvent(*itr, pPlayer);
-            }
+        if (holder.Event->receive_emote.emoteId != text_emote)
+            return;
+
+        PlayerCondition pcon(holder.Event->receive_emote.condition,holder.Event->receive_emote.conditionValue1,holder.Event->receive_emote.conditionValue2);
+        if (pcon.Meets(pPlayer))
+        {
+            sLog.outDebug("CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
+            ProcessEvent(holder, pPlayer);
         }
     }
 }
@@ -28,6 +28,7 @@
 
 class Player;
 class WorldObject;
+struct CreatureEventAI_EventTable;
 
 #define EVENT_UPDATE_TIME               500
 #define MAX_ACTIONS                     3
@@ -591,11 +592,12 @@ struct CreatureEventAI_Summon
 //EventSummon_Map
 typedef UNORDERED_MAP<uint32, CreatureEventAI_Summon> CreatureEventAI_Summon_Map;
 
+// per creature state of one event, definition is shared by all creatures with the same table
 struct CreatureEventAIHolder
 {
-    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true){}
+    CreatureEventAIHolder(CreatureEventAI_Event const* p) : Event(p), Time(0), Enabled(true){}
 
-    CreatureEventAI_Event Event;
+    CreatureEventAI_Event const* Event;
     uint32 Time;
     bool Enabled;
 
@@ -608,10 +610,7 @@ class HELLGROUND_IMPORT_EXPORT CreatureEventAI : public CreatureAI
 
     public:
         explicit CreatureEventAI(Creature *c);
-        ~CreatureEventAI()
-        {
-            CreatureEventAIList.clear();
-        }
+        ~CreatureEventAI();
         void JustRespawned();
         void Reset();
         void JustReachedHome();
@@ -638,15 +637,23 @@ class HELLGROUND_IMPORT_EXPORT CreatureEventAI : public CreatureAI
         bool CanCast(Unit* Target, SpellEntry const *Spell, bool Triggered);
 
         bool SpawnedEventConditionsCheck(CreatureEventAI_Event const& event);
+        void ProcessEventsOfType(EventAI_Type type, Unit* pActionInvoker = NULL);
+
+        // applies EventDiff to timers of all events without processing them
+        void UpdateEventTimers();
+        uint8 GetEventCombatState() const;
 
         Unit* SelectLowestHpFriendly(float range, uint32 MinHPDiff);
         void FindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid);
         void FindFriendlyCC(std::list<Creature*>& _list, float range);
 
-                                                            //Holder for events (stores enabled, time, and eventid)
-        std::list<CreatureEventAIHolder> CreatureEventAIList;
+        CreatureEventAI_EventTable* EventTable;             //Shared compiled events of this creature
+                                                            //Holder for events (stores enabled, time), same order as EventTable
+        std::vector<CreatureEventAIHolder> CreatureEventAIList;
         uint32 EventUpdateTime;                             //Time between event updates
-        uint32 EventDiff;                                   //Time between the last event call
+        uint32 EventDiff;                                   //Time not yet applied to event timers
+        uint32 NextEventTime;                               //EventDiff at which some event timer expires, 0 when events are polled
+        uint8 EventCombatState;                             //Combat state at last event update
         bool bEmptyList;
 
         //Variables used by Events themselves
@@ -27,6 +27,109 @@
 #include "ObjectGuid.h"
 #include "GridDefines.h"
 
+CreatureEventAIMgr::CreatureEventAIMgr()
+{
+    // every EventAI creature checks if it still has someone to fight
+    memset(&m_outOfThreatEvent, 0, sizeof(m_outOfThreatEvent));
+    m_outOfThreatEvent.event_type = EVENT_T_TIMER;
+    m_outOfThreatEvent.event_chance = 100;
+    m_outOfThreatEvent.event_flags = EFLAG_REPEATABLE;
+    m_outOfThreatEvent.timer.initialMin = 0;
+    m_outOfThreatEvent.timer.initialMax = 2000;
+    m_outOfThreatEvent.timer.repeatMin = 2000;
+    m_outOfThreatEvent.timer.repeatMax = 3000;
+    m_outOfThreatEvent.action[0].type = ACTION_T_CHECK_OUT_OF_THREAT;
+    m_outOfThreatEvent.action[1].type = ACTION_T_NONE;
+    m_outOfThreatEvent.action[2].type = ACTION_T_NONE;
+}
+
+CreatureEventAIMgr::~CreatureEventAIMgr()
+{
+    DropEventTables();
+}
+
+void CreatureEventAIMgr::AddTableEvents(CreatureEventAI_EventTable* table, int64 entryOrGUID, CreatureEventAI_TableMode mode) const
+{
+    CreatureEventAI_Event_Map::const_iterator events = m_CreatureEventAI_Event_Map.find(entryOrGUID);
+    if (events == m_CreatureEventAI_Event_Map.end())
+        return;
+
+    for (CreatureEventAI_Event_Vec::const_iterator i = events->second.begin(); i != events->second.end(); ++i)
+    {
+        //Debug check
+        #ifndef HELLGROUND_DEBUG
+        if ((*i).event_flags & EFLAG_DEBUG_ONLY)
+            continue;
+        #endif
+
+        //event flagged for instance mode
+        if (((*i).event_flags & (EFLAG_HEROIC | EFLAG_NORMAL)) && mode != EVENTAI_TABLE_WORLD)
+        {
+            if (!((*i).event_flags & (mode == EVENTAI_TABLE_HEROIC ? EFLAG_HEROIC : EFLAG_NORMAL)))
+                continue;
+        }
+
+        table->events.push_back(*i);
+    }
+}
+
+CreatureEventAI_EventTable* CreatureEventAIMgr::AcquireEventTable(Creature const* creature)
+{
+    CreatureEventAI_TableMode mode = EVENTAI_TABLE_WORLD;
+    if (creature->GetMap()->IsDungeon())
+        mode = creature->GetMap()->IsHeroic() ? EVENTAI_TABLE_HEROIC : EVENTAI_TABLE_NORMAL;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_eventTablesLock, NULL);
+
+    // creatures with own spawn events can't share table with others of their entry
+    bool spawnEvents = m_CreatureEventAI_Event_Map.find(-int64(creature->GetGUIDLow())) != m_CreatureEventAI_Event_Map.end();
+
+    uint64 key = uint64(creature->GetEntry()) * MAX_EVENTAI_TABLE_MODE + mode;
+    if (!spawnEvents)
+    {
+        EventTableMap::const_iterator itr = m_eventTables.find(key);
+        if (itr != m_eventTables.end())
+        {
+            itr->second->AddRef();
+            return itr->second;
+        }
+    }
+
+    CreatureEventAI_EventTable* table = new CreatureEventAI_EventTable();
+    AddTableEvents(table, int64(creature->GetEntry()), mode);
+    AddTableEvents(table, -int64(creature->GetGUIDLow()), mode);
+
+    table->hasScriptEvents = !table->events.empty();
+    table->events.push_back(m_outOfThreatEvent);
+
+    for (uint16 i = 0; i < table->events.size(); ++i)
+        table->eventsByType[table->events[i].event_type].push_back(i);
+
+    table->AddRef();
+    if (!spawnEvents)
+    {
+        table->AddRef();
+        m_eventTables[key] = table;
+    }
+
+    return table;
+}
+
+void CreatureEventAIMgr::ReleaseEventTable(CreatureEventAI_EventTable* table)
+{
+    if (table->Release())
+        delete table;
+}
+
+void CreatureEventAIMgr::DropEventTables()
+{
+    // creatures keep using tables of old events until they are recreated
+    for (EventTableMap::iterator itr = m_eventTables.begin(); itr != m_eventTables.end(); ++itr)
+        ReleaseEventTable(itr->second);
+
+    m_eventTables.clear();
+}
+
 // -------------------
 void CreatureEventAIMgr::LoadCreatureEventAI_Texts(bool check_entry_use)
 {
@@ -237,6 +340,9 @@ void CreatureEventAIMgr::CheckUnusedAISummons()
 // -------------------
 void CreatureEventAIMgr::LoadCreatureEventAI_Scripts(uint32 creatureId)
 {
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_eventTablesLock);
+    DropEventTables();
+
     //Drop Existing EventAI List
     if (creatureId > 0)
         m_CreatureEventAI_Event_Map[creatureId].clear();
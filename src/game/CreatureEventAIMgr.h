@@ -25,14 +25,31 @@
 
 #include "Common.h"
 #include "CreatureEventAI.h"
+#include "Referencable.h"
+
+enum CreatureEventAI_TableMode
+{
+    EVENTAI_TABLE_WORLD     = 0,                            // difficulty flags ignored
+    EVENTAI_TABLE_NORMAL    = 1,
+    EVENTAI_TABLE_HEROIC    = 2,
+    MAX_EVENTAI_TABLE_MODE
+};
+
+// events of creature entry filtered for one map difficulty, compiled once and shared by all its creatures
+struct CreatureEventAI_EventTable : public Referencable<AtomicLong>
+{
+    CreatureEventAI_Event_Vec events;                       // script events followed by built-in out of threat check
+    std::vector<uint16> eventsByType[EVENT_T_END];          // indexes into events
+    bool hasScriptEvents;
+};
 
 class CreatureEventAIMgr
 {
     friend class ACE_Singleton<CreatureEventAIMgr, ACE_Null_Mutex>;
-    CreatureEventAIMgr(){};
+    CreatureEventAIMgr();
 
     public:
-        ~CreatureEventAIMgr(){};
+        ~CreatureEventAIMgr();
 
         void LoadCreatureEventAI_Texts(bool check_entry_use);
         void LoadCreatureEventAI_Summons(bool check_entry_use);
@@ -42,10 +59,23 @@ class CreatureEventAIMgr
         CreatureEventAI_Summon_Map const& GetCreatureEventAISummonMap() const { return m_CreatureEventAI_Summon_Map; }
         CreatureEventAI_TextMap    const& GetCreatureEventAITextMap()   const { return m_CreatureEventAI_TextMap; }
 
+        // returned table is referenced for caller, may be called from map threads
+        CreatureEventAI_EventTable* AcquireEventTable(Creature const* creature);
+        void ReleaseEventTable(CreatureEventAI_EventTable* table);
+
     private:
         void CheckUnusedAITexts();
         void CheckUnusedAISummons();
 
+        void AddTableEvents(CreatureEventAI_EventTable* table, int64 entryOrGUID, CreatureEventAI_TableMode mode) const;
+        void DropEventTables();
+
+        typedef UNORDERED_MAP<uint64, CreatureEventAI_EventTable*> EventTableMap;
+
+        ACE_Thread_Mutex m_eventTablesLock;
+        EventTableMap m_eventTables;                        // entry * MAX_EVENTAI_TABLE_MODE + mode
+        CreatureEventAI_Event m_outOfThreatEvent;
+
         CreatureEventAI_Event_Map  m_CreatureEventAI_Event_Map;
         CreatureEventAI_Summon_Map m_CreatureEventAI_Summon_Map;
         CreatureEventAI_TextMap    m_CreatureEventAI_TextMap;
@@ -39,6 +39,7 @@
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
+#include "Group.h"
 
 #define COMMAND_COOLDOWN 2
 
@@ -957,6 +958,195 @@ bool ChatHandler::HandleDebugAnimCommand(const char* args)
     return true;
 }
 
+// compares grid walk with map unit index for area unit searches around player, optionally summons test creatures first
+bool ChatHandler::HandleDebugSearchBenchCommand(const char* args)
+{
+    char* radiusStr = strtok((char*)args, " ");
+    char* iterStr = strtok(NULL, " ");
+    char* entryStr = strtok(NULL, " ");
+
+    float radius = radiusStr ? (float)atof(radiusStr) : 30.0f;
+    uint32 iterations = iterStr ? (uint32)atoi(iterStr) : 1000;
+    uint32 entry = entryStr ? (uint32)atoi(entryStr) : 0;
+
+    if (radius <= 0.0f || !iterations)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+
+    if (entry)
+    {
+        if (!sObjectMgr.GetCreatureTemplate(entry))
+        {
+            PSendSysMessage(LANG_COMMAND_INVALIDCREATUREID, entry);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        // 500 units spread on a disc inside search radius, despawned after a minute
+        for (uint32 i = 0; i < 500; ++i)
+        {
+            float angle = rand_norm() * 2 * M_PI;
+            float dist = sqrt(rand_norm()) * radius;
+            player->SummonCreature(entry, player->GetPositionX() + dist * cos(angle), player->GetPositionY() + dist * sin(angle),
+                player->GetPositionZ(), angle, TEMPSUMMON_TIMED_DESPAWN, MINUTE*IN_MILISECONDS);
+        }
+    }
+
+    Hellground::AnyUnitInObjectRangeCheck check(player, radius);
+
+    uint32 gridFound = 0;
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        std::list<Unit*> units;
+        Hellground::UnitListSearcher<Hellground::AnyUnitInObjectRangeCheck> searcher(units, check);
+        Cell::VisitAllObjects(player, searcher, radius);
+        gridFound = units.size();
+    }
+    ACE_Time_Value gridTime = ACE_OS::gettimeofday() - start;
+
+    uint32 indexFound = 0;
+    start = ACE_OS::gettimeofday();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        std::vector<Unit*> candidates;
+        player->GetMap()->GetUnitIndex().GetUnitsInRange(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ(),
+            radius + player->GetObjectSize(), TYPEMASK_UNIT, candidates);
+
+        std::list<Unit*> units;
+        for (std::vector<Unit*>::iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+            if (check(*itr))
+                units.push_back(*itr);
+
+        indexFound = units.size();
+    }
+    ACE_Time_Value indexTime = ACE_OS::gettimeofday() - start;
+
+    PSendSysMessage("Search radius %.1f, %u iterations", radius, iterations);
+    PSendSysMessage("Grid walk: %u units, " UI64FMTD " us total", gridFound, uint64(gridTime.sec()) * 1000000 + gridTime.usec());
+    PSendSysMessage("Unit index: %u units, " UI64FMTD " us total", indexFound, uint64(indexTime.sec()) * 1000000 + indexTime.usec());
+    return true;
+}
+
+// raid buff cycle: apply common raid buffs to player and group members on same map, read stat modifiers, remove them
+bool ChatHandler::HandleDebugAuraBenchCommand(const char* args)
+{
+    static const uint32 raidBuffs[] =
+    {
+        25389, 26990, 27126, 25312, 25433,      // fortitude, mark of the wild, arcane intellect, divine spirit, shadow protection
+        20217, 27140, 27142, 26992, 2048        // kings, might, wisdom, thorns, battle shout
+    };
+    static const uint32 raidBuffsCount = sizeof(raidBuffs) / sizeof(uint32);
+
+    uint32 cycles = *args ? (uint32)atoi(args) : 100;
+    if (!cycles || cycles > 1000)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+
+    std::vector<Unit*> targets;
+    targets.push_back(player);
+    if (Group* group = player->GetGroup())
+    {
+        for (GroupReference* itr = group->GetFirstMember(); itr != NULL; itr = itr->next())
+        {
+            Player* member = itr->getSource();
+            if (member && member != player && member->IsInWorld() && member->GetMap() == player->GetMap())
+                targets.push_back(member);
+        }
+    }
+
+    uint64 applyTime = 0, iterateTime = 0, removeTime = 0;
+    int32 checksum = 0;
+
+    for (uint32 i = 0; i < cycles; ++i)
+    {
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+        for (std::vector<Unit*>::iterator itr = targets.begin(); itr != targets.end(); ++itr)
+            for (uint32 j = 0; j < raidBuffsCount; ++j)
+                player->AddAura(raidBuffs[j], *itr);
+
+        ACE_Time_Value applied = ACE_OS::gettimeofday();
+        for (std::vector<Unit*>::iterator itr = targets.begin(); itr != targets.end(); ++itr)
+        {
+            checksum += (*itr)->GetTotalAuraModifier(SPELL_AURA_MOD_STAT);
+            checksum += (*itr)->GetTotalAuraModifier(SPELL_AURA_MOD_RESISTANCE);
+            checksum += (*itr)->GetTotalAuraModifier(SPELL_AURA_MOD_ATTACK_POWER);
+            checksum += (*itr)->GetTotalAuraModifier(SPELL_AURA_MOD_TOTAL_STAT_PERCENTAGE);
+        }
+
+        ACE_Time_Value iterated = ACE_OS::gettimeofday();
+        for (std::vector<Unit*>::iterator itr = targets.begin(); itr != targets.end(); ++itr)
+            for (uint32 j = 0; j < raidBuffsCount; ++j)
+                (*itr)->RemoveAurasDueToSpell(raidBuffs[j]);
+
+        ACE_Time_Value removed = ACE_OS::gettimeofday();
+
+        ACE_Time_Value diff = applied - start;
+        applyTime += uint64(diff.sec()) * 1000000 + diff.usec();
+        diff = iterated - applied;
+        iterateTime += uint64(diff.sec()) * 1000000 + diff.usec();
+        diff = removed - iterated;
+        removeTime += uint64(diff.sec()) * 1000000 + diff.usec();
+    }
+
+    PSendSysMessage("Aura bench: %u targets, %u buffs, %u cycles (checksum %i)", uint32(targets.size()), raidBuffsCount, cycles, checksum);
+    PSendSysMessage("Apply: " UI64FMTD " us, iterate: " UI64FMTD " us, remove: " UI64FMTD " us", applyTime, iterateTime, removeTime);
+    return true;
+}
+
+// replays a fixed melee combat log between player and selected unit through proc handling
+bool ChatHandler::HandleDebugProcBenchCommand(const char* args)
+{
+    struct SwingLogEntry
+    {
+        uint32 procEx;
+        uint32 damage;
+    };
+
+    // typical raid melee outcome distribution, repeated in order
+    static const SwingLogEntry swingLog[] =
+    {
+        { PROC_EX_NORMAL_HIT,   1200 },
+        { PROC_EX_NORMAL_HIT,   1150 },
+        { PROC_EX_CRITICAL_HIT, 2400 },
+        { PROC_EX_NORMAL_HIT,   1180 },
+        { PROC_EX_DODGE,        0    },
+        { PROC_EX_NORMAL_HIT,   1220 },
+        { PROC_EX_PARRY,        0    },
+        { PROC_EX_NORMAL_HIT,   1170 },
+        { PROC_EX_CRITICAL_HIT, 2350 },
+        { PROC_EX_MISS,         0    }
+    };
+    static const uint32 swingLogSize = sizeof(swingLog) / sizeof(SwingLogEntry);
+
+    uint32 swings = *args ? (uint32)atoi(args) : 10000;
+    if (!swings)
+        return false;
+
+    Unit* target = getSelectedUnit();
+    Player* player = m_session->GetPlayer();
+    if (!target || target == player)
+    {
+        SendSysMessage(LANG_SELECT_CHAR_OR_CREATURE);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+    for (uint32 i = 0; i < swings; ++i)
+    {
+        SwingLogEntry const& swing = swingLog[i % swingLogSize];
+        player->ProcDamageAndSpell(target, PROC_FLAG_SUCCESSFUL_MELEE_HIT, PROC_FLAG_TAKEN_MELEE_HIT, swing.procEx, swing.damage, BASE_ATTACK);
+    }
+    ACE_Time_Value diff = ACE_OS::gettimeofday() - start;
+
+    uint64 usec = uint64(diff.sec()) * 1000000 + diff.usec();
+    PSendSysMessage("Proc bench: %u swings in " UI64FMTD " us, %u swings per second", swings, usec, usec ? uint32(uint64(swings) * 1000000 / usec) : 0);
+    return true;
+}
+
 bool ChatHandler::HandleDebugShowCombatStats(const char* args)
 {
     if(!args)
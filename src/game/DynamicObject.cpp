@@ -32,6 +32,8 @@
 #include "CellImpl.h"
 #include "GridNotifiersImpl.h"
 #include "World.h"
+#include "ObjectPool.h"
+#include "ObjectMgr.h"
 
 DynamicObject::DynamicObject() : WorldObject()
 {
@@ -43,6 +45,23 @@ DynamicObject::DynamicObject() : WorldObject()
     m_valuesCount = DYNAMICOBJECT_END;
 }
 
+DynamicObject::~DynamicObject()
+{
+    // values exist only after Create
+    if (m_uint32Values)
+        sObjectMgr.ReleaseLowGuid(HIGHGUID_DYNAMICOBJECT, GetGUIDLow());
+}
+
+void* DynamicObject::operator new(size_t size)
+{
+    return sObjectPoolMgr.GetDynamicObjectPool().Allocate(size);
+}
+
+void DynamicObject::operator delete(void* ptr)
+{
+    ObjectSlabPool::Deallocate(ptr);
+}
+
 void DynamicObject::AddToWorld()
 {
     ///- Register the dynamicObject for guid lookup
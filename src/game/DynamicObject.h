@@ -31,6 +31,11 @@ class DynamicObject : public WorldObject
     public:
         typedef std::set<Unit*> AffectedSet;
         explicit DynamicObject();
+        ~DynamicObject();
+
+        // allocated from sObjectPoolMgr dynamic object pool
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
 
         void AddToWorld();
         void RemoveFromWorld();
@@ -43,6 +43,7 @@
 #include "BattleGroundAV.h"
 #include "Map.h"
 #include "ScriptMgr.h"
+#include "ObjectPool.h"
 
 GameObject::GameObject() : WorldObject()
 {
@@ -71,6 +72,16 @@ GameObject::~GameObject()
     CleanupsBeforeDelete();
 }
 
+void* GameObject::operator new(size_t size)
+{
+    return sObjectPoolMgr.GetGameObjectPool().Allocate(size);
+}
+
+void GameObject::operator delete(void* ptr)
+{
+    ObjectSlabPool::Deallocate(ptr);
+}
+
 void GameObject::CleanupsBeforeDelete()
 {
     if (m_uint32Values)                                      // field array can be not exist if GameOBject not loaded
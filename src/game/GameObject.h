@@ -440,6 +440,10 @@ class HELLGROUND_IMPORT_EXPORT GameObject : public WorldObject
         explicit GameObject();
         ~GameObject();
 
+        // allocated from sObjectPoolMgr gameobject pool
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
         void SendCustomAnimation();
         void SendSpawnAnimation();
 
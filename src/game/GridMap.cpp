@@ -619,6 +619,7 @@ TerrainInfo::TerrainInfo(uint32 mapid, TerrainSpecifics terrainspecifics) : m_ma
         {
             m_GridMaps[i][k] = NULL;
             m_GridRef[i][k] = 0;
+            m_vmapGeneration[i][k] = 0;
         }
     }
 
@@ -703,6 +704,7 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
 
                  //unload VMAPS...
                  VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+                 ++m_vmapGeneration[x][y];
                  MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
              }
          }
@@ -992,6 +994,28 @@ float TerrainInfo::GetWaterOrGroundLevel(float x, float y, float z, float* pGrou
     return VMAP_INVALID_HEIGHT_VALUE;
 }
 
+uint32 TerrainInfo::GetVMapGeneration(float x1, float y1, float x2, float y2) const
+{
+    // same tile indexes as GetGrid, clamped to map
+    int32 gx1 = int32(32 - x1 / SIZE_OF_GRIDS);
+    int32 gy1 = int32(32 - y1 / SIZE_OF_GRIDS);
+    int32 gx2 = int32(32 - x2 / SIZE_OF_GRIDS);
+    int32 gy2 = int32(32 - y2 / SIZE_OF_GRIDS);
+
+    int32 minX = std::max(0, std::min(gx1, gx2));
+    int32 maxX = std::min(MAX_NUMBER_OF_GRIDS - 1, std::max(gx1, gx2));
+    int32 minY = std::max(0, std::min(gy1, gy2));
+    int32 maxY = std::min(MAX_NUMBER_OF_GRIDS - 1, std::max(gy1, gy2));
+
+    // tile generations only grow, so sum changes when any tile the ray can cross changes
+    uint32 generation = 0;
+    for (int32 x = minX; x <= maxX; ++x)
+        for (int32 y = minY; y <= maxY; ++y)
+            generation += m_vmapGeneration[x][y];
+
+    return generation;
+}
+
 GridMap* TerrainInfo::GetGrid(const float x, const float y)
 {
     // half opt method
@@ -1057,6 +1081,9 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
             MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
 
+            if (vmapLoadResult == VMAP::VMAP_LOAD_RESULT_OK)
+                ++m_vmapGeneration[x][y];
+
             m_GridMaps[x][y] = map;
         }
     }
@@ -1085,7 +1112,7 @@ float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= N
     return VMAP_INVALID_HEIGHT_VALUE;
 }
 
-bool TerrainInfo::IsLineOfSightEnabled() const
+bool TerrainInfo::IsLineOfSightEnabled(MapLoadLevel level) const
 {
     const TerrainSpecifics* specifics = GetSpecifics();
     if (specifics == nullptr)
@@ -1097,16 +1124,13 @@ bool TerrainInfo::IsLineOfSightEnabled() const
     if (specifics->lineofsight == F_ALWAYS_ENABLED)
         return sWorld.getConfig(CONFIG_VMAP_LOS_ENABLED);
 
-    if (sWorld.getConfig(CONFIG_COREBALANCER_ENABLED))
-    {
-        if (specifics->lineofsight <= sWorld.GetCoreBalancerTreshold())
-            return false;
-    }
+    if (specifics->lineofsight <= level)
+        return false;
 
     return specifics->lineofsight != F_ALWAYS_DISABLED && sWorld.getConfig(CONFIG_VMAP_LOS_ENABLED);
 }
 
-bool TerrainInfo::IsPathFindingEnabled() const
+bool TerrainInfo::IsPathFindingEnabled(MapLoadLevel level) const
 {
     const TerrainSpecifics* specifics = GetSpecifics();
     if (specifics == nullptr)
@@ -1118,26 +1142,19 @@ bool TerrainInfo::IsPathFindingEnabled() const
     if (specifics->pathfinding == F_ALWAYS_ENABLED)
         return sWorld.getConfig(CONFIG_MMAP_ENABLED);
 
-    if (sWorld.getConfig(CONFIG_COREBALANCER_ENABLED))
-    {
-        if (specifics->pathfinding <= sWorld.GetCoreBalancerTreshold())
-            return false;
-    }
+    if (specifics->pathfinding <= level)
+        return false;
 
     return GetSpecifics()->pathfinding != F_ALWAYS_DISABLED && sWorld.getConfig(CONFIG_MMAP_ENABLED);
 }
 
-float TerrainInfo::GetVisibilityDistance()
+float TerrainInfo::GetVisibilityDistance() const
 {
     const TerrainSpecifics* specifics = GetSpecifics();
     if (specifics == nullptr)
         return DEFAULT_VISIBILITY_DISTANCE;
 
-    float visibility = specifics->visibility;
-    if (sWorld.GetCoreBalancerTreshold() >= CB_VISIBILITY_PENALTY)
-        visibility -= sWorld.getConfig(CONFIG_COREBALANCER_VISIBILITY_PENALTY);
-
-    return visibility;
+    return specifics->visibility;
 }
 
 //////////////////////////////////////////////////////////////////////////
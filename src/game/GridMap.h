@@ -27,9 +27,12 @@
 #include "GridDefines.h"
 #include "Object.h"
 #include "SharedDefines.h"
+#include "MapLoadGovernor.h"
+#include "Referencable.h"
 
 #include <bitset>
 #include <list>
+#include <tbb/atomic.h>
 
 class Creature;
 class Unit;
@@ -65,25 +68,6 @@ struct GridMapAreaHeader
     uint16 gridArea;
 };
 
-template<typename Countable>
-class HELLGROUND_IMPORT_EXPORT Referencable
-{
-    public:
-        Referencable() { m_count = 0; }
-
-        void AddRef() { ++m_count; }
-        bool Release() { return (--m_count < 1); }
-        bool IsReferenced() const { return (m_count > 0); }
-
-    private:
-        Referencable(const Referencable&);
-        Referencable& operator=(const Referencable&);
-
-        Countable m_count;
-};
-
-typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicLong;
-
 #define MAP_HEIGHT_NO_HEIGHT  0x0001
 #define MAP_HEIGHT_AS_INT16   0x0002
 #define MAP_HEIGHT_AS_INT8    0x0004
@@ -203,9 +187,21 @@ enum FeaturePriority
     F_MID_PRIORITY    = 2,
     F_HIGH_PRIORITY   = 3,
 
-    F_ALWAYS_ENABLED = 6//CB_TRESHOLD_MAX +1,
+    F_ALWAYS_ENABLED = 6//MAP_LOAD_MAX,
 };
 
+inline
+bool operator>(FeaturePriority rhs, MapLoadLevel lhs)
+{
+    return static_cast<int>(rhs) > static_cast<int>(lhs);
+}
+
+inline
+bool operator<=(FeaturePriority rhs, MapLoadLevel lhs)
+{
+    return !(rhs > lhs);
+}
+
 typedef struct MapTemplate
 {
     MapTemplate()
@@ -265,10 +261,19 @@ class HELLGROUND_IMPORT_EXPORT TerrainInfo : public Referencable<AtomicLong>
         //THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
         void CleanUpGrids(const uint32 diff);
 
-        float GetVisibilityDistance();
+        float GetVisibilityDistance() const;
+
+        bool IsLineOfSightEnabled(MapLoadLevel level = MAP_LOAD_NORMAL) const;
+        bool IsPathFindingEnabled(MapLoadLevel level = MAP_LOAD_NORMAL) const;
 
-        bool IsLineOfSightEnabled() const;
-        bool IsPathFindingEnabled() const;
+        //keep GridMap with its vmap/mmap tiles referenced without any Map instance,
+        //used by MapManager to prewarm popular instance maps
+        void PreloadGrid(const uint32 x, const uint32 y) { Load(x, y); }
+        void ReleasePreloadedGrid(const uint32 x, const uint32 y) { Unload(x, y); }
+
+        //changes whenever vmap tile under the segment bounding box is loaded or unloaded,
+        //line of sight result between these points is valid for one generation
+        uint32 GetVMapGeneration(float x1, float y1, float x2, float y2) const;
 
     protected:
         friend class Map;
@@ -293,6 +298,8 @@ class HELLGROUND_IMPORT_EXPORT TerrainInfo : public Referencable<AtomicLong>
         GridMap *m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        tbb::atomic<uint32> m_vmapGeneration[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+
         //global garbage collection timer
         ShortIntervalTimer i_timer;
 
@@ -52,6 +52,9 @@ void VisibleNotifier::SendToSelf()
         }
     }
 
+    if (i_nearBandOnly)
+        vis_guids.clear();
+
     for (Player::ClientGUIDs::const_iterator it = vis_guids.begin(); it != vis_guids.end(); ++it)
     {
         player.m_clientGUIDs.erase(*it);
@@ -199,6 +202,44 @@ void PacketBroadcaster::BroadcastPacketTo(Player* player)
     }
 }
 
+MovementBroadcaster::MovementBroadcaster(WorldObject& src, WorldPacket* msg, Player* except, Player* controller, uint32 heartbeat) :
+    _source(src), _message(msg), _controller(controller), _heartbeat(heartbeat), i_sent(0), i_skipped(0)
+{
+    if (except)
+        playerGUIDS.insert(except->GetGUID());
+
+    _fullRateDist = sWorld.getConfig(CONFIG_MOVEMENT_RELAY_FULL_RATE_DIST);
+    _farRate = sWorld.getConfig(CONFIG_MOVEMENT_RELAY_FAR_HEARTBEAT_RATE);
+}
+
+void MovementBroadcaster::Visit(CameraMapType& m)
+{
+    for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* player = iter->getSource()->GetOwner();
+
+        if (!player->HaveAtClient(&_source))
+            continue;
+
+        if (!playerGUIDS.insert(player->GetGUID()).second)
+            continue;
+
+        // state changes are always sent, observers spread over heartbeats by their guid
+        if (_heartbeat && _farRate > 1 && _fullRateDist > 0.0f && (_heartbeat + player->GetGUIDLow()) % _farRate &&
+            !_source.IsWithinDist(iter->getSource()->GetBody(), _fullRateDist) &&
+            !(_controller && _controller->IsInSameRaidWith(player)))
+        {
+            ++i_skipped;
+            continue;
+        }
+
+        if (WorldSession* session = player->GetSession())
+            session->SendPacket(_message);
+
+        ++i_sent;
+    }
+}
+
 template<class T>
 void ObjectUpdater::Visit(GridRefManager<T> &m)
 {
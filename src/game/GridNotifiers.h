@@ -47,8 +47,10 @@ namespace Hellground
         UpdateData i_data;
         std::set<WorldObject*> i_visibleNow;
         Player::ClientGUIDs vis_guids;
+        bool i_nearBandOnly;
 
-        VisibleNotifier(Camera &c) : _camera(c), vis_guids(c.GetOwner()->m_clientGUIDs) {}
+        // near band only notifier don't remove not visited objects, they are out of visited range but not out of visibility range
+        VisibleNotifier(Camera &c, bool nearBandOnly = false) : _camera(c), vis_guids(c.GetOwner()->m_clientGUIDs), i_nearBandOnly(nearBandOnly) {}
 
         void Visit(CameraMapType &m) {}
 
@@ -115,6 +117,32 @@ namespace Hellground
         void Visit(GridRefManager<SKIP>&) {}
     };
 
+    // movement relay: heartbeats reach observers farther than Movement.RelayFullRateDistance
+    // (except group members) only every Movement.RelayFarHeartbeatRate-th time
+    struct HELLGROUND_EXPORT MovementBroadcaster
+    {
+        WorldObject &_source;
+        WorldPacket *_message;
+        Player *_controller;
+
+        typedef std::set<uint64> GUIDSet;
+        GUIDSet playerGUIDS;
+
+        uint32 _heartbeat;                                  // sequence number of heartbeat, 0 for state change
+        uint32 _farRate;
+        float _fullRateDist;
+
+        uint32 i_sent;
+        uint32 i_skipped;
+
+        MovementBroadcaster(WorldObject&, WorldPacket*, Player* except, Player* controller, uint32 heartbeat);
+
+        void Visit(CameraMapType &);
+
+        template<class SKIP>
+        void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct HELLGROUND_EXPORT ObjectUpdater
     {
         uint32 i_timeDiff;
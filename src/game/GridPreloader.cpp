@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "GridPreloader.h"
+#include "Player.h"
+#include "WaypointMovementGenerator.h"
+
+// speed of taxi flights, see FlightPathMovementGenerator::_Reset
+#define GRID_PRELOAD_TAXI_SPEED 32.0f
+
+GridPreloader::GridPreloader() : m_preloadedGrids(0)
+{
+    m_predictTimer.SetInterval(GRID_PRELOAD_PREDICT_INTERVAL);
+}
+
+bool GridPreloader::UpdatePredictTimer(uint32 diff)
+{
+    m_predictTimer.Update(diff);
+    if (!m_predictTimer.Passed())
+        return false;
+
+    m_predictTimer.SetCurrent(0);
+    return true;
+}
+
+static void AddGridAt(float x, float y, std::vector<GridPair>& grids)
+{
+    Hellground::NormalizeMapCoord(x);
+    Hellground::NormalizeMapCoord(y);
+
+    GridPair p = Hellground::ComputeGridPair(x, y);
+    if (p.x_coord < MAX_NUMBER_OF_GRIDS && p.y_coord < MAX_NUMBER_OF_GRIDS)
+        grids.push_back(p);
+}
+
+void GridPreloader::PredictGrids(Player& player, uint32 lookAhead, std::vector<GridPair>& grids)
+{
+    float seconds = float(lookAhead) / IN_MILISECONDS;
+
+    if (player.IsTaxiFlying())
+    {
+        if (player.GetMotionMaster()->GetCurrentMovementGeneratorType() != FLIGHT_MOTION_TYPE)
+            return;
+
+        FlightPathMovementGenerator* flight = (FlightPathMovementGenerator*)(player.GetMotionMaster()->top());
+        if (flight->HasArrived())
+            return;
+
+        TaxiPathNodeList const& path = flight->GetPath();
+        uint32 end = flight->GetPathAtMapEnd();
+
+        // nodes are few yards apart, checking each of them covers every grid on the way
+        float distLeft = GRID_PRELOAD_TAXI_SPEED * seconds;
+        float prevX = player.GetPositionX();
+        float prevY = player.GetPositionY();
+        for (uint32 i = flight->GetCurrentNode(); i < end && distLeft > 0.0f; ++i)
+        {
+            distLeft -= sqrt((path[i].x - prevX) * (path[i].x - prevX) + (path[i].y - prevY) * (path[i].y - prevY));
+            prevX = path[i].x;
+            prevY = path[i].y;
+
+            AddGridAt(prevX, prevY, grids);
+        }
+        return;
+    }
+
+    float angle = player.GetOrientation();
+    float speed;
+
+    if (player.HasUnitMovementFlag(MOVEFLAG_FORWARD))
+        speed = player.GetSpeed(player.IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+    else if (player.HasUnitMovementFlag(MOVEFLAG_BACKWARD))
+    {
+        speed = player.GetSpeed(player.IsFlying() ? MOVE_FLIGHT_BACK : MOVE_RUN_BACK);
+        angle += M_PI;
+    }
+    else
+        return;
+
+    // sample path twice per grid so no grid on the line is skipped
+    float dist = speed * seconds;
+    for (float step = SIZE_OF_GRIDS / 2; step <= dist + SIZE_OF_GRIDS / 2; step += SIZE_OF_GRIDS / 2)
+    {
+        float stepDist = std::min(step, dist);
+        AddGridAt(player.GetPositionX() + stepDist * cos(angle), player.GetPositionY() + stepDist * sin(angle), grids);
+    }
+}
+
+bool GridPreloader::AddGrid(GridPair const& p)
+{
+    for (PendingGrids::const_iterator itr = m_pending.begin(); itr != m_pending.end(); ++itr)
+    {
+        if (itr->gridX == p.x_coord && itr->gridY == p.y_coord)
+            return false;
+    }
+
+    if (m_pending.size() >= GRID_PRELOAD_MAX_PENDING)
+        return false;
+
+    m_pending.push_back(PreloadedGrid(p.x_coord, p.y_coord));
+    return true;
+}
+
+void GridPreloader::RemoveGrid(uint32 x, uint32 y)
+{
+    for (PendingGrids::iterator itr = m_pending.begin(); itr != m_pending.end(); ++itr)
+    {
+        if (itr->gridX == x && itr->gridY == y)
+        {
+            m_pending.erase(itr);
+            return;
+        }
+    }
+}
+
+uint32 GridPreloader::ClaimGrid(uint32 x, uint32 y)
+{
+    for (PendingGrids::iterator itr = m_pending.begin(); itr != m_pending.end(); ++itr)
+    {
+        if (itr->gridX == x && itr->gridY == y)
+        {
+            uint32 nextCell = itr->nextCell;
+            m_pending.erase(itr);
+            return nextCell;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_GRIDPRELOADER_H
+#define HELLGROUND_GRIDPRELOADER_H
+
+#include "Common.h"
+#include "Timer.h"
+#include "GridDefines.h"
+
+#include <list>
+
+class Player;
+
+// how often player paths are predicted (in milliseconds)
+#define GRID_PRELOAD_PREDICT_INTERVAL   1000
+// maximal number of grids waiting for preload on one map
+#define GRID_PRELOAD_MAX_PENDING        8
+
+#define GRID_PRELOAD_CELLS_PER_GRID     (MAX_NUMBER_OF_CELLS*MAX_NUMBER_OF_CELLS)
+
+struct PreloadedGrid
+{
+    PreloadedGrid(uint32 x, uint32 y) : gridX(x), gridY(y), nextCell(0) {}
+
+    uint32 gridX;
+    uint32 gridY;
+    uint32 nextCell;                                        // cells [0, nextCell) have their spawns loaded
+};
+
+/**
+ * GridPreloader - picks grids players are about to enter.
+ *
+ * Every GRID_PRELOAD_PREDICT_INTERVAL the owning map asks for grids on the path of each
+ * player: upcoming taxi nodes for flights, or straight line along facing for players
+ * moving on their own, both GridPreload.LookAhead ms ahead at current speed.
+ * Map then loads terrain of pending grids and materializes their spawns, a few of each
+ * per own update, so the grid is already loaded when player gets there.
+ *
+ * Used only by owning map thread.
+ */
+class GridPreloader
+{
+    public:
+        typedef std::list<PreloadedGrid> PendingGrids;
+
+        GridPreloader();
+
+        // returns true when paths should be predicted again
+        bool UpdatePredictTimer(uint32 diff);
+
+        // appends grids on predicted path of player, may contain duplicates
+        static void PredictGrids(Player& player, uint32 lookAhead, std::vector<GridPair>& grids);
+
+        bool AddGrid(GridPair const& p);
+        void RemoveGrid(uint32 x, uint32 y);
+
+        // grid is going to be loaded by someone else, returns first cell not loaded by preloader
+        uint32 ClaimGrid(uint32 x, uint32 y);
+
+        PendingGrids& GetPendingGrids() { return m_pending; }
+
+        uint32 GetPreloadedGridsCount() const { return m_preloadedGrids; }
+        void AddPreloadedGrid() { ++m_preloadedGrids; }
+
+    private:
+        PendingGrids m_pending;
+        ShortIntervalTimer m_predictTimer;
+        uint32 m_preloadedGrids;
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "GuidRangeAllocator.h"
+#include "World.h"
+#include "Log.h"
+#include "Timer.h"
+
+GuidRangeAllocator::GuidRangeAllocator(char const* name, uint32 maxGuid, uint32 rangeSize)
+    : m_name(name), m_maxGuid(maxGuid), m_rangeSize(rangeSize)
+{
+    m_next = 1;
+    m_epoch = 0;
+}
+
+void GuidRangeAllocator::Set(uint32 nextGuid)
+{
+    m_next = nextGuid;
+    ++m_epoch;
+}
+
+GuidRangeAllocator::ThreadRange& GuidRangeAllocator::GetThreadRange()
+{
+    ThreadRange* range = m_threadRange.ts_object();
+    if (!range)
+    {
+        range = new ThreadRange;
+        m_threadRange.ts_object(range);
+    }
+
+    return *range;
+}
+
+uint32 GuidRangeAllocator::Generate()
+{
+    ThreadRange& range = GetThreadRange();
+
+    uint32 epoch = m_epoch;
+    if (range.epoch != epoch)
+    {
+        range.next = range.end = 0;
+        range.released.clear();
+        range.epoch = epoch;
+    }
+
+    if (!range.released.empty() &&
+        WorldTimer::getMSTimeDiffToNow(range.released.front().releaseTime) >= range.released.front().reuseDelay)
+    {
+        uint32 guid = range.released.front().guid;
+        range.released.pop_front();
+        return guid;
+    }
+
+    if (range.next == range.end && !TakeRange(range))
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: %s guid overflow!! Can't continue, shutting down server. ", m_name);
+        World::StopNow(ERROR_EXIT_CODE);
+        return m_maxGuid;
+    }
+
+    return range.next++;
+}
+
+void GuidRangeAllocator::Release(uint32 guid, uint32 reuseDelay)
+{
+    if (!guid || !reuseDelay)
+        return;
+
+    ThreadRange& range = GetThreadRange();
+    if (range.epoch != m_epoch || range.released.size() >= GUID_RELEASED_PER_THREAD)
+        return;
+
+    range.released.push_back(ReleasedGuid(guid, WorldTimer::getMSTime(), reuseDelay));
+}
+
+bool GuidRangeAllocator::TakeRange(ThreadRange& range)
+{
+    uint64 start = m_next.fetch_and_add(m_rangeSize);
+    if (start > m_maxGuid)
+        return false;
+
+    // last range can be shorter
+    range.next = uint32(start);
+    range.end = uint32(std::min<uint64>(start + m_rangeSize, uint64(m_maxGuid) + 1));
+    return true;
+}
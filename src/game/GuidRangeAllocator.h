@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_GUIDRANGEALLOCATOR_H
+#define HELLGROUND_GUIDRANGEALLOCATOR_H
+
+#include "Common.h"
+
+#include <ace/TSS_T.h>
+#include <tbb/atomic.h>
+#include <deque>
+
+// released guids kept per thread, more are dropped and never reused
+#define GUID_RELEASED_PER_THREAD    4096
+
+/**
+ * GuidRangeAllocator - low guids of one high guid type, generated from any thread.
+ *
+ * Global counter only moves by whole ranges, each thread takes guids from its own range
+ * with plain increment, so map threads spawning objects at the same time don't share
+ * a counter. Guids left in ranges of exiting threads or at shutdown are never used.
+ *
+ * Guids of transient objects (dynamic objects, temporary summons) can be released when the
+ * object is deleted. They are reused by releasing thread only after given delay, so guids
+ * still remembered by scripts, auras or clients don't point to a new object right away.
+ */
+class GuidRangeAllocator
+{
+    public:
+        GuidRangeAllocator(char const* name, uint32 maxGuid, uint32 rangeSize);
+
+        // first guid to generate, ranges taken by threads before are dropped
+        void Set(uint32 nextGuid);
+        uint32 Generate();
+        void Release(uint32 guid, uint32 reuseDelay);
+
+    private:
+        struct ReleasedGuid
+        {
+            ReleasedGuid(uint32 g, uint32 t, uint32 d) : guid(g), releaseTime(t), reuseDelay(d) {}
+
+            uint32 guid;
+            uint32 releaseTime;
+            uint32 reuseDelay;
+        };
+
+        struct ThreadRange
+        {
+            ThreadRange() : next(0), end(0), epoch(0) {}
+
+            uint32 next;
+            uint32 end;                                     // past last guid of range
+            uint32 epoch;
+            std::deque<ReleasedGuid> released;
+        };
+
+        ThreadRange& GetThreadRange();
+        bool TakeRange(ThreadRange& range);
+
+        char const* m_name;
+        uint32 m_maxGuid;
+        uint32 m_rangeSize;
+
+        tbb::atomic<uint64> m_next;
+        tbb::atomic<uint32> m_epoch;
+
+        ACE_TSS<ThreadRange> m_threadRange;
+};
+
+#endif
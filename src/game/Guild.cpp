@@ -31,6 +31,7 @@
 #include "Util.h"
 #include "luaengine/HookMgr.h"
 #include "GuildMgr.h"
+#include "ChatFanout.h"
 
 Guild::Guild()
 {
@@ -161,6 +162,7 @@ bool Guild::AddMember(uint64 plGuid, uint32 plRank)
         pl->SetInGuild(Id);
         pl->SetRank(newmember.RankId);
         pl->SetGuildIdInvited(0);
+        AddOnlineMember(pl);
     }
 
     AddMemberToOrderList(newmember);
@@ -529,6 +531,7 @@ void Guild::DelMember(uint64 guid, bool isDisbanding)
 
     members.erase(GUID_LOPART(guid));
     DelMemberFromOrderList(GUID_LOPART(guid));
+    RemoveOnlineMember(GUID_LOPART(guid));
 
     Player *player = sObjectMgr.GetPlayer(guid);
     // If player not online data in data field will be loaded from guild tabs no need to update it !!
@@ -590,13 +593,15 @@ void Guild::BroadcastToGuild(WorldSession *session, const std::string& msg, uint
         WorldPacket data;
         ChatHandler(session).FillMessageData(&data, CHAT_MSG_GUILD, language, 0, msg.c_str());
 
-        for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
+        ChatFanoutMessage message(&data);
+        for (OnlineMemberList::const_iterator itr = m_onlineMembers.begin(); itr != m_onlineMembers.end(); ++itr)
         {
-            Player *pl = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER));
+            Player *pl = *itr;
 
-            if (pl && pl->GetSession() && HasRankRight(pl->GetRank(),GR_RIGHT_GCHATLISTEN) && !pl->GetSocial()->HasIgnore(session->GetPlayer()->GetGUIDLow()))
-                pl->SendPacketToSelf(&data);
+            if (pl->GetSession() && HasRankRight(pl->GetRank(),GR_RIGHT_GCHATLISTEN) && !pl->GetSocial()->HasIgnore(session->GetPlayer()->GetGUIDLow()))
+                message.AddRecipient(pl->GetSession());
         }
+        message.Send();
     }
 }
 
@@ -604,38 +609,55 @@ void Guild::BroadcastToOfficers(WorldSession *session, const std::string& msg, u
 {
     if (session && session->GetPlayer() && HasRankRight(session->GetPlayer()->GetRank(),GR_RIGHT_OFFCHATSPEAK))
     {
-        for (MemberList::iterator itr = members.begin(); itr != members.end(); ++itr)
-        {
-            WorldPacket data;
-            ChatHandler::FillMessageData(&data, session, CHAT_MSG_OFFICER, language, NULL, 0, msg.c_str(),NULL);
+        // same message for all officers, built once
+        WorldPacket data;
+        ChatHandler::FillMessageData(&data, session, CHAT_MSG_OFFICER, language, NULL, 0, msg.c_str(),NULL);
 
-            Player *pl = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER));
+        ChatFanoutMessage message(&data);
+        for (OnlineMemberList::const_iterator itr = m_onlineMembers.begin(); itr != m_onlineMembers.end(); ++itr)
+        {
+            Player *pl = *itr;
 
-            if (pl && pl->GetSession() && HasRankRight(pl->GetRank(),GR_RIGHT_OFFCHATLISTEN) && !pl->GetSocial()->HasIgnore(session->GetPlayer()->GetGUIDLow()))
-                pl->SendPacketToSelf(&data);
+            if (pl->GetSession() && HasRankRight(pl->GetRank(),GR_RIGHT_OFFCHATLISTEN) && !pl->GetSocial()->HasIgnore(session->GetPlayer()->GetGUIDLow()))
+                message.AddRecipient(pl->GetSession());
         }
+        message.Send();
     }
 }
 
 void Guild::BroadcastPacket(WorldPacket *packet)
 {
-    for (MemberList::iterator itr = members.begin(); itr != members.end(); ++itr)
+    ChatFanoutMessage message(packet);
+    for (OnlineMemberList::iterator itr = m_onlineMembers.begin(); itr != m_onlineMembers.end(); ++itr)
+        message.AddRecipient((*itr)->GetSession());
+    message.Send();
+}
+
+void Guild::BroadcastPacketToRank(WorldPacket *packet, uint32 rankId)
+{
+    for (OnlineMemberList::iterator itr = m_onlineMembers.begin(); itr != m_onlineMembers.end(); ++itr)
     {
-        Player *player = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER));
-        if (player)
-            player->SendPacketToSelf(packet);
+        if ((*itr)->GetRank() == rankId)
+            (*itr)->SendPacketToSelf(packet);
     }
 }
 
-void Guild::BroadcastPacketToRank(WorldPacket *packet, uint32 rankId)
+void Guild::AddOnlineMember(Player* player)
 {
-    for (MemberList::iterator itr = members.begin(); itr != members.end(); ++itr)
+    if (std::find(m_onlineMembers.begin(), m_onlineMembers.end(), player) == m_onlineMembers.end())
+        m_onlineMembers.push_back(player);
+}
+
+void Guild::RemoveOnlineMember(uint32 LowGuid)
+{
+    for (OnlineMemberList::iterator itr = m_onlineMembers.begin(); itr != m_onlineMembers.end(); ++itr)
     {
-        if (itr->second.RankId == rankId)
+        if ((*itr)->GetGUIDLow() == LowGuid)
         {
-            Player *player = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER));
-            if (player)
-                player->SendPacketToSelf(packet);
+            // order doesn't matter
+            *itr = m_onlineMembers.back();
+            m_onlineMembers.pop_back();
+            return;
         }
     }
 }
@@ -895,6 +917,7 @@ void Guild::UpdateLogoutTime(uint64 guid)
         return;
 
     itr->second.logout_time = time(NULL);
+    RemoveOnlineMember(GUID_LOPART(guid));
 
     if (m_onlinemembers > 0)
         --m_onlinemembers;
@@ -290,6 +290,7 @@ class Guild
         typedef std::map<uint32, MemberSlot> MemberList;
         typedef std::list<uint32> MemberGuidList;
         typedef std::vector<RankInfo> RankList;
+        typedef std::vector<Player*> OnlineMemberList;
 
         uint32 GetId(){ return Id; }
         const uint64& GetLeader(){ return leaderGuid; }
@@ -337,10 +338,9 @@ class Guild
         template<class Do>
         void BroadcastWorker(Do& _do, Player* except = NULL)
         {
-            for(MemberList::iterator itr = members.begin(); itr != members.end(); ++itr)
-                if(Player *player = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER)))
-                    if(player != except)
-                        _do(player);
+            for (OnlineMemberList::iterator itr = m_onlineMembers.begin(); itr != m_onlineMembers.end(); ++itr)
+                if (*itr != except)
+                    _do(*itr);
         }
 
         void CreateRank(std::string name,uint32 rights);
@@ -413,6 +413,9 @@ class Guild
         void   LoadGuildBankFromDB();
         void   UnloadGuildBank();
         void   IncOnlineMemberCount() { ++m_onlinemembers; }
+        // members in game, broadcasts don't look up every member; kept on login/logout and join/leave of online player
+        void   AddOnlineMember(Player* player);
+        void   RemoveOnlineMember(uint32 LowGuid);
         // Money deposit/withdraw
         void   SendMoneyInfo(WorldSession *session, uint32 LowGuid);
         bool   MemberMoneyWithdraw(uint32 amount, uint32 LowGuid);
@@ -478,6 +481,7 @@ class Guild
         bool m_bankloaded;
         bool m_eventlogloaded;
         uint32 m_onlinemembers;
+        OnlineMemberList m_onlineMembers;
         uint64 guildbank_money;
         uint8 purchased_tabs;
 
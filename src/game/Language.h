@@ -917,7 +917,8 @@ enum HellgroundStrings
     LANG_ANTICHEAT_NOFALLDMG            = 11014,
     LANG_GM_BANNED_PLAYER               = 11015,
     LANG_POSSIBLE_CHEAT                 = 11016,
-    LANG_INSTA_KILL_GUARDIAN            = 11017
+    LANG_INSTA_KILL_GUARDIAN            = 11017,
+    LANG_CHANNEL_RATE_LIMITED           = 11018
 
     // NOT RESERVED IDS                   12000-1999999999
     // `db_script_string` table index     2000000000-2000009999 (MIN_DB_SCRIPT_STRING_ID-MAX_DB_SCRIPT_STRING_ID)
@@ -998,11 +998,12 @@ bool ChatHandler::HandleInfoCommand(const char* args)
 
     PSendSysMessage("*ground Z: %f", terrain->GetHeight(_player->GetPositionX(), _player->GetPositionY(), MAX_HEIGHT));
     PSendSysMessage("*floor Z: %f", terrain->GetHeight(_player->GetPositionX(), _player->GetPositionY(), _player->GetPositionZ()));
-    PSendSysMessage("*los: %s", terrain->IsLineOfSightEnabled() ? "enabled" : "disabled");
-    PSendSysMessage("*mmaps: %s", terrain->IsPathFindingEnabled() ? "enabled" : "disabled");
+    PSendSysMessage("*los: %s", _player->GetMap()->IsLineOfSightEnabled() ? "enabled" : "disabled");
+    PSendSysMessage("*mmaps: %s", _player->GetMap()->IsPathFindingEnabled() ? "enabled" : "disabled");
     PSendSysMessage("*outdoors: %s", terrain->IsOutdoors(_player->GetPositionX(), _player->GetPositionY(), _player->GetPositionZ()) ? "yes" : "no");
-    PSendSysMessage("*visibility: %f", terrain->GetSpecifics()->visibility);
-    PSendSysMessage("*ainotify: %u", terrain->GetSpecifics()->ainotifyperiod);
+    PSendSysMessage("*visibility: %f", _player->GetMap()->GetVisibilityDistance());
+    PSendSysMessage("*ainotify: %u", _player->GetMap()->GetAINotifyPeriod());
+    PSendSysMessage("*load: %s", _player->GetMap()->GetLoadGovernor().GetStateName().c_str());
     PSendSysMessage("*viewupdateafter: %f", sqrt(float(terrain->GetSpecifics()->viewupdatedistance)));
     return true;
 }
@@ -35,6 +35,7 @@
 #include "Guild.h"
 #include "ObjectAccessor.h"
 #include "MapManager.h"
+#include "ObjectPool.h"
 #include "SpellAuras.h"
 #include "ScriptMgr.h"
 #include "Language.h"
@@ -56,6 +57,14 @@
 #include "ChannelMgr.h"
 #include "luaengine/HookMgr.h"
 #include "GuildMgr.h"
+#include "ChatFanout.h"
+#include "PacketCapture.h"
+#include "PacketReplay.h"
+#include "VMapFactory.h"
+#include "WorldModel.h"
+#include "movement/MoveSpline.h"
+#include "movement/MoveSplineBatch.h"
+#include "movement/MoveSplineInitArgs.h"
 
 bool ChatHandler::HandleReloadAutobroadcastCommand(const char*)
 {
@@ -4835,6 +4844,429 @@ bool ChatHandler::HandleServerMuteCommand(const char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerPacketStatsCommand(const char* /*args*/)
+{
+    uint64 allocated = sRecvPathStats.packetsAllocated;
+    uint64 reused = sRecvPathStats.packetsReused;
+    uint64 latencyCount = sRecvPathStats.latencyCount;
+    uint64 latencySum = sRecvPathStats.latencySum;
+
+    PSendSysMessage("Receive buffers: " UI64FMTD " allocated, " UI64FMTD " reused (%.1f%%)",
+        allocated, reused, allocated + reused ? reused * 100.0f / (allocated + reused) : 0.0f);
+    PSendSysMessage("Session queue overflows: " UI64FMTD, uint64(sRecvPathStats.packetsOverflowed));
+    PSendSysMessage("Queue latency: " UI64FMTD " packets, avg %.2f ms, max %u ms",
+        latencyCount, latencyCount ? float(latencySum) / latencyCount : 0.0f, uint32(sRecvPathStats.latencyMax));
+    return true;
+}
+
+bool ChatHandler::HandleServerChatFanoutCommand(const char* /*args*/)
+{
+    ChatFanoutStats& stats = sChatFanout.GetStats();
+    uint64 messages = stats.messages;
+
+    PSendSysMessage("Chat delivery thread: %s, queue %u messages / %u recipients, peak %u recipients",
+        sChatFanout.IsActive() ? "running" : "stopped", uint32(stats.queuedMessages), uint32(stats.queuedRecipients), uint32(stats.peakRecipients));
+    PSendSysMessage("Delivered: " UI64FMTD " messages, avg %.1f recipients, max delay %u ms",
+        messages, messages ? float(stats.recipients) / messages : 0.0f, uint32(stats.delayMax));
+    PSendSysMessage("Sent by caller: " UI64FMTD " messages, queued behind fanout to keep order: " UI64FMTD " packets, channel rate limited: " UI64FMTD,
+        uint64(stats.inlineMessages), uint64(stats.orderedPackets), uint64(stats.rateLimited));
+
+    // peaks are per report
+    stats.peakRecipients = stats.queuedRecipients;
+    stats.delayMax = 0;
+    return true;
+}
+
+bool ChatHandler::HandleServerCaptureCommand(const char* /*args*/)
+{
+    if (!sPacketCapture.IsActive())
+    {
+        SendSysMessage("Packet capture is not running.");
+        return true;
+    }
+
+    PSendSysMessage("Packet capture to %s: " UI64FMTD " packets, " UI64FMTD " bytes",
+        sPacketCapture.GetFileName().c_str(), sPacketCapture.GetRecords(), sPacketCapture.GetBytes());
+    return true;
+}
+
+bool ChatHandler::HandleServerCaptureStartCommand(const char* args)
+{
+    // <file> [account <id> | map <id>]
+    char* file = strtok((char*)args, " ");
+    char* filter = strtok(NULL, " ");
+    char* id = strtok(NULL, " ");
+
+    if (!file)
+        return false;
+
+    PacketCaptureFilter captureFilter = PACKET_CAPTURE_ALL;
+    if (filter)
+    {
+        if (!id)
+            return false;
+
+        if (strcmp(filter, "account") == 0)
+            captureFilter = PACKET_CAPTURE_ACCOUNT;
+        else if (strcmp(filter, "map") == 0)
+            captureFilter = PACKET_CAPTURE_MAP;
+        else
+            return false;
+    }
+
+    if (!sPacketCapture.Start(file, captureFilter, id ? atoi(id) : 0))
+    {
+        PSendSysMessage("Can't write packet capture to %s.", file);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Packet capture started to %s.", file);
+    return true;
+}
+
+bool ChatHandler::HandleServerCaptureStopCommand(const char* /*args*/)
+{
+    if (!sPacketCapture.IsActive())
+    {
+        SendSysMessage("Packet capture is not running.");
+        return true;
+    }
+
+    uint64 records = sPacketCapture.GetRecords();
+    sPacketCapture.Stop();
+    PSendSysMessage("Packet capture stopped, " UI64FMTD " packets written to %s.", records, sPacketCapture.GetFileName().c_str());
+    return true;
+}
+
+bool ChatHandler::HandleServerReplayCommand(const char* /*args*/)
+{
+    std::vector<std::string> lines;
+    sPacketReplay.BuildReport(lines);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        SendSysMessage(itr->c_str());
+    return true;
+}
+
+bool ChatHandler::HandleServerReplayStartCommand(const char* args)
+{
+    // <file> [speed]
+    char* file = strtok((char*)args, " ");
+    char* speed = strtok(NULL, " ");
+
+    if (!file)
+        return false;
+
+    if (!sPacketReplay.Start(file, speed ? atof(speed) : 1.0f, false))
+    {
+        PSendSysMessage("Can't replay %s, replay already running or file not readable.", file);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Replay of %s started.", file);
+    return true;
+}
+
+bool ChatHandler::HandleServerReplayStopCommand(const char* /*args*/)
+{
+    if (!sPacketReplay.IsRunning())
+    {
+        SendSysMessage("Packet replay is not running.");
+        return true;
+    }
+
+    sPacketReplay.Stop();
+    return HandleServerReplayCommand("");
+}
+
+bool ChatHandler::HandleServerMapLoadCommand(const char* args)
+{
+    // optional map id, otherwise maps with players or raised load level
+    int32 mapId = *args ? atoi(args) : -1;
+
+    uint32 count = 0;
+    MapManager::MapMapType const& maps = sMapMgr.Maps();
+    for (MapManager::MapMapType::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+    {
+        Map const* map = itr->second;
+        MapLoadGovernor const& governor = map->GetLoadGovernor();
+
+        if (mapId >= 0 ? map->GetId() != uint32(mapId) : !map->HavePlayers() && !governor.IsDegraded())
+            continue;
+
+        PSendSysMessage("Map %u instance %u: %s, update %.2f ms (visibility %.2f ms), players %u, calm intervals %u, preloaded grids %u",
+            map->GetId(), map->GetInstanceId(), governor.GetStateName().c_str(),
+            governor.GetAverageUpdateTime() / 1000.0f, governor.GetAverageVisibilityTime() / 1000.0f,
+            map->GetPlayersCountExceptGMs(), governor.GetCalmIntervals(), map->GetGridPreloader().GetPreloadedGridsCount());
+        PSendSysMessage("    movement relay: " UI64FMTD " packets sent, %.1f KB saved",
+            map->GetMovementPacketsSent(), map->GetMovementBytesSaved() / 1024.0f);
+        ++count;
+    }
+
+    PSendSysMessage("Listed %u maps, governor is %s.", count, sWorld.getConfig(CONFIG_MAPGOVERNOR_ENABLED) ? "enabled" : "disabled");
+    PSendSysMessage("Maps being unloaded: %u, prewarmed instance maps: %u", sMapMgr.GetUnloadingMapsCount(), sMapMgr.GetPrewarmedMapsCount());
+    return true;
+}
+
+bool ChatHandler::HandleServerLoSCacheCommand(const char* args)
+{
+    bool reset = *args && strncmp(args, "reset", strlen(args)) == 0;
+
+    LineOfSightCacheStats total;
+    MapManager::MapMapType const& maps = sMapMgr.Maps();
+    for (MapManager::MapMapType::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+    {
+        LineOfSightCache& cache = itr->second->GetLineOfSightCache();
+        if (reset)
+        {
+            cache.ResetStats();
+            continue;
+        }
+
+        LineOfSightCacheStats stats;
+        cache.GetStats(stats);
+        if (!stats.lookups)
+            continue;
+
+        PSendSysMessage("Map %u instance %u: " UI64FMTD " lookups, hit rate %.1f%%, " UI64FMTD " expired, " UI64FMTD " invalidated",
+            itr->second->GetId(), itr->second->GetInstanceId(), stats.lookups, stats.hits * 100.0f / stats.lookups, stats.expired, stats.invalidated);
+
+        total.lookups += stats.lookups;
+        total.hits += stats.hits;
+        total.expired += stats.expired;
+        total.invalidated += stats.invalidated;
+    }
+
+    if (reset)
+    {
+        SendSysMessage("Line of sight cache statistics reset.");
+        return true;
+    }
+
+    PSendSysMessage("Line of sight cache: TTL %u ms, quantum %.2f yd, " UI64FMTD " ray casts saved of " UI64FMTD " lookups (%.1f%%).",
+        sWorld.getConfig(CONFIG_VMAP_LOS_CACHE_TTL), sWorld.getConfig(RATE_VMAP_LOS_CACHE_QUANTUM), total.hits, total.lookups,
+        total.lookups ? total.hits * 100.0f / total.lookups : 0.0f);
+    return true;
+}
+
+bool ChatHandler::HandleServerMemoryCommand(const char* /*args*/)
+{
+    PSendSysMessage("Resident memory: %.1f MB, object pools are %s.", ObjectPoolMgr::GetResidentMemory() / 1048576.0f,
+        ObjectSlabPool::IsEnabled() ? "enabled" : "disabled");
+
+    ObjectSlabPool* pools[] = { &sObjectPoolMgr.GetCreaturePool(), &sObjectPoolMgr.GetGameObjectPool(), &sObjectPoolMgr.GetDynamicObjectPool() };
+    for (uint8 i = 0; i < 3; ++i)
+    {
+        ObjectPoolStats stats;
+        pools[i]->GetStats(stats);
+
+        // fragmentation: share of slab memory not holding live objects
+        PSendSysMessage("%s: %u thread shards, %u slabs (%.1f MB), %u/%u slots used, %u released, %u heap objects, fragmentation %.1f%%",
+            pools[i]->GetName(), stats.shards, stats.slabs, stats.bytes / 1048576.0f, stats.used, stats.slots, stats.released, stats.heapObjects,
+            stats.slots ? (stats.slots - stats.used + stats.released) * 100.0f / stats.slots : 0.0f);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerVMapBenchCommand(const char* args)
+{
+    uint32 count = *args ? atoi(args) : 20000;
+    if (!count || count > 1000000)
+        count = 20000;
+
+    Player* player = m_session->GetPlayer();
+    VMAP::IVMapManager* vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
+
+    // both passes cast the same random rays through vmap tiles loaded around player
+    std::vector<G3D::Vector3> points(count * 2);
+    for (uint32 i = 0; i < points.size(); ++i)
+        points[i] = G3D::Vector3(player->GetPositionX() + frand(-100.0f, 100.0f), player->GetPositionY() + frand(-100.0f, 100.0f),
+            player->GetPositionZ() + frand(-10.0f, 30.0f));
+
+    bool simd = VMAP::GroupModel::isSimdIntersectionEnabled();
+    uint32 blocked[2];
+    uint32 time[2];
+    for (uint8 mode = 0; mode < 2; ++mode)
+    {
+        VMAP::GroupModel::setSimdIntersection(mode == 1);
+        blocked[mode] = 0;
+
+        uint32 start = WorldTimer::getMSTime();
+        for (uint32 i = 0; i < count; ++i)
+        {
+            G3D::Vector3 const& from = points[2 * i];
+            G3D::Vector3 const& to = points[2 * i + 1];
+            if (!vMapManager->isInLineOfSight2(player->GetMapId(), from.x, from.y, from.z, to.x, to.y, to.z))
+                ++blocked[mode];
+        }
+        time[mode] = WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime());
+    }
+    VMAP::GroupModel::setSimdIntersection(simd);
+
+    PSendSysMessage("VMap benchmark on map %u: %u rays, %u blocked.", player->GetMapId(), count, blocked[1]);
+    PSendSysMessage("Scalar: %u ms (%.0f rays/s), SIMD: %u ms (%.0f rays/s).", time[0], time[0] ? count * 1000.0f / time[0] : 0.0f,
+        time[1], time[1] ? count * 1000.0f / time[1] : 0.0f);
+
+    if (blocked[0] != blocked[1])
+        PSendSysMessage("Scalar and SIMD results differ: %u rays blocked by scalar test.", blocked[0]);
+
+    return true;
+}
+
+bool ChatHandler::HandleServerSplineBenchCommand(const char* args)
+{
+    uint32 count = *args ? atoi(args) : 10000;
+    if (!count || count > 1000000)
+        count = 10000;
+
+    // random paths, half of them smooth like flying creatures
+    std::vector<Movement::MoveSpline> splines(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Movement::MoveSplineInitArgs init;
+        Movement::Vector3 point(frand(-100.0f, 100.0f), frand(-100.0f, 100.0f), frand(0.0f, 20.0f));
+        init.path.push_back(point);
+        for (uint32 n = urand(5, 10); n > 0; --n)
+        {
+            point += Movement::Vector3(frand(-20.0f, 20.0f), frand(-20.0f, 20.0f), frand(-2.0f, 2.0f));
+            init.path.push_back(point);
+        }
+        init.flags.flying = urand(0, 1);
+        init.velocity = frand(2.5f, 7.0f);
+        splines[i].Initialize(init);
+    }
+
+    enum { ROUNDS = 10, ROUND_DIFF = 100 };
+
+    Movement::MoveSplineBatch batch;
+    uint64 time[2] = { 0, 0 };
+    uint32 batched = 0;
+    float maxDiff = 0.0f;
+    std::vector<Movement::Location> scalar(count);
+    for (uint8 round = 0; round < ROUNDS; ++round)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            if (!splines[i].Finalized())
+                splines[i].updateState(ROUND_DIFF);
+
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+        for (uint32 i = 0; i < count; ++i)
+            scalar[i] = splines[i].ComputePosition();
+        time[0] += WorldTimer::getUSTimeDiff(start, ACE_OS::gettimeofday());
+
+        // finished splines are not batched, they are compared by index of batched ones only
+        std::vector<uint32> indexes;
+        start = ACE_OS::gettimeofday();
+        for (uint32 i = 0; i < count; ++i)
+            if (batch.Add(splines[i], i))
+                indexes.push_back(i);
+        batch.Evaluate();
+        time[1] += WorldTimer::getUSTimeDiff(start, ACE_OS::gettimeofday());
+
+        batched += batch.Size();
+        for (uint32 i = 0; i < batch.Size(); ++i)
+        {
+            Movement::Location loc = batch.GetLocation(i);
+            Movement::Location const& ref = scalar[indexes[i]];
+            maxDiff = std::max(maxDiff, (loc - ref).length());
+        }
+        batch.Clear();
+    }
+
+    PSendSysMessage("Spline benchmark: %u splines, %u rounds, %u positions batched.", count, uint32(ROUNDS), batched);
+    PSendSysMessage("ComputePosition: " UI64FMTD " us, batch: " UI64FMTD " us, max position difference: %f.", time[0], time[1], maxDiff);
+    return true;
+}
+
+bool ChatHandler::HandleServerTraceCommand(const char* args)
+{
+    char* mode = strtok((char*)args, " ");
+    char* value = strtok(NULL, " ");
+
+    if (!mode)
+    {
+        PSendSysMessage("Tick tracing is %s, dump threshold: %u ms.", sTickTracer.IsEnabled() ? "on" : "off", sTickTracer.GetDumpThreshold());
+        return true;
+    }
+
+    std::string argstr = mode;
+
+    if (argstr == "on" || argstr == "off")
+    {
+        sTickTracer.SetEnabled(argstr == "on");
+        PSendSysMessage("Tick tracing is %s.", argstr.c_str());
+        return true;
+    }
+
+    if (argstr == "threshold" && value)
+    {
+        sTickTracer.SetDumpThreshold(atoi(value));
+        PSendSysMessage("Trace will be dumped for ticks longer than %u ms.", sTickTracer.GetDumpThreshold());
+        return true;
+    }
+
+    if (argstr == "dump")
+    {
+        uint32 seconds = value ? atoi(value) : sTickTracer.GetDumpSeconds();
+        if (!seconds)
+            seconds = sTickTracer.GetDumpSeconds();
+
+        std::string fileName = sTickTracer.Dump(seconds);
+        if (fileName.empty())
+        {
+            SendSysMessage("Can't write trace file.");
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        PSendSysMessage("Trace of last %u seconds written to %s", seconds, fileName.c_str());
+        return true;
+    }
+
+    return false;
+}
+
+bool ChatHandler::HandleServerTickReportCommand(const char* args)
+{
+    if (*args && strncmp(args, "reset", strlen(args)) == 0)
+    {
+        sWorld.ResetTickPhaseStats();
+        SendSysMessage("Tick phase report reset.");
+        return true;
+    }
+
+    TickPhaseStats const& stats = sWorld.GetTickPhaseStats();
+    if (!stats.ticks)
+    {
+        SendSysMessage("No ticks recorded yet.");
+        return true;
+    }
+
+    float ticks = float(stats.ticks) * 1000.0f;
+    float parallel = stats.parallel / ticks;
+    float longest = stats.longestRequest / ticks;
+    float threadTime = parallel * sMapMgr.GetMapUpdater()->GetThreadCount();
+
+    PSendSysMessage("Average of %u ticks: serial before maps %.2f ms, parallel %.2f ms, serial after maps %.2f ms",
+        stats.ticks, stats.serialBefore / ticks, parallel, stats.serialAfter / ticks);
+    PSendSysMessage("Parallel phase: slowest request %.2f ms, threads busy %.2f of %.2f ms (%.1f%%)",
+        longest, stats.busy / ticks, threadTime, threadTime > 0.0f ? stats.busy / ticks * 100.0f / threadTime : 0.0f);
+    PSendSysMessage("Critical path: %.2f ms serial + %.2f ms slowest request, %.2f ms lost to queueing and imbalance",
+        (stats.serialBefore + stats.serialAfter) / ticks, longest, parallel > longest ? parallel - longest : 0.0f);
+
+    if (*stats.worstLongestName)
+        PSendSysMessage("Worst tick %.2f ms, slowest request task %s (%.2f ms)",
+            stats.worstTick / 1000.0f, stats.worstLongestName, stats.worstLongestTime / 1000.0f);
+    else
+        PSendSysMessage("Worst tick %.2f ms, slowest request map %u (%.2f ms)",
+            stats.worstTick / 1000.0f, stats.worstLongestMapId, stats.worstLongestTime / 1000.0f);
+
+    return true;
+}
+
 bool ChatHandler::HandleServerShutDownCancelCommand(const char* /*args*/)
 {
     sWorld.ShutdownCancel();
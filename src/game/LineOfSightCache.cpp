@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "LineOfSightCache.h"
+#include "World.h"
+#include "Timer.h"
+
+LineOfSightCache::Key::Key(float x1, float y1, float z1, float x2, float y2, float z2, float quantum)
+{
+    int32 a[3] = { int32(floor(x1 / quantum)), int32(floor(y1 / quantum)), int32(floor(z1 / quantum)) };
+    int32 b[3] = { int32(floor(x2 / quantum)), int32(floor(y2 / quantum)), int32(floor(z2 / quantum)) };
+
+    // line of sight goes both ways, lower endpoint first
+    bool swap = memcmp(a, b, sizeof(a)) > 0;
+    memcpy(coords, swap ? b : a, sizeof(a));
+    memcpy(coords + 3, swap ? a : b, sizeof(b));
+
+    hash = 2166136261u;
+    for (uint8 i = 0; i < 6; ++i)
+        hash = (hash ^ uint32(coords[i])) * 16777619u;
+}
+
+LineOfSightCache::LineOfSightCache() : m_entries(NULL)
+{
+}
+
+LineOfSightCache::~LineOfSightCache()
+{
+    delete[] m_entries;
+}
+
+bool LineOfSightCache::Find(Key const& key, uint32 generation, bool& result)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    ++m_stats.lookups;
+    if (!m_entries)
+        return false;
+
+    Entry& entry = m_entries[key.hash & (LOS_CACHE_SIZE - 1)];
+    if (!entry.used || !(entry.key == key))
+        return false;
+
+    if (entry.generation != generation)
+    {
+        ++m_stats.invalidated;
+        entry.used = false;
+        return false;
+    }
+
+    if (WorldTimer::getMSTimeDiffToNow(entry.insertTime) >= sWorld.getConfig(CONFIG_VMAP_LOS_CACHE_TTL))
+    {
+        ++m_stats.expired;
+        entry.used = false;
+        return false;
+    }
+
+    ++m_stats.hits;
+    result = entry.result;
+    return true;
+}
+
+void LineOfSightCache::Insert(Key const& key, uint32 generation, bool result)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_entries)
+        m_entries = new Entry[LOS_CACHE_SIZE]();
+
+    Entry& entry = m_entries[key.hash & (LOS_CACHE_SIZE - 1)];
+    entry.key = key;
+    entry.insertTime = WorldTimer::getMSTime();
+    entry.generation = generation;
+    entry.result = result;
+    entry.used = true;
+}
+
+void LineOfSightCache::GetStats(LineOfSightCacheStats& stats) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    stats = m_stats;
+}
+
+void LineOfSightCache::ResetStats()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_stats = LineOfSightCacheStats();
+}
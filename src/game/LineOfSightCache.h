@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_LINEOFSIGHTCACHE_H
+#define HELLGROUND_LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+
+#include <ace/Thread_Mutex.h>
+
+// entries of one map cache, power of two
+#define LOS_CACHE_SIZE 2048
+
+struct LineOfSightCacheStats
+{
+    LineOfSightCacheStats() : lookups(0), hits(0), expired(0), invalidated(0) {}
+
+    uint64 lookups;
+    uint64 hits;                                            // ray casts saved
+    uint64 expired;                                         // entry found, but older than TTL
+    uint64 invalidated;                                     // entry found, but vmap tiles changed since
+};
+
+/**
+ * LineOfSightCache - recent vmap line of sight results of one map instance.
+ *
+ * Endpoints are quantized to vmap.losCache.Quantum yards and ordered, so a creature checking
+ * its victim every AI tick and the victim casting back at it share one entry. Entries live
+ * vmap.losCache.TTL ms and are dropped when terrain loads or unloads vmap tiles the segment
+ * can cross (tile generations of TerrainInfo change); gameobjects don't block line of sight here.
+ *
+ * Direct mapped, colliding pair just replaces older one. Table is allocated on first insert.
+ */
+class LineOfSightCache
+{
+    public:
+        struct Key
+        {
+            Key() : hash(0) {}
+            Key(float x1, float y1, float z1, float x2, float y2, float z2, float quantum);
+
+            bool operator==(Key const& other) const { return memcmp(coords, other.coords, sizeof(coords)) == 0; }
+
+            int32 coords[6];
+            uint32 hash;
+        };
+
+        LineOfSightCache();
+        ~LineOfSightCache();
+
+        bool Find(Key const& key, uint32 generation, bool& result);
+        void Insert(Key const& key, uint32 generation, bool result);
+
+        void GetStats(LineOfSightCacheStats& stats) const;
+        void ResetStats();
+
+    private:
+        struct Entry
+        {
+            Key key;
+            uint32 insertTime;
+            uint32 generation;
+            bool result;
+            bool used;
+        };
+
+        mutable ACE_Thread_Mutex m_lock;
+        Entry* m_entries;
+        LineOfSightCacheStats m_stats;
+};
+
+#endif
@@ -43,6 +43,7 @@
 #include "InstanceSaveMgr.h"
 #include "VMapFactory.h"
 #include "MoveMap.h"
+#include "movement/MoveSplineBatch.h"
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
@@ -70,6 +71,8 @@ Map::~Map()
     //release reference count
     if (m_TerrainData->Release())
         sTerrainMgr.UnloadTerrain(m_TerrainData->GetMapId());
+
+    delete m_splineBatch;
 }
 
 void Map::LoadMapAndVMap(int gx,int gy)
@@ -101,7 +104,8 @@ void Map::DeleteStateMachine()
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
    : i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_scriptLock(true)
+     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_scriptLock(true), m_visibilityUpdateTick(0),
+     m_movementPacketsSent(0), m_movementBytesSaved(0), m_splineBatch(new Movement::MoveSplineBatch)
 {
     for (unsigned int j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
     {
@@ -327,8 +331,12 @@ bool Map::EnsureGridLoaded(const Cell &cell)
     {
         sLog.outDebug("Loading grid[%u,%u] for map %u instance %u", cell.GridX(), cell.GridY(), GetId(), i_InstanceId);
 
+        // grid may be partially loaded ahead of players, finish only its remaining cells
         ObjectGridLoader loader(*grid, this, cell);
-        loader.LoadN();
+        if (uint32 firstCell = m_gridPreloader.ClaimGrid(cell.GridX(), cell.GridY()))
+            loader.LoadCells(firstCell, GRID_PRELOAD_CELLS_PER_GRID - firstCell);
+        else
+            loader.LoadN();
 
         // Add resurrectable corpses to world object list in grid
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(),cell.GridY()),(*grid)(cell.CellX(), cell.CellY()), this);
@@ -432,6 +440,15 @@ void Map::BroadcastPacketExcept(WorldObject* sender, WorldPacket* msg, Player* e
     Cell::VisitWorldObjects(sender, post_man, GetVisibilityDistance());
 }
 
+void Map::BroadcastMovementExcept(WorldObject* sender, WorldPacket* msg, Player* except, Player* controller, uint32 heartbeat)
+{
+    Hellground::MovementBroadcaster post_man(*sender, msg, except, controller, heartbeat);
+    Cell::VisitWorldObjects(sender, post_man, GetVisibilityDistance());
+
+    m_movementPacketsSent += post_man.i_sent;
+    m_movementBytesSaved += uint64(post_man.i_skipped) * msg->size();
+}
+
 bool Map::loaded(const GridPair &p) const
 {
     if (NGridType* grid_type = getNGrid(p.x_coord, p.y_coord))
@@ -447,6 +464,11 @@ void Map::Update(const uint32 &t_diff)
     
     MAP_UPDATE_DIFF(DiffRecorder diff("", 0))
 
+    TraceZone traceUpdate("Map::Update", GetId());
+    TraceMarker trace(GetId());
+
+    ACE_Time_Value updateStart = ACE_OS::gettimeofday();
+
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -460,6 +482,7 @@ void Map::Update(const uint32 &t_diff)
     }
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_SESSION_UPDATE, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::UpdateSessions");
 
     /// update players at tick
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -473,6 +496,7 @@ void Map::Update(const uint32 &t_diff)
     }
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_PLAYER_UPDATE, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::UpdatePlayers");
 
     resetMarkedCells();
 
@@ -486,6 +510,7 @@ void Map::Update(const uint32 &t_diff)
     TypeContainerVisitor<Hellground::ObjectUpdater, WorldTypeMapContainer> world_object_update(updater);
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_PET_UPDATE, diff.RecordTimeFor(""), GetId()))
+    trace.Reset();
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
@@ -521,6 +546,7 @@ void Map::Update(const uint32 &t_diff)
     }
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_PLAYER_GRID_VISIT, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::UpdatePlayerGrids");
 
     // non-player active objects
     if (!m_activeNonPlayers.empty())
@@ -561,11 +587,13 @@ void Map::Update(const uint32 &t_diff)
     }
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_ACTIVEUNIT_GRID_VISIT, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::UpdateActiveObjectGrids");
 
     // Send world objects and item update field changes
     SendObjectUpdates();
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_SEND_OBJECTS_UPDATE, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::SendObjectUpdates");
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
@@ -576,10 +604,163 @@ void Map::Update(const uint32 &t_diff)
     }
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_PROCESS_SCRIPTS, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::ScriptsProcess");
 
+    RelocateBatchedSplines();
     MoveAllCreaturesInMoveList();
 
     MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_MOVE_CREATURES_IN_LIST, diff.RecordTimeFor(""), GetId()))
+    trace.Mark("Map::MoveAllCreaturesInMoveList");
+
+    UpdateGridPreload(t_diff);
+    trace.Mark("Map::UpdateGridPreload");
+
+    ACE_Time_Value visibilityStart = ACE_OS::gettimeofday();
+
+    uint32 visibilityUpdates = ProcessVisibilityUpdates();
+
+    MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateDiffFor(DIFF_VISIBILITY_UPDATE, diff.RecordTimeFor(""), GetId()))
+    MAP_UPDATE_DIFF(sWorld.MapUpdateDiff().CumulateCountFor(COUNT_VISIBILITY_UPDATES, visibilityUpdates, GetId()))
+    trace.Mark("Map::ProcessVisibilityUpdates");
+
+    ACE_Time_Value updateEnd = ACE_OS::gettimeofday();
+    m_loadGovernor.AddUpdateSample(t_diff, WorldTimer::getUSTimeDiff(updateStart, updateEnd), WorldTimer::getUSTimeDiff(visibilityStart, updateEnd));
+}
+
+void Map::ScheduleVisibilityUpdate(Unit* unit)
+{
+    if (unit->IsVisibilityUpdateScheduled())
+        return;
+
+    unit->_SetVisibilityUpdateScheduled(true);
+    i_visibilityUpdateQueue.push_back(unit->GetGUID());
+}
+
+uint32 Map::ProcessVisibilityUpdates()
+{
+    uint32 budget = sWorld.getConfig(CONFIG_VISIBILITY_UPDATE_MAX_PER_TICK);
+    uint32 farBandInterval = sWorld.getConfig(CONFIG_VISIBILITY_FAR_BAND_INTERVAL);
+    bool nearBandOnly = farBandInterval > 1 && sWorld.getConfig(CONFIG_VISIBILITY_NEAR_BAND_PCT) < 100;
+    uint32 processed = 0;
+
+    ++m_visibilityUpdateTick;
+
+    // units that moved since their last whole distance update, far band is refreshed only every few updates
+    if (!nearBandOnly || m_visibilityUpdateTick % farBandInterval == 0)
+    {
+        for (std::set<uint64>::iterator itr = i_farBandUpdatePending.begin(); itr != i_farBandUpdatePending.end() && (!budget || processed < budget);)
+        {
+            Unit* unit = GetUnit(*itr);
+            i_farBandUpdatePending.erase(itr++);
+
+            if (!unit || !unit->IsInWorld() || unit->GetMap() != this)
+                continue;
+
+            // whole distance update covers near band too, so queued one can be skipped
+            unit->_SetVisibilityUpdateScheduled(false);
+            unit->UpdateVisibilityAndView();
+            ++processed;
+        }
+    }
+
+    // updates over budget wait for next map update, oldest first
+    while (!i_visibilityUpdateQueue.empty() && (!budget || processed < budget))
+    {
+        Unit* unit = GetUnit(i_visibilityUpdateQueue.front());
+        i_visibilityUpdateQueue.pop_front();
+
+        if (!unit || !unit->IsVisibilityUpdateScheduled() || !unit->IsInWorld() || unit->GetMap() != this)
+            continue;
+
+        unit->_SetVisibilityUpdateScheduled(false);
+
+        if (nearBandOnly)
+        {
+            unit->UpdateVisibilityAndViewNearBand();
+            i_farBandUpdatePending.insert(unit->GetGUID());
+        }
+        else
+            unit->UpdateVisibilityAndView();
+
+        ++processed;
+    }
+
+    return processed;
+}
+
+void Map::UpdateGridPreload(uint32 diff)
+{
+    // continents only, instances are small enough to be loaded at once
+    if (!sWorld.getConfig(CONFIG_GRID_PRELOAD_ENABLED) || Instanceable())
+        return;
+
+    if (m_gridPreloader.UpdatePredictTimer(diff))
+    {
+        std::vector<GridPair> grids;
+        for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+        {
+            Player* plr = itr->getSource();
+            if (plr && plr->IsInWorld())
+                GridPreloader::PredictGrids(*plr, sWorld.getConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD), grids);
+        }
+
+        for (std::vector<GridPair>::const_iterator itr = grids.begin(); itr != grids.end(); ++itr)
+        {
+            if (!loaded(*itr))
+                m_gridPreloader.AddGrid(*itr);
+        }
+    }
+
+    uint32 cellBudget = sWorld.getConfig(CONFIG_GRID_PRELOAD_CELLS_PER_TICK);
+    uint32 terrainBudget = sWorld.getConfig(CONFIG_GRID_PRELOAD_TERRAIN_PER_TICK);
+
+    GridPreloader::PendingGrids& pending = m_gridPreloader.GetPendingGrids();
+    for (GridPreloader::PendingGrids::iterator itr = pending.begin(); itr != pending.end() && cellBudget;)
+    {
+        NGridType* grid = getNGrid(itr->gridX, itr->gridY);
+        if (!grid)
+        {
+            // map, vmap and mmap tiles are loaded here by owning map thread, the only one querying them
+            if (!terrainBudget)
+            {
+                ++itr;
+                continue;
+            }
+
+            --terrainBudget;
+            EnsureGridCreated(GridPair(itr->gridX, itr->gridY));
+            grid = getNGrid(itr->gridX, itr->gridY);
+        }
+        else if (isGridObjectDataLoaded(itr->gridX, itr->gridY))
+        {
+            pending.erase(itr++);
+            continue;
+        }
+
+        uint32 count = std::min(cellBudget, GRID_PRELOAD_CELLS_PER_GRID - itr->nextCell);
+
+        Cell cell(CellPair(itr->gridX * MAX_NUMBER_OF_CELLS, itr->gridY * MAX_NUMBER_OF_CELLS));
+        ObjectGridLoader loader(*grid, this, cell);
+        loader.LoadCells(itr->nextCell, count);
+
+        itr->nextCell += count;
+        cellBudget -= count;
+
+        if (itr->nextCell < GRID_PRELOAD_CELLS_PER_GRID)
+        {
+            ++itr;
+            continue;
+        }
+
+        sObjectAccessor.AddCorpsesToGrid(GridPair(itr->gridX, itr->gridY), (*grid)(cell.CellX(), cell.CellY()), this);
+        setGridObjectDataLoaded(true, itr->gridX, itr->gridY);
+
+        // keep it until player arrives
+        ResetGridExpiry(*grid);
+
+        m_gridPreloader.AddPreloadedGrid();
+        pending.erase(itr++);
+    }
 }
 
 void Map::CheckHostileRefFor(Player* plr)
@@ -749,6 +930,31 @@ void Map::AddCreatureToMoveList(Creature *c, float x, float y, float z, float an
     i_creaturesToMove[c] = CreatureMover(x,y,z,ang);
 }
 
+void Map::RelocateBatchedSplines()
+{
+    if (m_splineBatch->Empty())
+        return;
+
+    m_splineBatch->Evaluate();
+
+    // cell changes land in creature move list, moved right after
+    for (uint32 i = 0; i < m_splineBatch->Size(); ++i)
+    {
+        // creature could leave map or start new movement since its update
+        Creature* creature = GetCreatureOrPet(m_splineBatch->GetGuid(i));
+        if (!creature || !creature->IsInWorld() || creature->GetMap() != this)
+            continue;
+
+        if (creature->movespline->Finalized() || creature->movespline->GetId() != m_splineBatch->GetSplineId(i))
+            continue;
+
+        Movement::Location loc = m_splineBatch->GetLocation(i);
+        creature->Unit::SetPosition(loc.x, loc.y, loc.z, loc.orientation);
+    }
+
+    m_splineBatch->Clear();
+}
+
 void Map::MoveAllCreaturesInMoveList()
 {
     while (!i_creaturesToMove.empty())
@@ -849,6 +1055,9 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool unloadAll)
 
         sLog.outDebug("Unloading grid[%u,%u] for map %u", x,y, i_id);
 
+        // partially preloaded grid starts from scratch next time
+        m_gridPreloader.RemoveGrid(x, y);
+
         ObjectGridUnloader unloader(*grid);
 
         if (!unloadAll)
@@ -904,6 +1113,23 @@ void Map::UnloadAll()
     }
 }
 
+bool Map::UnloadGrids(uint32 limit)
+{
+    i_creaturesToMove.clear();
+
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
+    {
+        NGridType &grid(*i->getSource());
+        ++i;
+        UnloadGrid(grid.getX(), grid.getY(), true);
+
+        if (limit && !--limit)
+            break;
+    }
+
+    return GridRefManager<NGridType>::isEmpty();
+}
+
 bool Map::CheckGridIntegrity(Creature* c, bool moved) const
 {
     Cell const& cur_cell = c->GetCurrentCell();
@@ -3074,7 +3300,7 @@ float Map::GetVisibilityDistance(WorldObject* obj, Player* invoker) const
     if (m_TerrainData == nullptr)
         return DEFAULT_VISIBILITY_DISTANCE;
 
-    float dist = m_TerrainData->GetVisibilityDistance();
+    float dist = m_TerrainData->GetVisibilityDistance() - m_loadGovernor.GetVisibilityPenalty();
     if (obj != nullptr)
     {
         if (obj->GetObjectGuid().IsGameObject())
@@ -3086,6 +3312,90 @@ float Map::GetVisibilityDistance(WorldObject* obj, Player* invoker) const
     return dist;
 }
 
+bool Map::IsLineOfSightEnabled() const
+{
+    return m_TerrainData->IsLineOfSightEnabled(m_loadGovernor.GetLevel());
+}
+
+bool Map::IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2)
+{
+    VMAP::IVMapManager* vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
+    if (!sWorld.getConfig(CONFIG_VMAP_LOS_CACHE_TTL))
+        return vMapManager->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2);
+
+    LineOfSightCache::Key key(x1, y1, z1, x2, y2, z2, sWorld.getConfig(RATE_VMAP_LOS_CACHE_QUANTUM));
+    // taken before the ray cast, result computed while tile was loading gets invalidated
+    uint32 generation = m_TerrainData->GetVMapGeneration(x1, y1, x2, y2);
+
+    bool result;
+    if (m_losCache.Find(key, generation, result))
+        return result;
+
+    result = vMapManager->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2);
+    m_losCache.Insert(key, generation, result);
+    return result;
+}
+
+void Map::IsInLineOfSight(float x, float y, float z, std::vector<G3D::Vector3> const& targets, std::vector<bool>& results)
+{
+    VMAP::IVMapManager* vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
+    if (!sWorld.getConfig(CONFIG_VMAP_LOS_CACHE_TTL))
+    {
+        vMapManager->isInLineOfSight(GetId(), x, y, z, targets, results);
+        return;
+    }
+
+    float quantum = sWorld.getConfig(RATE_VMAP_LOS_CACHE_QUANTUM);
+    results.assign(targets.size(), true);
+
+    std::vector<uint32> missed;
+    std::vector<uint32> missedGenerations;
+    std::vector<LineOfSightCache::Key> missedKeys;
+    std::vector<G3D::Vector3> missedTargets;
+    for (uint32 i = 0; i < targets.size(); ++i)
+    {
+        LineOfSightCache::Key key(targets[i].x, targets[i].y, targets[i].z, x, y, z, quantum);
+        uint32 generation = m_TerrainData->GetVMapGeneration(targets[i].x, targets[i].y, x, y);
+
+        bool result;
+        if (m_losCache.Find(key, generation, result))
+            results[i] = result;
+        else
+        {
+            missed.push_back(i);
+            missedGenerations.push_back(generation);
+            missedKeys.push_back(key);
+            missedTargets.push_back(targets[i]);
+        }
+    }
+
+    if (missed.empty())
+        return;
+
+    std::vector<bool> missedResults;
+    vMapManager->isInLineOfSight(GetId(), x, y, z, missedTargets, missedResults);
+    for (uint32 i = 0; i < missed.size(); ++i)
+    {
+        results[missed[i]] = missedResults[i];
+        m_losCache.Insert(missedKeys[i], missedGenerations[i], missedResults[i]);
+    }
+}
+
+bool Map::IsPathFindingEnabled() const
+{
+    return m_TerrainData->IsPathFindingEnabled(m_loadGovernor.GetLevel());
+}
+
+uint32 Map::GetAINotifyPeriod() const
+{
+    return m_TerrainData->GetSpecifics()->ainotifyperiod * m_loadGovernor.GetAINotifyFactor();
+}
+
+float Map::GetVisibilityNearBandDistance() const
+{
+    return GetVisibilityDistance() * sWorld.getConfig(CONFIG_VISIBILITY_NEAR_BAND_PCT) / 100.0f;
+}
+
 bool Map::WaypointMovementAutoActive() const
 {
     if(Instanceable())
@@ -3143,7 +3453,7 @@ bool Map::GetEntrancePos( int32 &mapid, float &x, float &y )
     return true;
 }
 
-void Map::UpdateHelper::Update( DelayedMapList& delayedUpdate )
+void Map::UpdateHelper::Update(DelayedMapList& delayedUpdate)
 {
     sMapMgr.GetMapUpdater()->schedule_update(*m_map, GetTimeElapsed());
     delayedUpdate.push_back(std::make_pair(m_map, uint32(GetTimeElapsed())));
@@ -3153,7 +3463,7 @@ void Map::UpdateHelper::Update( DelayedMapList& delayedUpdate )
 
 bool Map::UpdateHelper::ProcessUpdate() const
 {
-    return GetTimeElapsed() >= sWorld.getConfig(CONFIG_INTERVAL_MAPUPDATE);
+    return GetTimeElapsed() >= sWorld.getConfig(CONFIG_INTERVAL_MAPUPDATE) * m_map->GetLoadGovernor().GetUpdateIntervalFactor();
 }
 
 time_t Map::UpdateHelper::GetTimeElapsed() const
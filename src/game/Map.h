@@ -33,11 +33,16 @@
 #include "GridMap.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
+#include "UnitIndex.h"
+#include "MapLoadGovernor.h"
+#include "GridPreloader.h"
+#include "LineOfSightCache.h"
 #include "mersennetwister/MersenneTwister.h"
 
 #include <tbb/concurrent_hash_map.h>
 
 #include <bitset>
+#include <deque>
 #include <list>
 
 class Unit;
@@ -55,6 +60,16 @@ class BattleGround;
 class GridMap;
 class TerrainInfo;
 
+namespace G3D
+{
+    class Vector3;
+}
+
+namespace Movement
+{
+    class MoveSplineBatch;
+}
+
 struct ScriptInfo;
 struct ScriptAction;
 
@@ -167,18 +182,27 @@ class HELLGROUND_IMPORT_EXPORT Map : public GridRefManager<NGridType>
         void BroadcastPacket(WorldObject*, WorldPacket*, bool = false);
         void BroadcastPacketInRange(WorldObject*, WorldPacket*, float, bool = false, bool = false);
         void BroadcastPacketExcept(WorldObject*, WorldPacket*, Player*);
+        // heartbeat is sequence number of relayed MSG_MOVE_HEARTBEAT, 0 for other movement packets
+        void BroadcastMovementExcept(WorldObject* sender, WorldPacket* msg, Player* except, Player* controller, uint32 heartbeat);
 
         virtual void InitVisibilityDistance();
 
         float GetVisibilityDistance(WorldObject* = NULL, Player* = NULL) const;
+        float GetVisibilityNearBandDistance() const;
         float GetActiveObjectUpdateDistance() const { return m_ActiveObjectUpdateDistance; }
 
         void PlayerRelocation(Player*, float, float, float, float);
         void CreatureRelocation(Creature*, float, float, float, float);
 
+        // relocation triggered visibility updates are coalesced and done once per map update
+        void ScheduleVisibilityUpdate(Unit* unit);
+
         template<class T, class CONTAINER>
         void Visit(const Cell &cell, TypeContainerVisitor<T, CONTAINER> &visitor);
 
+        MapUnitIndex& GetUnitIndex() { return m_unitIndex; }
+        MapUnitIndex const& GetUnitIndex() const { return m_unitIndex; }
+
         bool IsRemovalGrid(float x, float y) const;
         bool IsLoaded(float x, float y) const;
 
@@ -187,6 +211,9 @@ class HELLGROUND_IMPORT_EXPORT Map : public GridRefManager<NGridType>
 
         virtual void UnloadAll();
 
+        // unloads at most limit grids (0 - all) of map no longer registered in MapManager, returns true when no grid is left
+        bool UnloadGrids(uint32 limit);
+
         void ResetGridExpiry(NGridType &grid, float factor = 1) const;
 
         time_t GetGridExpiry(void) const { return i_gridExpiry; }
@@ -200,6 +227,10 @@ class HELLGROUND_IMPORT_EXPORT Map : public GridRefManager<NGridType>
         void MoveAllCreaturesInMoveList();
         void RemoveAllObjectsInRemoveList();
 
+        // periodic spline positions of creatures, evaluated together after object updates
+        Movement::MoveSplineBatch& GetMoveSplineBatch() { return *m_splineBatch; }
+        void RelocateBatchedSplines();
+
         bool CreatureRespawnRelocation(Creature *c);        // used only in MoveAllCreaturesInMoveList and ObjectGridUnloader
 
         // assert print helper
@@ -281,6 +312,22 @@ class HELLGROUND_IMPORT_EXPORT Map : public GridRefManager<NGridType>
         //get corresponding TerrainData object for this particular map
         const TerrainInfo * GetTerrain() const { return m_TerrainData; }
 
+        // terrain features adjusted by current load of this map
+        MapLoadGovernor const& GetLoadGovernor() const { return m_loadGovernor; }
+        GridPreloader const& GetGridPreloader() const { return m_gridPreloader; }
+
+        uint64 GetMovementPacketsSent() const { return m_movementPacketsSent; }
+        uint64 GetMovementBytesSaved() const { return m_movementBytesSaved; }
+        bool IsLineOfSightEnabled() const;
+
+        // vmap line of sight through cache of recent results of this map
+        bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2);
+        // rays from each of targets to (x,y,z), only pairs missing in cache go to vmaps, in one batch
+        void IsInLineOfSight(float x, float y, float z, std::vector<G3D::Vector3> const& targets, std::vector<bool>& results);
+        LineOfSightCache& GetLineOfSightCache() { return m_losCache; }
+        bool IsPathFindingEnabled() const;
+        uint32 GetAINotifyPeriod() const;
+
         bool WaypointMovementAutoActive() const;
         bool WaypointMovementPathfinding() const;
 
@@ -322,10 +369,29 @@ class HELLGROUND_IMPORT_EXPORT Map : public GridRefManager<NGridType>
 
         void CheckHostileRefFor(Player*);
         void SendObjectUpdates();
+        uint32 ProcessVisibilityUpdates();
+        void UpdateGridPreload(uint32 diff);
 
         typedef std::set<Object*> ObjectSet;
         ObjectSet i_objectsToClientUpdate;
 
+        std::deque<uint64> i_visibilityUpdateQueue;
+        std::set<uint64> i_farBandUpdatePending;
+        uint32 m_visibilityUpdateTick;
+
+        MapUnitIndex m_unitIndex;
+
+        MapLoadGovernor m_loadGovernor;
+        GridPreloader m_gridPreloader;
+
+        // movement relay, updated by map thread
+        uint64 m_movementPacketsSent;
+        uint64 m_movementBytesSaved;
+
+        LineOfSightCache m_losCache;
+
+        Movement::MoveSplineBatch* m_splineBatch;
+
         GObjectMapType                  gameObjectsMap;
         DObjectMapType                  dynamicObjectsMap;
         CreaturesMapType                creaturesMap;
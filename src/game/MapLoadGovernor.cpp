@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "MapLoadGovernor.h"
+#include "World.h"
+
+MapLoadGovernor::MapLoadGovernor() : m_level(MAP_LOAD_NORMAL), m_flags(MAP_LOAD_FLAG_NONE), m_updateTimeSum(0), m_visibilityTimeSum(0), m_sampleCount(0),
+    m_avgUpdateTime(0), m_avgVisibilityTime(0), m_calmIntervals(0), m_evaluateTimer(sWorld.getConfig(CONFIG_MAPGOVERNOR_INTERVAL))
+{
+}
+
+void MapLoadGovernor::AddUpdateSample(uint32 diff, uint32 updateTime, uint32 visibilityTime)
+{
+    m_updateTimeSum += updateTime;
+    m_visibilityTimeSum += visibilityTime;
+    ++m_sampleCount;
+
+    m_evaluateTimer.Update(diff);
+    if (!m_evaluateTimer.Passed())
+        return;
+
+    Evaluate();
+
+    m_updateTimeSum = 0;
+    m_visibilityTimeSum = 0;
+    m_sampleCount = 0;
+    m_evaluateTimer.Reset(sWorld.getConfig(CONFIG_MAPGOVERNOR_INTERVAL));
+}
+
+void MapLoadGovernor::Evaluate()
+{
+    if (!m_sampleCount)
+        return;
+
+    m_avgUpdateTime = m_updateTimeSum / m_sampleCount;
+    m_avgVisibilityTime = m_visibilityTimeSum / m_sampleCount;
+
+    if (!sWorld.getConfig(CONFIG_MAPGOVERNOR_ENABLED))
+    {
+        m_level = MAP_LOAD_NORMAL;
+        m_flags = MAP_LOAD_FLAG_NONE;
+        m_calmIntervals = 0;
+        return;
+    }
+
+    uint32 maxUpdateTime = sWorld.getConfig(CONFIG_MAPGOVERNOR_MAX_UPDATE_TIME) * IN_MILISECONDS;
+
+    if (m_avgUpdateTime > maxUpdateTime)
+    {
+        m_calmIntervals = 0;
+        Degrade();
+        return;
+    }
+
+    if (!IsDegraded())
+        return;
+
+    if (m_avgUpdateTime * 100 >= maxUpdateTime * sWorld.getConfig(CONFIG_MAPGOVERNOR_RECOVER_PCT))
+    {
+        m_calmIntervals = 0;
+        return;
+    }
+
+    if (++m_calmIntervals < sWorld.getConfig(CONFIG_MAPGOVERNOR_RECOVER_INTERVALS))
+        return;
+
+    m_calmIntervals = 0;
+    Recover();
+}
+
+void MapLoadGovernor::Degrade()
+{
+    bool visibilityStep = sWorld.getConfig(CONFIG_MAPGOVERNOR_STEP_VISIBILITY) && !HasFlag(MAP_LOAD_FLAG_VISIBILITY);
+
+    // disabling los/pathfinding won't help when most of the time goes to visibility updates
+    if (visibilityStep && m_avgVisibilityTime * 2 >= m_avgUpdateTime)
+    {
+        m_flags |= MAP_LOAD_FLAG_VISIBILITY;
+        return;
+    }
+
+    if (sWorld.getConfig(CONFIG_MAPGOVERNOR_STEP_FEATURES) && m_level < MAP_LOAD_DISABLE_HIGH_PRIORITY)
+    {
+        m_level = MapLoadLevel(m_level + 1);
+        return;
+    }
+
+    if (visibilityStep)
+    {
+        m_flags |= MAP_LOAD_FLAG_VISIBILITY;
+        return;
+    }
+
+    if (sWorld.getConfig(CONFIG_MAPGOVERNOR_STEP_AI_NOTIFY) && !HasFlag(MAP_LOAD_FLAG_SLOW_AI_NOTIFY))
+    {
+        m_flags |= MAP_LOAD_FLAG_SLOW_AI_NOTIFY;
+        return;
+    }
+
+    if (sWorld.getConfig(CONFIG_MAPGOVERNOR_STEP_UPDATE_INTERVAL))
+        m_flags |= MAP_LOAD_FLAG_SLOW_UPDATES;
+}
+
+void MapLoadGovernor::Recover()
+{
+    // reverse order of Degrade, cheapest to give back first
+    if (HasFlag(MAP_LOAD_FLAG_SLOW_UPDATES))
+        m_flags &= ~MAP_LOAD_FLAG_SLOW_UPDATES;
+    else if (HasFlag(MAP_LOAD_FLAG_SLOW_AI_NOTIFY))
+        m_flags &= ~MAP_LOAD_FLAG_SLOW_AI_NOTIFY;
+    else if (m_level != MAP_LOAD_NORMAL)
+        m_level = MapLoadLevel(m_level - 1);
+    else
+        m_flags &= ~MAP_LOAD_FLAG_VISIBILITY;
+}
+
+float MapLoadGovernor::GetVisibilityPenalty() const
+{
+    if (!HasFlag(MAP_LOAD_FLAG_VISIBILITY))
+        return 0.0f;
+
+    return float(sWorld.getConfig(CONFIG_MAPGOVERNOR_VISIBILITY_PENALTY));
+}
+
+std::string MapLoadGovernor::GetStateName() const
+{
+    std::string name = GetLevelName(m_level);
+
+    if (HasFlag(MAP_LOAD_FLAG_VISIBILITY))
+        name += ", visibility penalty";
+
+    if (HasFlag(MAP_LOAD_FLAG_SLOW_AI_NOTIFY))
+        name += ", slow ai notify";
+
+    if (HasFlag(MAP_LOAD_FLAG_SLOW_UPDATES))
+        name += ", slow updates";
+
+    return name;
+}
+
+char const* MapLoadGovernor::GetLevelName(MapLoadLevel level)
+{
+    switch (level)
+    {
+        case MAP_LOAD_NORMAL:                   return "normal";
+        case MAP_LOAD_DISABLE_LOW_PRIORITY:     return "low priority features disabled";
+        case MAP_LOAD_DISABLE_MID_PRIORITY:     return "mid priority features disabled";
+        case MAP_LOAD_DISABLE_HIGH_PRIORITY:    return "high priority features disabled";
+        default:                                return "unknown";
+    }
+}
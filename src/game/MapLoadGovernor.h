@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_MAPLOADGOVERNOR_H
+#define HELLGROUND_MAPLOADGOVERNOR_H
+
+#include "Common.h"
+#include "Timer.h"
+
+// features with map_template priority up to current level are disabled
+enum MapLoadLevel
+{
+    MAP_LOAD_NORMAL                 = 0,
+    MAP_LOAD_DISABLE_LOW_PRIORITY   = 1,
+    MAP_LOAD_DISABLE_MID_PRIORITY   = 2,
+    MAP_LOAD_DISABLE_HIGH_PRIORITY  = 3,
+
+    MAP_LOAD_MAX
+};
+
+// degradation steps independent of feature level, each one can be turned off in config
+enum MapLoadFlags
+{
+    MAP_LOAD_FLAG_NONE              = 0x00,
+    MAP_LOAD_FLAG_VISIBILITY        = 0x01,                 // visibility distance reduced by MapGovernor.VisibilityPenalty
+    MAP_LOAD_FLAG_SLOW_AI_NOTIFY    = 0x02,                 // doubled ai notify period
+    MAP_LOAD_FLAG_SLOW_UPDATES      = 0x04,                 // doubled map update interval
+};
+
+/**
+ * MapLoadGovernor - per map feedback loop replacing global core balancer.
+ *
+ * Map::Update reports its own duration (and time spent in visibility updates) after every
+ * update. Each MapGovernor.Interval average is compared with MapGovernor.MaxUpdateTime and
+ * overloaded map takes one more degradation step: visibility penalty first when visibility
+ * dominates the update (feature level is left alone then), otherwise next feature level,
+ * visibility penalty, slow ai notify and slow updates in that order, skipping steps disabled
+ * by MapGovernor.Step.*. Steps are taken back in reverse order only after
+ * MapGovernor.RecoverIntervals calm intervals in row, so state doesn't flap around the limit.
+ *
+ * Only owning map thread writes the state, other threads just read it.
+ */
+class MapLoadGovernor
+{
+    public:
+        MapLoadGovernor();
+
+        // times in microseconds, diff is map update diff in milliseconds
+        void AddUpdateSample(uint32 diff, uint32 updateTime, uint32 visibilityTime);
+
+        MapLoadLevel GetLevel() const { return m_level; }
+        uint32 GetFlags() const { return m_flags; }
+        bool HasFlag(MapLoadFlags flag) const { return m_flags & flag; }
+        bool IsDegraded() const { return m_level != MAP_LOAD_NORMAL || m_flags != MAP_LOAD_FLAG_NONE; }
+
+        float GetVisibilityPenalty() const;
+        uint32 GetAINotifyFactor() const { return HasFlag(MAP_LOAD_FLAG_SLOW_AI_NOTIFY) ? 2 : 1; }
+        uint32 GetUpdateIntervalFactor() const { return HasFlag(MAP_LOAD_FLAG_SLOW_UPDATES) ? 2 : 1; }
+
+        uint32 GetAverageUpdateTime() const { return m_avgUpdateTime; }
+        uint32 GetAverageVisibilityTime() const { return m_avgVisibilityTime; }
+        uint32 GetCalmIntervals() const { return m_calmIntervals; }
+
+        std::string GetStateName() const;
+        static char const* GetLevelName(MapLoadLevel level);
+
+    private:
+        void Evaluate();
+        void Degrade();
+        void Recover();
+
+        MapLoadLevel m_level;
+        uint32 m_flags;
+
+        uint64 m_updateTimeSum;
+        uint64 m_visibilityTimeSum;
+        uint32 m_sampleCount;
+
+        uint32 m_avgUpdateTime;
+        uint32 m_avgVisibilityTime;
+        uint32 m_calmIntervals;
+
+        TimeTrackerSmall m_evaluateTimer;
+};
+
+#endif
@@ -36,6 +36,9 @@
 
 MapManager::MapManager() : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_INTERVAL_GRIDCLEAN))
 {
+    // first refresh soon after startup, so configured maps are warm early
+    i_prewarmTimer.SetInterval(MAP_PREWARM_REFRESH_INTERVAL);
+    i_prewarmTimer.SetCurrent(MAP_PREWARM_REFRESH_INTERVAL);
 }
 
 MapManager::~MapManager()
@@ -43,6 +46,9 @@ MapManager::~MapManager()
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
+    for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end(); ++iter)
+        delete *iter;
+
     for (TransportSet::iterator i = m_Transports.begin(); i != m_Transports.end(); ++i)
         delete *i;
 
@@ -218,56 +224,247 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
         if (pMap->Instanceable())
         {
             i_maps.erase(iter);
+            DetachMap(pMap);
+        }
+    }
+}
+
+void MapManager::DetachMap(Map* map)
+{
+    // players must be teleported out by the world thread, unload such map right away
+    if (map->HavePlayers())
+    {
+        map->UnloadAll();
+        delete map;
+        return;
+    }
+
+    i_unloadingMaps.push_back(map);
+}
+
+void MapManager::DeleteUnloadedMaps()
+{
+    // maps are not updated now, instance specific global data (respawn times) can be removed safely
+    for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end();)
+    {
+        Map* map = *iter;
 
-            pMap->UnloadAll();
-            delete pMap;
+        // still has grids, some were unloaded at end of last tick
+        if (!map->isEmpty())
+        {
+            ++iter;
+            continue;
         }
+
+        map->UnloadAll();
+        delete map;
+        iter = i_unloadingMaps.erase(iter);
+    }
+}
+
+void MapManager::UnloadDetachedMaps()
+{
+    // grid unload removes objects from ObjectAccessor and saves respawns, maps must not be updated now
+    uint32 gridLimit = sWorld.getConfig(CONFIG_INSTANCE_UNLOAD_GRIDS_PER_TICK);
+
+    for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end(); ++iter)
+        (*iter)->UnloadGrids(gridLimit);
+}
+
+void MapManager::FinishMapUnload(uint32 mapId, uint32 instanceId)
+{
+    // new map of same instance must not load respawn times before old one saved them
+    for (MapList::iterator iter = i_unloadingMaps.begin(); iter != i_unloadingMaps.end(); ++iter)
+    {
+        Map* map = *iter;
+        if (map->GetId() != mapId || map->GetInstanceId() != instanceId)
+            continue;
+
+        map->UnloadAll();
+        delete map;
+        i_unloadingMaps.erase(iter);
+        return;
     }
 }
 
-typedef std::list<std::pair<Map*, uint32> > DelayedMapList;
-void MapManager::Update(uint32 diff)
+void MapManager::UpdatePrewarmedMaps()
+{
+    uint32 popularCount = sWorld.getConfig(CONFIG_INSTANCE_PREWARM_POPULAR);
+    std::set<uint32> wanted = sWorld.GetPrewarmMapIds();
+
+    std::vector<std::pair<uint32, uint32> > popular;
+    for (std::map<uint32, uint32>::iterator itr = i_instanceCreations.begin(); itr != i_instanceCreations.end();)
+    {
+        if (itr->second)
+            popular.push_back(std::make_pair(itr->second, itr->first));
+
+        // older creations count less on each refresh
+        itr->second /= 2;
+        if (!itr->second)
+            i_instanceCreations.erase(itr++);
+        else
+            ++itr;
+    }
+
+    std::sort(popular.begin(), popular.end(), std::greater<std::pair<uint32, uint32> >());
+    for (uint32 i = 0; i < popular.size() && i < popularCount; ++i)
+        wanted.insert(popular[i].second);
+
+    for (PrewarmedMapMap::iterator itr = i_prewarmedMaps.begin(); itr != i_prewarmedMaps.end();)
+    {
+        uint32 mapId = itr->first;
+        ++itr;
+
+        if (wanted.find(mapId) == wanted.end())
+            ReleasePrewarmedMap(mapId);
+    }
+
+    for (std::set<uint32>::const_iterator itr = wanted.begin(); itr != wanted.end(); ++itr)
+    {
+        if (i_prewarmedMaps.find(*itr) == i_prewarmedMaps.end())
+            PrewarmMap(*itr);
+    }
+}
+
+void MapManager::PrewarmMap(uint32 mapId)
+{
+    MapEntry const* entry = sMapStore.LookupEntry(mapId);
+    if (!entry || !entry->IsDungeon())
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: MapManager::PrewarmMap: map %u is not a dungeon, not prewarmed.", mapId);
+        return;
+    }
+
+    PrewarmedMap& prewarmed = i_prewarmedMaps[mapId];
+    prewarmed.terrain = sTerrainMgr.LoadTerrain(mapId);
+    prewarmed.terrain->AddRef();
+
+    std::set<std::pair<uint32, uint32> > grids;
+    for (uint8 spawnMode = DIFFICULTY_NORMAL; spawnMode <= DIFFICULTY_HEROIC; ++spawnMode)
+    {
+        CellObjectGuidsMap const& cells = sObjectMgr.GetMapObjectGuids(mapId, spawnMode);
+        for (CellObjectGuidsMap::const_iterator itr = cells.begin(); itr != cells.end(); ++itr)
+        {
+            if (itr->second.creatures.empty() && itr->second.gameobjects.empty())
+                continue;
+
+            uint32 gridX = (itr->first % TOTAL_NUMBER_OF_CELLS_PER_MAP) / MAX_NUMBER_OF_CELLS;
+            uint32 gridY = (itr->first / TOTAL_NUMBER_OF_CELLS_PER_MAP) / MAX_NUMBER_OF_CELLS;
+
+            // terrain files use reversed grid coords
+            grids.insert(std::make_pair((MAX_NUMBER_OF_GRIDS - 1) - gridX, (MAX_NUMBER_OF_GRIDS - 1) - gridY));
+        }
+    }
+
+    prewarmed.grids.assign(grids.begin(), grids.end());
+
+    sLog.outDetail("MapManager: prewarming map %u, %u grids", mapId, uint32(prewarmed.grids.size()));
+}
+
+void MapManager::ReleasePrewarmedMap(uint32 mapId)
+{
+    PrewarmedMapMap::iterator itr = i_prewarmedMaps.find(mapId);
+    if (itr == i_prewarmedMaps.end())
+        return;
+
+    PrewarmedMap& prewarmed = itr->second;
+    for (uint32 i = 0; i < prewarmed.loadedGrids; ++i)
+        prewarmed.terrain->ReleasePreloadedGrid(prewarmed.grids[i].first, prewarmed.grids[i].second);
+
+    if (prewarmed.terrain->Release())
+        sTerrainMgr.UnloadTerrain(mapId);
+
+    i_prewarmedMaps.erase(itr);
+
+    sLog.outDetail("MapManager: map %u is not prewarmed anymore", mapId);
+}
+
+void MapManager::LoadPrewarmedGrids()
+{
+    uint32 gridLimit = sWorld.getConfig(CONFIG_INSTANCE_PREWARM_GRIDS_PER_TICK);
+
+    for (PrewarmedMapMap::iterator itr = i_prewarmedMaps.begin(); itr != i_prewarmedMaps.end() && gridLimit; ++itr)
+    {
+        PrewarmedMap& prewarmed = itr->second;
+        for (; prewarmed.loadedGrids < prewarmed.grids.size() && gridLimit; ++prewarmed.loadedGrids, --gridLimit)
+            prewarmed.terrain->PreloadGrid(prewarmed.grids[prewarmed.loadedGrids].first, prewarmed.grids[prewarmed.loadedGrids].second);
+    }
+}
+
+static void LoadPrewarmedGridsTask(uint32 /*diff*/)
+{
+    sMapMgr.LoadPrewarmedGrids();
+}
+
+void MapManager::StartUpdate(uint32 diff)
 {
     DiffRecorder diffRecorder(__FUNCTION__, sWorld.getConfig(CONFIG_MIN_LOG_UPDATE));
 
-    DelayedMapList delayedUpdate;
+    m_updater.start_tick();
+
+    DeleteUnloadedMaps();
+
+    i_prewarmTimer.Update(diff);
+    if (i_prewarmTimer.Passed())
+    {
+        i_prewarmTimer.Reset();
+        UpdatePrewarmedMaps();
+    }
+
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end();)
     {
         if (iter->second->CanUnload(diff))
         {
-            iter->second->UnloadAll();
-            delete iter->second;
-
+            DetachMap(iter->second);
             i_maps.erase(iter++);
         }
         else
         {
             Map::UpdateHelper helper(iter->second);
             if (helper.ProcessUpdate())
-                helper.Update(delayedUpdate);
+                helper.Update(i_delayedUpdate);
 
             ++iter;
         }
     }
 
+    diffRecorder.RecordTimeFor("ScheduleMaps");
+
+    // terrain prewarm goes after map updates, it is not on critical path
+    bool prewarmPending = false;
+    for (PrewarmedMapMap::const_iterator itr = i_prewarmedMaps.begin(); itr != i_prewarmedMaps.end() && !prewarmPending; ++itr)
+        prewarmPending = itr->second.loadedGrids < itr->second.grids.size();
+
+    if (prewarmPending)
+        m_updater.schedule_global("LoadPrewarmedGrids", &LoadPrewarmedGridsTask, diff);
+}
+
+void MapManager::FinishUpdate(uint32 diff)
+{
+    DiffRecorder diffRecorder(__FUNCTION__, sWorld.getConfig(CONFIG_MIN_LOG_UPDATE));
+
     m_updater.wait();
 
     diffRecorder.RecordTimeFor("UpdateMaps");
 
-    for (DelayedMapList::iterator iter = delayedUpdate.begin(); iter != delayedUpdate.end(); ++iter)
+    for (DelayedMapList::iterator iter = i_delayedUpdate.begin(); iter != i_delayedUpdate.end(); ++iter)
         iter->first->DelayedUpdate(iter->second);
 
-    delayedUpdate.clear();
+    i_delayedUpdate.clear();
 
     diffRecorder.RecordTimeFor("Delayed update");
 
+    UnloadDetachedMaps();
+
+    diffRecorder.RecordTimeFor("UnloadDetachedMaps");
+
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
         WorldObject::UpdateHelper helper(*iter);
         helper.Update(diff);
     }
 
-     diffRecorder.RecordTimeFor("UpdateTransports");
+    diffRecorder.RecordTimeFor("UpdateTransports");
 }
 
 bool MapManager::ExistMapAndVMap(uint32 mapid, float x,float y)
@@ -288,6 +485,18 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    while (!i_prewarmedMaps.empty())
+        ReleasePrewarmedMap(i_prewarmedMaps.begin()->first);
+
+    while (!i_unloadingMaps.empty())
+    {
+        Map *temp = i_unloadingMaps.front();
+        i_unloadingMaps.pop_front();
+
+        temp->UnloadAll();
+        delete temp;
+    }
+
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll();
 
@@ -369,7 +578,10 @@ Map* MapManager::CreateInstance(uint32 id, Player * player)
         map = FindMap(id, NewInstanceId);
         // it is possible that the save exists but the map doesn't
         if (!map)
+        {
+            FinishMapUnload(id, NewInstanceId);
             pNewMap = CreateInstanceMap(id, NewInstanceId, DungeonDifficulties(pSave->GetDifficulty()), pSave);
+        }
     }
     else
     {
@@ -416,6 +628,8 @@ InstanceMap* MapManager::CreateInstanceMap(uint32 id, uint32 InstanceId, Dungeon
     InstanceMap *map = new InstanceMap(id, i_gridCleanUpDelay, InstanceId, difficulty);
     ASSERT(map->IsDungeon());
 
+    ++i_instanceCreations[id];
+
     bool load_data = save != NULL;
     map->CreateInstanceData(load_data);
 
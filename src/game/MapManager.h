@@ -30,6 +30,9 @@
 #include "GridStates.h"
 #include "MapUpdater.h"
 
+// how often popular instance maps are recounted and prewarmed
+#define MAP_PREWARM_REFRESH_INTERVAL (5*MINUTE*IN_MILISECONDS)
+
 class Transport;
 
 struct MapID
@@ -65,7 +68,11 @@ class MapManager
         void DeleteInstance(uint32 mapid, uint32 instanceId);
 
         void Initialize(void);
-        void Update(uint32 diff);
+
+        // map updates run on MapUpdater threads between these two calls,
+        // world thread may schedule global tasks on the same threads meanwhile
+        void StartUpdate(uint32 diff);
+        void FinishUpdate(uint32 diff);
 
         void SetGridCleanUpDelay(uint32 t)
         {
@@ -141,6 +148,12 @@ class MapManager
         //get list of all maps
         const MapMapType& Maps() const { return i_maps; }
 
+        uint32 GetUnloadingMapsCount() const { return i_unloadingMaps.size(); }
+        uint32 GetPrewarmedMapsCount() const { return i_prewarmedMaps.size(); }
+
+        // called on map update thread, loads few grids of prewarmed maps
+        void LoadPrewarmedGrids();
+
     private:
         GridState* i_GridStates[MAX_GRID_STATE];            // shadow entries to the global array in Map.cpp
 
@@ -155,9 +168,42 @@ class MapManager
         InstanceMap* CreateInstanceMap(uint32 id, uint32 InstanceId, DungeonDifficulties difficulty, InstanceSave *save = NULL);
         BattleGroundMap* CreateBattleGroundMap(uint32 id, uint32 InstanceId, BattleGround* bg);
 
+        // maps removed from i_maps have their grids unloaded on map update threads, few grids per tick
+        void DetachMap(Map* map);
+        void DeleteUnloadedMaps();
+        void UnloadDetachedMaps();
+        void FinishMapUnload(uint32 mapId, uint32 instanceId);
+
+        // popular instance maps keep terrain, vmap and mmap tiles under their spawns loaded between instances
+        void UpdatePrewarmedMaps();
+        void PrewarmMap(uint32 mapId);
+        void ReleasePrewarmedMap(uint32 mapId);
+
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
 
+        // maps updated this tick, their remove lists and grids are processed after all map updates finish
+        DelayedMapList i_delayedUpdate;
+
+        typedef std::list<Map*> MapList;
+        MapList i_unloadingMaps;
+
+        struct PrewarmedMap
+        {
+            PrewarmedMap() : terrain(NULL), loadedGrids(0) {}
+
+            TerrainInfo* terrain;
+            std::vector<std::pair<uint32, uint32> > grids;  // terrain grid coords with static spawns
+            uint32 loadedGrids;
+        };
+
+        typedef std::map<uint32, PrewarmedMap> PrewarmedMapMap;
+        PrewarmedMapMap i_prewarmedMaps;
+
+        // instance maps created since last prewarm refresh, halved on each refresh
+        std::map<uint32, uint32> i_instanceCreations;
+        IntervalTimer i_prewarmTimer;
+
         MapUpdater m_updater;
         uint32 i_MaxInstanceId;
 
@@ -68,6 +68,7 @@ class MapUpdateRequest : public ACE_Method_Request
 
         virtual int call(void)
         {
+            ACE_Time_Value start = ACE_OS::gettimeofday();
             m_updater.register_thread(ACE_OS::thr_self(), m_map.GetId(), m_map.GetInstanceId());
 
             if (!m_map.IsBroken())
@@ -76,12 +77,36 @@ class MapUpdateRequest : public ACE_Method_Request
                 m_map.ForcedUnload();
 
             m_updater.unregister_thread(ACE_OS::thr_self());
-            m_updater.update_finished();
+            m_updater.update_finished(WorldTimer::getUSTimeDiff(start, ACE_OS::gettimeofday()), m_map.GetId(), NULL);
             return 0;
         }
 };
 
-MapUpdater::MapUpdater() : m_mutex(), m_condition(m_mutex), m_executor(), pending_requests(0)
+class GlobalUpdateRequest : public ACE_Method_Request
+{
+    public:
+        char const* m_name;
+        GlobalUpdateTask m_task;
+        MapUpdater& m_updater;
+        ACE_UINT32 m_diff;
+
+        GlobalUpdateRequest(char const* n, GlobalUpdateTask t, MapUpdater& u, ACE_UINT32 d) : m_name(n), m_task(t), m_updater(u), m_diff(d) {}
+
+        virtual int call(void)
+        {
+            ACE_Time_Value start = ACE_OS::gettimeofday();
+
+            {
+                TraceZone zone(m_name);
+                m_task(m_diff);
+            }
+
+            m_updater.update_finished(WorldTimer::getUSTimeDiff(start, ACE_OS::gettimeofday()), 0, m_name);
+            return 0;
+        }
+};
+
+MapUpdater::MapUpdater() : m_mutex(), m_condition(m_mutex), m_executor(), pending_requests(0), m_threadCount(0)
 {
     freezeDetectTime = sWorld.getConfig(CONFIG_VMSS_FREEZEDETECTTIME);
 }
@@ -93,6 +118,7 @@ MapUpdater::~MapUpdater()
 
 int MapUpdater::activate(size_t num_threads)
 {
+    m_threadCount = num_threads;
     return this->m_executor.activate(static_cast<int>(num_threads), new WDBThreadStartReq1, new WDBThreadEndReq1);
 }
 
@@ -110,18 +136,33 @@ int MapUpdater::wait()
     while (this->pending_requests > 0)
         this->m_condition.wait();
 
+    if (m_tickStart != ACE_Time_Value::zero)
+    {
+        m_tickStats.wallTime = WorldTimer::getUSTimeDiff(m_tickStart, ACE_OS::gettimeofday());
+        m_lastTickStats = m_tickStats;
+        m_tickStart = ACE_Time_Value::zero;
+    }
+
     return 0;
 }
 
-int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
+void MapUpdater::start_tick()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    m_tickStats = MapUpdaterTickStats();
+    m_tickStart = ACE_OS::gettimeofday();
+}
+
+int MapUpdater::schedule_request(ACE_Method_Request* request, char const* what)
 {
     ACE_GUARD_RETURN(ACE_Thread_Mutex,guard,this->m_mutex,-1);
 
     ++this->pending_requests;
 
-    if (this->m_executor.execute(new MapUpdateRequest(map,*this,diff)) == -1)
+    if (this->m_executor.execute(request) == -1)
     {
-        ACE_DEBUG((LM_ERROR, ACE_TEXT ("(%t) \n"), ACE_TEXT ("Failed to schedule Map Update")));
+        ACE_DEBUG((LM_ERROR, ACE_TEXT ("(%t) Failed to schedule %s\n"), what));
 
         --this->pending_requests;
         return -1;
@@ -130,12 +171,22 @@ int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
     return 0;
 }
 
+int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
+{
+    return schedule_request(new MapUpdateRequest(map, *this, diff), "Map Update");
+}
+
+int MapUpdater::schedule_global(char const* name, GlobalUpdateTask task, ACE_UINT32 diff)
+{
+    return schedule_request(new GlobalUpdateRequest(name, task, *this, diff), name);
+}
+
 bool MapUpdater::activated()
 {
     return m_executor.activated();
 }
 
-void MapUpdater::update_finished()
+void MapUpdater::update_finished(uint32 runTime, uint32 mapId, char const* taskName)
 {
     ACE_GUARD(ACE_Thread_Mutex, guard, this->m_mutex);
 
@@ -145,6 +196,14 @@ void MapUpdater::update_finished()
         return;
     }
 
+    m_tickStats.busyTime += runTime;
+    if (runTime > m_tickStats.longestTime)
+    {
+        m_tickStats.longestTime = runTime;
+        m_tickStats.longestMapId = mapId;
+        m_tickStats.longestName = taskName ? taskName : "";
+    }
+
     --this->pending_requests;
 
     //TODO can more than one thread call wait (), it shouldnt happen
@@ -45,6 +45,21 @@ struct MapUpdateInfo
 
 typedef std::map<ACE_thread_t const, MapUpdateInfo> ThreadMapMap;
 
+// global work which doesn't touch map objects and can run in parallel with map updates
+typedef void (*GlobalUpdateTask)(uint32 diff);
+
+// timings of one parallel tick phase, in microseconds
+struct MapUpdaterTickStats
+{
+    MapUpdaterTickStats() : wallTime(0), busyTime(0), longestTime(0), longestMapId(0), longestName("") {}
+
+    uint32 wallTime;                                        // from start_tick() till wait() returned
+    uint32 busyTime;                                        // sum of all request run times
+    uint32 longestTime;                                     // longest single request, lower bound of wallTime
+    uint32 longestMapId;                                    // map of longest request if it was map update
+    char const* longestName;                                // task name of longest request if it was global task
+};
+
 class MapUpdater
 {
     public:
@@ -58,6 +73,13 @@ class MapUpdater
         /// it may even start before the call returns
         int schedule_update(Map& map, ACE_UINT32 diff);
 
+        /// schedule global task on the same threads as map updates,
+        /// name must be a string with static storage
+        int schedule_global(char const* name, GlobalUpdateTask task, ACE_UINT32 diff);
+
+        /// Reset per tick statistics, called before first request of a tick is scheduled
+        void start_tick();
+
         /// Wait until all pending updates finish
         int wait();
 
@@ -68,7 +90,10 @@ class MapUpdater
         int deactivate(void);
 
         bool activated();
-        void update_finished();
+        void update_finished(uint32 runTime, uint32 mapId, char const* taskName);
+
+        MapUpdaterTickStats const& GetLastTickStats() const { return m_lastTickStats; }
+        size_t GetThreadCount() const { return m_threadCount; }
 
         void register_thread(ACE_thread_t const threadId, uint32 mapId, uint32 instanceId);
         void unregister_thread(ACE_thread_t const threadId);
@@ -78,6 +103,8 @@ class MapUpdater
         MapUpdateInfo const* GetMapUpdateInfo(ACE_thread_t const threadId);
 
     private:
+        int schedule_request(ACE_Method_Request* request, char const* what);
+
         ThreadMapMap m_threads;
 
         uint32 freezeDetectTime;
@@ -86,6 +113,11 @@ class MapUpdater
         ACE_Condition_Thread_Mutex m_condition;
         ACE_Thread_Mutex m_mutex;
         size_t pending_requests;
+        size_t m_threadCount;
+
+        ACE_Time_Value m_tickStart;
+        MapUpdaterTickStats m_tickStats;
+        MapUpdaterTickStats m_lastTickStats;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
@@ -51,6 +51,7 @@
 #include "Group.h"
 #include "luaengine/HookMgr.h"
 #include "GuildMgr.h"
+#include "PlayerDirectory.h"
 
 void WorldSession::HandleRepopRequestOpcode(WorldPacket & /*recv_data*/)
 {
@@ -153,10 +154,7 @@ void WorldSession::HandleWhoOpcode(WorldPacket & recv_data)
     sLog.outDebug("WORLD: Recvd CMSG_WHO Message");
     //recv_data.hexlike();
 
-    uint32 clientcount = 0;
-
     uint32 level_min, level_max, racemask, classmask, zones_count, str_count;
-    uint32 zoneids[10];                                     // 10 is client limit
     std::string player_name, guild_name;
 
     recv_data >> level_min;                                 // maximal player level, default 0
@@ -181,12 +179,14 @@ void WorldSession::HandleWhoOpcode(WorldPacket & recv_data)
     // recheck
     CHECK_PACKET_SIZE(recv_data,4+4+(player_name.size()+1)+(guild_name.size()+1)+4+4+4+(4*zones_count)+4);
 
+    WhoListQuery query;
+
     for (uint32 i = 0; i < zones_count; i++)
     {
         uint32 temp;
         recv_data >> temp;                                  // zone id, 0 if zone is unknown...
-        zoneids[i] = temp;
-        sLog.outDebug("Zone %u: %u", i, zoneids[i]);
+        query.zones.push_back(temp);
+        sLog.outDebug("Zone %u: %u", i, temp);
     }
 
     recv_data >> str_count;                                 // user entered strings count, client limit=4 (checked on 2.0.10)
@@ -199,7 +199,7 @@ void WorldSession::HandleWhoOpcode(WorldPacket & recv_data)
 
     sLog.outDebug("Minlvl %u, maxlvl %u, name %s, guild %s, racemask %u, classmask %u, zones %u, strings %u", level_min, level_max, player_name.c_str(), guild_name.c_str(), racemask, classmask, zones_count, str_count);
 
-    std::wstring str[4];                                    // 4 is client limit
+    query.strings.resize(str_count);                        // 4 is client limit
     for (uint32 i = 0; i < str_count; i++)
     {
         // recheck (have one more byte)
@@ -208,151 +208,42 @@ void WorldSession::HandleWhoOpcode(WorldPacket & recv_data)
         std::string temp;
         recv_data >> temp;                                  // user entered string, it used as universal search pattern(guild+player name)?
 
-        if (!Utf8toWStr(temp,str[i]))
+        if (!Utf8toWStr(temp,query.strings[i]))
             continue;
 
-        wstrToLower(str[i]);
+        wstrToLower(query.strings[i]);
 
         sLog.outDebug("String %u: %s", i, temp.c_str());
     }
 
-    std::wstring wplayer_name;
-    std::wstring wguild_name;
-    if (!(Utf8toWStr(player_name, wplayer_name) && Utf8toWStr(guild_name, wguild_name)))
+    if (!(Utf8toWStr(player_name, query.playerName) && Utf8toWStr(guild_name, query.guildName)))
         return;
-    wstrToLower(wplayer_name);
-    wstrToLower(wguild_name);
+    wstrToLower(query.playerName);
+    wstrToLower(query.guildName);
 
     // client send in case not set max level value 100 but mangos support 255 max level,
     // update it to show GMs with characters after 100 level
     if (level_max >= MAX_LEVEL)
         level_max = STRONG_MAX_LEVEL;
 
-    uint32 team = _player->GetTeam();
-    bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
-    bool gmInWhoList         = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
+    query.levelMin = level_min;
+    query.levelMax = level_max;
+    query.raceMask = racemask;
+    query.classMask = classmask;
+    query.viewerGuid = _player->GetGUID();
+    query.viewerPermissions = GetPermissions();
+    query.viewerTeamId = _player->GetTeamId();
+    query.viewerGameMaster = _player->isGameMaster();
+    query.viewerLocale = GetSessionDbcLocale();
+
+    uint32 clientcount = 0;
 
     WorldPacket data(SMSG_WHO, 50);                         // guess size
     data << clientcount;                                    // clientcount place holder
     data << clientcount;                                    // clientcount place holder
 
-    ACE_GUARD(ACE_Thread_Mutex, guard, *HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-    {
-        if (!HasPermissions(PERM_GMT_HDEV))
-        {
-            // player can see member of other team only if CONFIG_ALLOW_TWO_SIDE_WHO_LIST
-            if (itr->second->GetTeam() != team && !allowTwoSideWhoList)
-                continue;
-
-            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
-            if (itr->second->GetSession()->HasPermissions(PERM_GMT) && !gmInWhoList)
-                continue;
-        }
-
-        //do not process players which are not in world
-        if (!itr->second->IsInWorld())
-            continue;
-
-        // check if target is globally visible for player
-        if (!itr->second->IsVisibleGloballyfor(_player))
-            continue;
-
-        // check if target's level is in level range
-        uint32 lvl = itr->second->getLevel();
-        if (lvl < level_min || lvl > level_max)
-            continue;
-
-        // check if class matches classmask
-        uint32 class_ = itr->second->getClass();
-        if (!(classmask & (1 << class_)))
-            continue;
-
-        // check if race matches racemask
-        uint32 race = itr->second->getRace();
-        if (!(racemask & (1 << race)))
-            continue;
-
-        uint32 pzoneid = itr->second->GetCachedZone();
-        if (!GetPlayer()->isGameMaster() && sWorld.getConfig(CONFIG_ENABLE_FAKE_WHO_ON_ARENA))
-        {
-            if (itr->second->InArena())
-            {
-                Player *pPlayer = itr->second;
-                pzoneid = sTerrainMgr.GetZoneId(pPlayer->GetBattleGroundEntryPointMap(), pPlayer->GetBattleGroundEntryPointX(), pPlayer->GetBattleGroundEntryPointY(), pPlayer->GetBattleGroundEntryPointZ());
-            }
-        }
-
-        uint8 gender = itr->second->getGender();
-
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; i++)
-        {
-            if (zoneids[i] == pzoneid)
-            {
-                z_show = true;
-                break;
-            }
-
-            z_show = false;
-        }
-        if (!z_show)
-            continue;
-
-        std::string pname = itr->second->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname,wpname))
-            continue;
-        wstrToLower(wpname);
-
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
-            continue;
-
-        std::string gname = sGuildMgr.GetGuildNameById(itr->second->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname,wgname))
-            continue;
-        wstrToLower(wgname);
-
-        if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
-
-        std::string aname;
-        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(pzoneid))
-            aname = areaEntry->area_name[GetSessionDbcLocale()];
-
-        bool s_show = true;
-        for (uint32 i = 0; i < str_count; i++)
-        {
-            if (!str[i].empty())
-            {
-                if (wgname.find(str[i]) != std::wstring::npos ||
-                    wpname.find(str[i]) != std::wstring::npos ||
-                    Utf8FitTo(aname, str[i]))
-                {
-                    s_show = true;
-                    break;
-                }
-                s_show = false;
-            }
-        }
-        if (!s_show)
-            continue;
-
-        data << pname;                                  // player name
-        data << gname;                                  // guild name
-        data << uint32(lvl);                            // player level
-        data << uint32(class_);                         // player class
-        data << uint32(race);                           // player race
-        data << uint8(gender);                          // player gender
-        data << uint32(pzoneid);                        // player zone id
-
-        // 49 is maximum player count sent to client - can be overridden
-        // through config, but is unstable
-        if ((++clientcount) == sWorld.getConfig(CONFIG_MAX_WHO))
-            break;
-    }
+    // answered from player directory snapshot, no need to lock and scan online players
+    clientcount = sPlayerDirectory.BuildWhoList(query, data);
 
     data.put(0, clientcount);                //insert right count
     data.put(4, clientcount);                //insert right count
@@ -240,10 +240,13 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data)
     if (plMover)
         plMover->UpdateFallInformationIfNeed(movementInfo, opcode);
 
+    // only heartbeats may be skipped for far observers, they just confirm already known movement
+    uint32 heartbeat = opcode == MSG_MOVE_HEARTBEAT ? ++m_movementHeartbeats : 0;
+
     WorldPacket data(opcode, recv_data.size());
     data << mover->GetPackGUID();                 // write guid
     movementInfo.Write(data);                     // write data
-    mover->BroadcastPacketExcept(&data, _player);
+    mover->GetMap()->BroadcastMovementExcept(mover, &data, _player, _player, heartbeat);
 }
 
 void WorldSession::HandleMoverRelocation(MovementInfo& movementInfo)
@@ -970,7 +970,10 @@ void WorldObject::Relocate(Position pos)
     m_orientation = pos.o;
 
     if(isType(TYPEMASK_UNIT))
+    {
         ((Unit*)this)->m_movementInfo.ChangePosition(pos.x, pos.y, pos.z, pos.o);
+        ((Unit*)this)->RelocateInUnitIndex();
+    }
 }
 
 void WorldObject::Relocate(float x, float y, float z, float orientation)
@@ -981,7 +984,10 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
     m_orientation = orientation;
 
     if(isType(TYPEMASK_UNIT))
+    {
         ((Unit*)this)->m_movementInfo.ChangePosition(x, y, z, orientation);
+        ((Unit*)this)->RelocateInUnitIndex();
+    }
 }
 
 void WorldObject::Relocate(float x, float y, float z)
@@ -991,7 +997,10 @@ void WorldObject::Relocate(float x, float y, float z)
     m_positionZ = z;
 
     if(isType(TYPEMASK_UNIT))
+    {
         ((Unit*)this)->m_movementInfo.ChangePosition(x, y, z, GetOrientation());
+        ((Unit*)this)->RelocateInUnitIndex();
+    }
 }
 
 void WorldObject::SetOrientation(float orientation)
@@ -1183,13 +1192,44 @@ bool WorldObject::IsWithinLOSInMap(WorldObject const* obj) const
 
 bool WorldObject::IsWithinLOS(const float ox, const float oy, const float oz) const
 {
-    if (!GetTerrain()->IsLineOfSightEnabled())
+    if (!GetMap()->IsLineOfSightEnabled())
         return true;
 
     float x,y,z;
     GetPosition(x,y,z);
-    VMAP::IVMapManager *vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
-    return vMapManager->isInLineOfSight(GetMapId(), x, y, z +2.0f, ox, oy, oz +2.0f);
+    return GetMap()->IsInLineOfSight(x, y, z +2.0f, ox, oy, oz +2.0f);
+}
+
+void WorldObject::FilterWithinLOS(std::list<Unit*> &units) const
+{
+    std::vector<G3D::Vector3> targets;
+    targets.reserve(units.size());
+
+    for (std::list<Unit*>::iterator itr = units.begin(); itr != units.end();)
+    {
+        if (*itr != this && !(*itr)->IsInMap(this))
+            itr = units.erase(itr);
+        else
+        {
+            targets.push_back(G3D::Vector3((*itr)->GetPositionX(), (*itr)->GetPositionY(), (*itr)->GetPositionZ() + 2.0f));
+            ++itr;
+        }
+    }
+
+    if (targets.empty() || !GetMap()->IsLineOfSightEnabled())
+        return;
+
+    std::vector<bool> results;
+    GetMap()->IsInLineOfSight(GetPositionX(), GetPositionY(), GetPositionZ() + 2.0f, targets, results);
+
+    uint32 i = 0;
+    for (std::list<Unit*>::iterator itr = units.begin(); itr != units.end(); ++i)
+    {
+        if (*itr != this && !results[i])
+            itr = units.erase(itr);
+        else
+            ++itr;
+    }
 }
 
 bool WorldObject::IsInRange(WorldObject const* obj, float minRange, float maxRange, bool is3D /* = true */) const
@@ -154,6 +154,7 @@ class HELLGROUND_IMPORT_EXPORT Object
 
         uint8 GetTypeId() const { return m_objectTypeId; }
         bool isType(uint16 mask) const { return (mask & m_objectType); }
+        uint16 GetTypeMask() const { return m_objectType; }
 
         virtual void BuildCreateUpdateBlockForPlayer(UpdateData *data, Player *target) const;
         void SendCreateUpdateToPlayer(Player* player);
@@ -509,6 +510,8 @@ class HELLGROUND_IMPORT_EXPORT WorldObject : public Object//, public WorldLocati
         }
         bool IsWithinLOS(const float x, const float y, const float z) const;
         bool IsWithinLOSInMap(WorldObject const* obj) const;
+        // removes units out of line of sight, same as unit->IsWithinLOSInMap(this) for each of them, but in one vmap query
+        void FilterWithinLOS(std::list<Unit*> &units) const;
 
         bool IsInRange(WorldObject const* obj, float minRange, float maxRange, bool is3D = true) const;
         bool IsInRange2d(float x, float y, float minRange, float maxRange) const;
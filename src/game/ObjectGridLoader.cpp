@@ -29,6 +29,7 @@
 #include "CellImpl.h"
 #include "CreatureAI.h"
 #include "GridDefines.h"
+#include "ObjectPool.h"
 
 class ObjectGridRespawnMover
 {
@@ -222,18 +223,49 @@ void ObjectGridLoader::Load(GridType &grid)
 void ObjectGridLoader::LoadN(void)
 {
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
-    i_cell.data.Part.cell_y = 0;
-    for (unsigned int x=0; x < MAX_NUMBER_OF_CELLS; ++x)
+    LoadCells(0, MAX_NUMBER_OF_CELLS*MAX_NUMBER_OF_CELLS);
+    sLog.outDebug("%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses,i_grid.GetGridId(), i_map->GetId());
+}
+
+void ObjectGridLoader::LoadCells(uint32 first, uint32 count)
+{
+    if (sWorld.getConfig(CONFIG_OBJECT_POOL_RESERVE))
+        ReservePoolSlots(first, count);
+
+    for (uint32 i = first; i < first + count && i < MAX_NUMBER_OF_CELLS*MAX_NUMBER_OF_CELLS; ++i)
     {
+        uint32 x = i / MAX_NUMBER_OF_CELLS;
+        uint32 y = i % MAX_NUMBER_OF_CELLS;
+
         i_cell.data.Part.cell_x = x;
-        for (unsigned int y=0; y < MAX_NUMBER_OF_CELLS; ++y)
-        {
-            i_cell.data.Part.cell_y = y;
-            GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
-            loader.Load(i_grid(x, y), *this);
-        }
+        i_cell.data.Part.cell_y = y;
+        GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
+        loader.Load(i_grid(x, y), *this);
     }
-    sLog.outDebug("%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses,i_grid.GetGridId(), i_map->GetId());
+}
+
+void ObjectGridLoader::ReservePoolSlots(uint32 first, uint32 count)
+{
+    uint32 creatures = 0;
+    uint32 gameObjects = 0;
+
+    for (uint32 i = first; i < first + count && i < MAX_NUMBER_OF_CELLS*MAX_NUMBER_OF_CELLS; ++i)
+    {
+        uint32 x = (i_cell.GridX()*MAX_NUMBER_OF_CELLS) + i / MAX_NUMBER_OF_CELLS;
+        uint32 y = (i_cell.GridY()*MAX_NUMBER_OF_CELLS) + i % MAX_NUMBER_OF_CELLS;
+        uint32 cell_id = (y*TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+
+        CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
+        creatures += cell_guids.creatures.size();
+        gameObjects += cell_guids.gameobjects.size();
+    }
+
+    // spawns of derived classes (pets, totems) have other sizes and are not reserved
+    if (creatures)
+        sObjectPoolMgr.GetCreaturePool().Reserve(sizeof(Creature), creatures);
+
+    if (gameObjects)
+        sObjectPoolMgr.GetGameObjectPool().Reserve(sizeof(GameObject), gameObjects);
 }
 
 void ObjectGridUnloader::MoveToRespawnN()
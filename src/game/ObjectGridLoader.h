@@ -46,8 +46,13 @@ class ObjectGridLoader
         void Visit(DynamicObjectMapType&) { }
 
         void LoadN(void);
+        // loads count cells of grid starting with cell index first (cell_x * MAX_NUMBER_OF_CELLS + cell_y)
+        void LoadCells(uint32 first, uint32 count);
 
     private:
+        // makes object pools ready for static spawns of the cells
+        void ReservePoolSlots(uint32 first, uint32 count);
+
         Cell i_cell;
         NGridType &i_grid;
         Map* i_map;
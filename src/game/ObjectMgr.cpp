@@ -102,15 +102,15 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
     return NULL;
 }
 
-ObjectMgr::ObjectMgr()
-{
-    m_hiCharGuid        = 1;
-    m_hiCreatureGuid    = 1;
-    m_hiPetGuid         = 1;
-    m_hiItemGuid        = 1;
-    m_hiGoGuid          = 1;
-    m_hiDoGuid          = 1;
-    m_hiCorpseGuid      = 1;
+ObjectMgr::ObjectMgr() :
+    m_hiCharGuid("Players", 0xFFFFFFFD, 1),
+    m_hiCreatureGuid("Creature", 0xFFFFFFFD, 64),
+    m_hiPetGuid("Pet", 0x00FFFFFD, 16),
+    m_hiItemGuid("Item", 0xFFFFFFFD, 64),
+    m_hiGoGuid("Gameobject", 0x00FFFFFD, 16),
+    m_hiDoGuid("DynamicObject", 0xFFFFFFFD, 64),
+    m_hiCorpseGuid("Corpse", 0xFFFFFFFD, 1)
+{
     m_hiPetNumber       = 1;
     m_ItemTextId        = 1;
     m_mailid            = 1;
@@ -3644,15 +3644,19 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
     //delete all old mails without item and without body immediately, if starting server
     if (!serverUp)
         RealmDataDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)basetime);
+
+    std::vector<Mail*> mails;
+    LoadExpiredMails(mails, basetime);
+    ReturnOrDeleteOldMails(mails, basetime, serverUp);
+}
+
+void ObjectMgr::LoadExpiredMails(std::vector<Mail*>& mails, time_t basetime)
+{
     //                                                            0  1           2      3        4          5         6           7   8       9
     QueryResultAutoPtr result = RealmDataDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
     if (!result)
         return;                                             // any mails need to be returned or deleted
     Field *fields;
-    //std::ostringstream delitems, delmails; //will be here for optimization
-    //bool deletemail = false, deleteitem = false;
-    //delitems << "DELETE FROM item_instance WHERE guid IN (";
-    //delmails << "DELETE FROM mail WHERE id IN ("
     do
     {
         fields = result->Fetch();
@@ -3662,25 +3666,14 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
         m->sender = fields[2].GetUInt32();
         m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
         m->itemTextId = fields[4].GetUInt32();
-        bool has_items = fields[5].GetBool();
+        m->has_items = fields[5].GetBool();
         m->expire_time = (time_t)fields[6].GetUInt64();
         m->deliver_time = 0;
         m->COD = fields[7].GetUInt32();
         m->checked = fields[8].GetUInt32();
         m->mailTemplateId = fields[9].GetInt16();
 
-        Player *pl = 0;
-        if (serverUp)
-            pl = GetPlayer(m->receiverGuid.GetRawValue());
-
-        if (pl)
-        {
-            delete m;
-            continue;
-        }
-
-        //delete or return mail:
-        if (has_items)
+        if (m->has_items)
         {
             QueryResultAutoPtr resultItems = RealmDataDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", m->messageID);
             if (resultItems)
@@ -3696,7 +3689,35 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
                 }
                 while (resultItems->NextRow());
             }
+        }
+
+        mails.push_back(m);
+    } while (result->NextRow());
+}
+
+void ObjectMgr::ReturnOrDeleteOldMails(std::vector<Mail*>& mails, time_t basetime, bool serverUp)
+{
+    //std::ostringstream delitems, delmails; //will be here for optimization
+    //bool deletemail = false, deleteitem = false;
+    //delitems << "DELETE FROM item_instance WHERE guid IN (";
+    //delmails << "DELETE FROM mail WHERE id IN ("
+    for (std::vector<Mail*>::iterator itr = mails.begin(); itr != mails.end(); ++itr)
+    {
+        Mail *m = *itr;
 
+        Player *pl = 0;
+        if (serverUp)
+            pl = GetPlayer(m->receiverGuid.GetRawValue());
+
+        if (pl)
+        {
+            delete m;
+            continue;
+        }
+
+        //delete or return mail:
+        if (m->has_items)
+        {
             // mail should be deleted if:
             // - it's from AH
             // - it's readed mail from GM (or meybe all readed mails should be deleted not returned ?)
@@ -3727,7 +3748,9 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
         //delmails << m->messageID << ", ";
         RealmDataDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", m->messageID);
         delete m;
-    } while (result->NextRow());
+    }
+
+    mails.clear();
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
@@ -4426,27 +4449,29 @@ void ObjectMgr::SetHighestGuids()
 {
     QueryResultAutoPtr result = RealmDataDatabase.Query("SELECT MAX(guid) FROM characters");
     if (result)
-        m_hiCharGuid = (*result)[0].GetUInt32()+1;
+        m_hiCharGuid.Set((*result)[0].GetUInt32()+1);
 
     result = GameDataDatabase.Query("SELECT MAX(guid) FROM creature");
     if (result)
-        m_hiCreatureGuid = (*result)[0].GetUInt32()+1;
+        m_hiCreatureGuid.Set((*result)[0].GetUInt32()+1);
 
+    uint32 hiItemGuid = 1;
     result = RealmDataDatabase.Query("SELECT MAX(guid) FROM item_instance");
     if (result)
-        m_hiItemGuid = (*result)[0].GetUInt32()+1;
+        hiItemGuid = (*result)[0].GetUInt32()+1;
+    m_hiItemGuid.Set(hiItemGuid);
 
-    // Cleanup other tables from not existed guids (>=m_hiItemGuid)
+    // Cleanup other tables from not existed guids (>=hiItemGuid)
     RealmDataDatabase.BeginTransaction();
-    RealmDataDatabase.PExecute("DELETE FROM character_inventory WHERE item >= '%u'", m_hiItemGuid);
-    RealmDataDatabase.PExecute("DELETE FROM mail_items WHERE item_guid >= '%u'", m_hiItemGuid);
-    RealmDataDatabase.PExecute("DELETE FROM auctionhouse WHERE itemguid >= '%u'", m_hiItemGuid);
-    RealmDataDatabase.PExecute("DELETE FROM guild_bank_item WHERE item_guid >= '%u'", m_hiItemGuid);
+    RealmDataDatabase.PExecute("DELETE FROM character_inventory WHERE item >= '%u'", hiItemGuid);
+    RealmDataDatabase.PExecute("DELETE FROM mail_items WHERE item_guid >= '%u'", hiItemGuid);
+    RealmDataDatabase.PExecute("DELETE FROM auctionhouse WHERE itemguid >= '%u'", hiItemGuid);
+    RealmDataDatabase.PExecute("DELETE FROM guild_bank_item WHERE item_guid >= '%u'", hiItemGuid);
     RealmDataDatabase.CommitTransaction();
 
     result = GameDataDatabase.Query("SELECT MAX(guid) FROM gameobject");
     if (result)
-        m_hiGoGuid = (*result)[0].GetUInt32()+1;
+        m_hiGoGuid.Set((*result)[0].GetUInt32()+1);
 
     result = RealmDataDatabase.Query("SELECT MAX(id) FROM auctionhouse");
     if (result)
@@ -4462,7 +4487,7 @@ void ObjectMgr::SetHighestGuids()
 
     result = RealmDataDatabase.Query("SELECT MAX(guid) FROM corpse");
     if (result)
-        m_hiCorpseGuid = (*result)[0].GetUInt32()+1;
+        m_hiCorpseGuid.Set((*result)[0].GetUInt32()+1);
 
     result = RealmDataDatabase.Query("SELECT MAX(arenateamid) FROM arena_team");
     if (result)
@@ -4528,54 +4553,19 @@ uint32 ObjectMgr::GenerateLowGuid(HighGuid guidhigh)
     switch (guidhigh)
     {
         case HIGHGUID_ITEM:
-            if (m_hiItemGuid>=0xFFFFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Item guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiItemGuid++;
+            return m_hiItemGuid.Generate();
         case HIGHGUID_UNIT:
-            if (m_hiCreatureGuid>=0xFFFFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Creature guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiCreatureGuid++;
+            return m_hiCreatureGuid.Generate();
         case HIGHGUID_PET:
-            if (m_hiPetGuid>=0x00FFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Pet guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiPetGuid++;
+            return m_hiPetGuid.Generate();
         case HIGHGUID_PLAYER:
-            if (m_hiCharGuid>=0xFFFFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Players guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiCharGuid++;
+            return m_hiCharGuid.Generate();
         case HIGHGUID_GAMEOBJECT:
-            if (m_hiGoGuid>=0x00FFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Gameobject guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiGoGuid++;
+            return m_hiGoGuid.Generate();
         case HIGHGUID_CORPSE:
-            if (m_hiCorpseGuid>=0xFFFFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: Corpse guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiCorpseGuid++;
+            return m_hiCorpseGuid.Generate();
         case HIGHGUID_DYNAMICOBJECT:
-            if (m_hiDoGuid>=0xFFFFFFFE)
-            {
-                sLog.outLog(LOG_DEFAULT, "ERROR: DynamicObject guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiDoGuid++;
+            return m_hiDoGuid.Generate();
         default:
             ASSERT(0);
     }
@@ -4584,6 +4574,23 @@ uint32 ObjectMgr::GenerateLowGuid(HighGuid guidhigh)
     return 0;
 }
 
+void ObjectMgr::ReleaseLowGuid(HighGuid guidhigh, uint32 guidlow)
+{
+    uint32 reuseDelay = sWorld.getConfig(CONFIG_GUID_REUSE_DELAY) * IN_MILISECONDS;
+
+    switch (guidhigh)
+    {
+        case HIGHGUID_UNIT:
+            m_hiCreatureGuid.Release(guidlow, reuseDelay);
+            break;
+        case HIGHGUID_DYNAMICOBJECT:
+            m_hiDoGuid.Release(guidlow, reuseDelay);
+            break;
+        default:
+            ASSERT(0);
+    }
+}
+
 void ObjectMgr::LoadGameObjectLocales()
 {
     mGameObjectLocaleMap.clear();                           // need for reload case
@@ -39,6 +39,7 @@
 #include "Map.h"
 #include "ObjectAccessor.h"
 #include "ObjectGuid.h"
+#include "GuidRangeAllocator.h"
 #include "Database/SQLStorage.h"
 
 #include <string>
@@ -534,8 +535,15 @@ class ObjectMgr
 
         void ReturnOrDeleteOldMails(bool serverUp);
 
+        // loading expired mails doesn't touch players and can run on any thread,
+        // returning them must run on world thread as it skips receivers being online
+        void LoadExpiredMails(std::vector<Mail*>& mails, time_t basetime);
+        void ReturnOrDeleteOldMails(std::vector<Mail*>& mails, time_t basetime, bool serverUp);
+
         void SetHighestGuids();
         uint32 GenerateLowGuid(HighGuid guidhigh);
+        // guid of deleted transient object (dynamic object, temporary summon) can be generated again after GuidReuseDelay
+        void ReleaseLowGuid(HighGuid guidhigh, uint32 guidlow);
         uint32 GenerateAuctionID();
         uint32 GenerateMailID();
         uint32 GenerateItemTextID();
@@ -564,6 +572,11 @@ class ObjectMgr
                 return NULL;
         }
 
+        CellObjectGuidsMap const& GetMapObjectGuids(uint16 mapid, uint8 spawnMode)
+        {
+            return mMapObjectGuids[MAKE_PAIR32(mapid,spawnMode)];
+        }
+
         CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id)
         {
             return mMapObjectGuids[MAKE_PAIR32(mapid,spawnMode)][cell_id];
@@ -767,14 +780,14 @@ class ObjectMgr
         uint32 m_arenaTeamId;
         uint32 m_hiPetNumber;
 
-        // first free low guid for seelcted guid type
-        uint32 m_hiCharGuid;
-        uint32 m_hiCreatureGuid;
-        uint32 m_hiPetGuid;
-        uint32 m_hiItemGuid;
-        uint32 m_hiGoGuid;
-        uint32 m_hiDoGuid;
-        uint32 m_hiCorpseGuid;
+        // first free low guid for seelcted guid type, generated by threads in ranges
+        GuidRangeAllocator m_hiCharGuid;
+        GuidRangeAllocator m_hiCreatureGuid;
+        GuidRangeAllocator m_hiPetGuid;
+        GuidRangeAllocator m_hiItemGuid;
+        GuidRangeAllocator m_hiGoGuid;
+        GuidRangeAllocator m_hiDoGuid;
+        GuidRangeAllocator m_hiCorpseGuid;
 
         QuestMap            mQuestTemplates;
 
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "ObjectPool.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#include <stdio.h>
+#endif
+
+// objects are kept 16 bytes aligned like from malloc
+#define OBJECT_POOL_ALIGN(size) (((size) + 15) & ~size_t(15))
+
+struct ObjectPoolHeader
+{
+    ObjectPoolSlab* slab;                                   // NULL for heap object
+    ObjectSlabPool* pool;
+};
+
+#define OBJECT_POOL_HEADER_SIZE OBJECT_POOL_ALIGN(sizeof(ObjectPoolHeader))
+
+struct ObjectPoolSlab
+{
+    ObjectSlabPool::SizeClass* sizeClass;
+    void* freeList;                                         // free slots linked through their first bytes
+    uint32 used;                                            // slots given out, including released ones
+};
+
+#define OBJECT_POOL_SLAB_HEADER_SIZE OBJECT_POOL_ALIGN(sizeof(ObjectPoolSlab))
+
+static inline ObjectPoolHeader* GetHeader(void* ptr)
+{
+    return (ObjectPoolHeader*)((char*)ptr - OBJECT_POOL_HEADER_SIZE);
+}
+
+bool ObjectSlabPool::m_enabled = false;
+bool ObjectSlabPool::m_shutdown = false;
+
+ObjectSlabPool::ObjectSlabPool(char const* name) : m_name(name)
+{
+    m_heapObjects = 0;
+}
+
+ObjectSlabPool::Shard& ObjectSlabPool::GetThreadShard()
+{
+    ShardSlot* slot = m_threadShard.ts_object();
+    if (!slot)
+    {
+        slot = new ShardSlot;
+        m_threadShard.ts_object(slot);
+    }
+
+    if (!slot->shard)
+    {
+        slot->shard = new Shard;
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_shardsLock, *slot->shard);
+        m_shards.push_back(slot->shard);
+    }
+
+    return *slot->shard;
+}
+
+ObjectSlabPool::SizeClass& ObjectSlabPool::GetSizeClass(Shard& shard, size_t size)
+{
+    // few classes derive from pooled base, linear search is enough
+    for (std::vector<SizeClass*>::iterator itr = shard.sizeClasses.begin(); itr != shard.sizeClasses.end(); ++itr)
+    {
+        if ((*itr)->size == size)
+            return **itr;
+    }
+
+    shard.sizeClasses.push_back(new SizeClass(&shard, size));
+    return *shard.sizeClasses.back();
+}
+
+ObjectPoolSlab* ObjectSlabPool::AllocateSlab(SizeClass& sizeClass)
+{
+    size_t slotSize = OBJECT_POOL_HEADER_SIZE + OBJECT_POOL_ALIGN(sizeClass.size);
+    char* raw = (char*)::operator new(OBJECT_POOL_SLAB_HEADER_SIZE + slotSize * OBJECT_POOL_SLAB_OBJECTS);
+
+    ObjectPoolSlab* slab = (ObjectPoolSlab*)raw;
+    slab->sizeClass = &sizeClass;
+    slab->freeList = NULL;
+    slab->used = 0;
+
+    // link slots so that first one is taken first
+    for (int32 i = OBJECT_POOL_SLAB_OBJECTS - 1; i >= 0; --i)
+    {
+        char* slot = raw + OBJECT_POOL_SLAB_HEADER_SIZE + i * slotSize;
+
+        ObjectPoolHeader* header = (ObjectPoolHeader*)slot;
+        header->slab = slab;
+        header->pool = this;
+
+        void* object = slot + OBJECT_POOL_HEADER_SIZE;
+        *(void**)object = slab->freeList;
+        slab->freeList = object;
+    }
+
+    ++sizeClass.slabs;
+    sizeClass.partial.insert(slab);
+    return slab;
+}
+
+void* ObjectSlabPool::AllocateHeap(size_t size)
+{
+    char* raw = (char*)::operator new(OBJECT_POOL_HEADER_SIZE + size);
+
+    ObjectPoolHeader* header = (ObjectPoolHeader*)raw;
+    header->slab = NULL;
+    header->pool = this;
+
+    ++m_heapObjects;
+    return raw + OBJECT_POOL_HEADER_SIZE;
+}
+
+void* ObjectSlabPool::Allocate(size_t size)
+{
+    if (!m_enabled)
+        return AllocateHeap(size);
+
+    Shard& shard = GetThreadShard();
+
+    // taken by other threads only to release their deletes or on Recycle
+    ACE_Guard<ACE_Thread_Mutex> guard(shard.lock);
+    if (!guard.locked())
+        return AllocateHeap(size);
+
+    SizeClass& sizeClass = GetSizeClass(shard, size);
+    ObjectPoolSlab* slab = sizeClass.partial.empty() ? AllocateSlab(sizeClass) : *sizeClass.partial.begin();
+
+    void* object = slab->freeList;
+    slab->freeList = *(void**)object;
+    ++slab->used;
+    ++sizeClass.used;
+
+    if (!slab->freeList)
+        sizeClass.partial.erase(slab);
+
+    return object;
+}
+
+void ObjectSlabPool::Deallocate(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    ObjectPoolHeader* header = GetHeader(ptr);
+    if (header->slab)
+    {
+        // slab memory is left to process exit
+        if (!m_shutdown)
+            Release(ptr);
+
+        return;
+    }
+
+    if (!m_shutdown)
+        --header->pool->m_heapObjects;
+
+    ::operator delete(header);
+}
+
+void ObjectSlabPool::Release(void* slot)
+{
+    Shard& shard = *GetHeader(slot)->slab->sizeClass->shard;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, shard.lock);
+    shard.released.push_back(slot);
+}
+
+void ObjectSlabPool::Reserve(size_t size, uint32 count)
+{
+    if (!m_enabled)
+        return;
+
+    Shard& shard = GetThreadShard();
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, shard.lock);
+
+    SizeClass& sizeClass = GetSizeClass(shard, size);
+    uint32 free = sizeClass.slabs * OBJECT_POOL_SLAB_OBJECTS - sizeClass.used;
+    for (; free < count; free += OBJECT_POOL_SLAB_OBJECTS)
+        AllocateSlab(sizeClass);
+}
+
+void ObjectSlabPool::Recycle()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_shardsLock);
+
+    for (std::vector<Shard*>::iterator itr = m_shards.begin(); itr != m_shards.end(); ++itr)
+        RecycleShard(**itr);
+}
+
+void ObjectSlabPool::RecycleShard(Shard& shard)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, shard.lock);
+
+    for (std::vector<void*>::const_iterator itr = shard.released.begin(); itr != shard.released.end(); ++itr)
+    {
+        ObjectPoolSlab* slab = GetHeader(*itr)->slab;
+        SizeClass& sizeClass = *slab->sizeClass;
+
+        if (!slab->freeList)
+            sizeClass.partial.insert(slab);
+
+        *(void**)*itr = slab->freeList;
+        slab->freeList = *itr;
+        --slab->used;
+        --sizeClass.used;
+    }
+
+    shard.released.clear();
+
+    for (std::vector<SizeClass*>::iterator sc = shard.sizeClasses.begin(); sc != shard.sizeClasses.end(); ++sc)
+    {
+        SizeClass& sizeClass = **sc;
+
+        // new objects go to lowest slabs, so empty ones are freed from the top
+        uint32 emptySlabs = 0;
+        for (std::set<ObjectPoolSlab*, SlabLess>::iterator itr = sizeClass.partial.begin(); itr != sizeClass.partial.end();)
+        {
+            ObjectPoolSlab* slab = *itr;
+            if (slab->used || ++emptySlabs <= OBJECT_POOL_KEPT_EMPTY_SLABS)
+            {
+                ++itr;
+                continue;
+            }
+
+            sizeClass.partial.erase(itr++);
+            --sizeClass.slabs;
+            ::operator delete(slab);
+        }
+    }
+}
+
+void ObjectSlabPool::GetStats(ObjectPoolStats& stats) const
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_shardsLock);
+
+    for (std::vector<Shard*>::const_iterator shard = m_shards.begin(); shard != m_shards.end(); ++shard)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, shardGuard, (*shard)->lock);
+
+        for (std::vector<SizeClass*>::const_iterator itr = (*shard)->sizeClasses.begin(); itr != (*shard)->sizeClasses.end(); ++itr)
+        {
+            stats.slabs += (*itr)->slabs;
+            stats.slots += (*itr)->slabs * OBJECT_POOL_SLAB_OBJECTS;
+            stats.used += (*itr)->used;
+            stats.bytes += uint64((*itr)->slabs) * (OBJECT_POOL_SLAB_HEADER_SIZE +
+                (OBJECT_POOL_HEADER_SIZE + OBJECT_POOL_ALIGN((*itr)->size)) * OBJECT_POOL_SLAB_OBJECTS);
+        }
+
+        stats.released += (*shard)->released.size();
+    }
+
+    stats.shards += m_shards.size();
+    stats.heapObjects += m_heapObjects;
+}
+
+ObjectPoolMgr::ObjectPoolMgr() : m_creatures("Creature"), m_gameObjects("GameObject"), m_dynamicObjects("DynamicObject")
+{
+}
+
+ObjectPoolMgr::~ObjectPoolMgr()
+{
+    // transports and other objects still alive are deleted after us on shutdown
+    ObjectSlabPool::Shutdown();
+}
+
+void ObjectPoolMgr::Recycle()
+{
+    m_creatures.Recycle();
+    m_gameObjects.Recycle();
+    m_dynamicObjects.Recycle();
+}
+
+uint64 ObjectPoolMgr::GetResidentMemory()
+{
+#ifndef WIN32
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+
+    unsigned long size = 0, resident = 0;
+    int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+
+    if (read != 2)
+        return 0;
+
+    return uint64(resident) * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
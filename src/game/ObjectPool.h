@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_OBJECTPOOL_H
+#define HELLGROUND_OBJECTPOOL_H
+
+#include "Common.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/TSS_T.h>
+#include <tbb/atomic.h>
+#include <set>
+
+// objects in one slab, slab is allocated and freed as whole
+#define OBJECT_POOL_SLAB_OBJECTS    64
+// empty slabs kept per size class for next spawns
+#define OBJECT_POOL_KEPT_EMPTY_SLABS 2
+
+struct ObjectPoolSlab;
+
+struct ObjectPoolStats
+{
+    ObjectPoolStats() : shards(0), slabs(0), slots(0), used(0), released(0), heapObjects(0), bytes(0) {}
+
+    uint32 shards;
+    uint32 slabs;
+    uint32 slots;
+    uint32 used;                                            // including released
+    uint32 released;                                        // deleted, waiting for Recycle
+    uint32 heapObjects;                                     // allocated while pool was disabled
+    uint64 bytes;                                           // memory held by slabs
+};
+
+/**
+ * ObjectSlabPool - slab allocator for one family of world objects.
+ *
+ * Every allocation gets small header pointing to its slab (or NULL for objects taken from
+ * heap while pooling was disabled), so delete works no matter how the object was created.
+ * Each class derived from pooled base has its own size class.
+ *
+ * Every thread allocates from its own shard, so map threads spawning objects don't wait
+ * for each other. Object deleted by other thread (it moved to other map) is handed back
+ * to shard owning its slab, under that shard's lock.
+ *
+ * Deleted objects are not reused immediately: they are kept as released until Recycle(),
+ * called by world thread after map updates, so memory of object deleted from remove list
+ * can't be handed to new spawn in the same tick. Slabs are taken lowest address first,
+ * which keeps long living objects packed and lets Recycle() free slabs that became empty.
+ */
+class ObjectSlabPool
+{
+    public:
+        explicit ObjectSlabPool(char const* name);
+
+        void* Allocate(size_t size);
+        static void Deallocate(void* ptr);
+
+        // makes sure count objects of given size can be created by calling thread without allocating new slab
+        void Reserve(size_t size, uint32 count);
+
+        // released objects become free, empty slabs over OBJECT_POOL_KEPT_EMPTY_SLABS are freed
+        void Recycle();
+
+        void GetStats(ObjectPoolStats& stats) const;
+        char const* GetName() const { return m_name; }
+
+        static void SetEnabled(bool enabled) { m_enabled = enabled; }
+        static bool IsEnabled() { return m_enabled; }
+
+        // pools are being destroyed, objects deleted from now on (transports) are not returned to them
+        static void Shutdown() { m_shutdown = true; }
+
+    private:
+        struct SlabLess
+        {
+            bool operator()(ObjectPoolSlab const* a, ObjectPoolSlab const* b) const { return a < b; }
+        };
+
+        struct Shard;
+
+        struct SizeClass
+        {
+            SizeClass(Shard* o, size_t s) : shard(o), size(s), slabs(0), used(0) {}
+
+            Shard* shard;
+            size_t size;
+            std::set<ObjectPoolSlab*, SlabLess> partial;    // slabs with free slots
+            uint32 slabs;
+            uint32 used;
+        };
+
+        struct Shard
+        {
+            ACE_Thread_Mutex lock;
+            std::vector<SizeClass*> sizeClasses;
+            std::vector<void*> released;
+        };
+
+        struct ShardSlot
+        {
+            ShardSlot() : shard(NULL) {}
+
+            Shard* shard;
+        };
+
+        Shard& GetThreadShard();
+        void* AllocateHeap(size_t size);
+        SizeClass& GetSizeClass(Shard& shard, size_t size);
+        ObjectPoolSlab* AllocateSlab(SizeClass& sizeClass);
+        static void Release(void* slot);
+        static void RecycleShard(Shard& shard);
+
+        friend struct ObjectPoolSlab;
+
+        char const* m_name;
+
+        ACE_TSS<ShardSlot> m_threadShard;
+
+        // shards are owned by pool and outlive their threads
+        mutable ACE_Thread_Mutex m_shardsLock;
+        std::vector<Shard*> m_shards;
+
+        tbb::atomic<uint32> m_heapObjects;
+
+        static bool m_enabled;
+        static bool m_shutdown;
+};
+
+class ObjectPoolMgr
+{
+    friend class ACE_Singleton<ObjectPoolMgr, ACE_Thread_Mutex>;
+    ObjectPoolMgr();
+    ~ObjectPoolMgr();
+
+    public:
+        ObjectSlabPool& GetCreaturePool() { return m_creatures; }
+        ObjectSlabPool& GetGameObjectPool() { return m_gameObjects; }
+        ObjectSlabPool& GetDynamicObjectPool() { return m_dynamicObjects; }
+
+        // world thread only, outside of map updates
+        void Recycle();
+
+        // resident set size of whole process in bytes, 0 when unknown
+        static uint64 GetResidentMemory();
+
+    private:
+        ObjectSlabPool m_creatures;
+        ObjectSlabPool m_gameObjects;
+        ObjectSlabPool m_dynamicObjects;
+};
+
+#define sObjectPoolMgr (*ACE_Singleton<ObjectPoolMgr, ACE_Thread_Mutex>::instance())
+
+#endif
@@ -126,7 +126,7 @@ OpcodeHandler opcodeTable[NUM_MSG_TYPES] =
     /*0x05F*/ { "SMSG_GAMEOBJECT_QUERY_RESPONSE",   STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
     /*0x060*/ { "CMSG_CREATURE_QUERY",              STATUS_LOGGEDIN,    PROCESS_INPLACE, &WorldSession::HandleCreatureQueryOpcode       },
     /*0x061*/ { "SMSG_CREATURE_QUERY_RESPONSE",     STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
-    /*0x062*/ { "CMSG_WHO",                         STATUS_LOGGEDIN,    PROCESS_THREADUNSAFE, &WorldSession::HandleWhoOpcode                 },
+    /*0x062*/ { "CMSG_WHO",                         STATUS_LOGGEDIN,    PROCESS_THREADSAFE,  &WorldSession::HandleWhoOpcode                 },
     /*0x063*/ { "SMSG_WHO",                         STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
     /*0x064*/ { "CMSG_WHOIS",                       STATUS_LOGGEDIN,    PROCESS_THREADUNSAFE, &WorldSession::HandleWhoisOpcode               },
     /*0x065*/ { "SMSG_WHOIS",                       STATUS_NEVER,       PROCESS_INPLACE, &WorldSession::Handle_ServerSide               },
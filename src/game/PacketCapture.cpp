@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "PacketCapture.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include "Player.h"
+#include "Opcodes.h"
+#include "Log.h"
+#include "Timer.h"
+
+PacketCapture::PacketCapture() : m_filter(PACKET_CAPTURE_ALL), m_filterId(0), m_file(NULL), m_startTime(0)
+{
+    m_active = false;
+    m_records = 0;
+    m_bytes = 0;
+}
+
+PacketCapture::~PacketCapture()
+{
+    Stop();
+}
+
+bool PacketCapture::Start(std::string const& fileName, PacketCaptureFilter filter, uint32 filterId)
+{
+    Stop();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    m_file = fopen(fileName.c_str(), "wb");
+    if (!m_file)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: PacketCapture: can't open %s for writing", fileName.c_str());
+        return false;
+    }
+
+    ByteBuffer header;
+    header << uint32(PACKET_CAPTURE_MAGIC) << uint32(PACKET_CAPTURE_VERSION) << uint32(time(NULL)) << uint32(0);
+    fwrite(header.contents(), header.size(), 1, m_file);
+
+    m_fileName = fileName;
+    m_filter = filter;
+    m_filterId = filterId;
+    m_startTime = WorldTimer::getMSTime();
+    m_accounts.clear();
+    m_records = 0;
+    m_bytes = header.size();
+
+    // filter is set before sessions can see capture active
+    m_active = true;
+    return true;
+}
+
+void PacketCapture::Stop()
+{
+    m_active = false;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_file)
+        return;
+
+    fclose(m_file);
+    m_file = NULL;
+
+    sLog.outString("PacketCapture: " UI64FMTD " packets (" UI64FMTD " bytes) written to %s", uint64(m_records), uint64(m_bytes), m_fileName.c_str());
+}
+
+void PacketCapture::Record(WorldSession const& session, WorldPacket const& packet, uint32 receivedTime)
+{
+    Player* player = session.GetPlayer();
+
+    switch (m_filter)
+    {
+        case PACKET_CAPTURE_ACCOUNT:
+            if (session.GetAccountId() != m_filterId)
+                return;
+            break;
+        case PACKET_CAPTURE_MAP:
+            if (!player || player->GetMapId() != m_filterId)
+                return;
+            break;
+        default:
+            break;
+    }
+
+    // payload size is stored in 16 bits, client packets are much smaller anyway
+    if (packet.size() > 0xFFFF)
+        return;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!m_file)
+        return;
+
+    // packets taken from queue before capture started
+    uint32 time = int32(receivedTime - m_startTime) > 0 ? receivedTime - m_startTime : 0;
+
+    if (m_accounts.insert(session.GetAccountId()).second && player && packet.GetOpcode() != CMSG_PLAYER_LOGIN)
+    {
+        ByteBuffer login;
+        login << uint64(player->GetGUID());
+        Write(time, session.GetAccountId(), CMSG_PLAYER_LOGIN, login.contents(), login.size());
+    }
+
+    Write(time, session.GetAccountId(), packet.GetOpcode(), packet.size() ? packet.contents() : NULL, packet.size());
+}
+
+void PacketCapture::Write(uint32 time, uint32 accountId, uint16 opcode, uint8 const* payload, uint16 size)
+{
+    ByteBuffer record(PACKET_CAPTURE_RECORD_SIZE);
+    record << uint32(time) << uint32(accountId) << uint16(opcode) << uint16(size);
+
+    fwrite(record.contents(), record.size(), 1, m_file);
+    if (size)
+        fwrite(payload, size, 1, m_file);
+
+    ++m_records;
+    m_bytes += record.size() + size;
+}
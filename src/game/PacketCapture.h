@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_PACKETCAPTURE_H
+#define HELLGROUND_PACKETCAPTURE_H
+
+#include "Common.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <tbb/atomic.h>
+#include <set>
+
+class WorldPacket;
+class WorldSession;
+
+/*
+ * Capture file: header of 4 uint32 (magic, version, unix start time, reserved), then records of
+ * uint32 ms since start, uint32 account, uint16 opcode, uint16 payload size and payload,
+ * all little endian. Records are in handling order, times of one account never go back.
+ */
+#define PACKET_CAPTURE_MAGIC        0x43504748              // "HGPC"
+#define PACKET_CAPTURE_VERSION      1
+#define PACKET_CAPTURE_HEADER_SIZE  16
+#define PACKET_CAPTURE_RECORD_SIZE  12
+
+enum PacketCaptureFilter
+{
+    PACKET_CAPTURE_ALL      = 0,
+    PACKET_CAPTURE_ACCOUNT  = 1,
+    PACKET_CAPTURE_MAP      = 2
+};
+
+/**
+ * PacketCapture - records client packets of selected sessions for PacketReplay.
+ *
+ * Packets are recorded when session takes them for handling, on whichever thread updates the
+ * session, with the time socket received them. First record of an account already in game
+ * is preceded by CMSG_PLAYER_LOGIN of its character, so replay can enter world before it.
+ */
+class PacketCapture
+{
+    public:
+        PacketCapture();
+        ~PacketCapture();
+
+        bool Start(std::string const& fileName, PacketCaptureFilter filter, uint32 filterId);
+        void Stop();
+
+        bool IsActive() const { return m_active; }
+        void Record(WorldSession const& session, WorldPacket const& packet, uint32 receivedTime);
+
+        std::string const& GetFileName() const { return m_fileName; }
+        uint64 GetRecords() const { return m_records; }
+        uint64 GetBytes() const { return m_bytes; }
+
+    private:
+        void Write(uint32 time, uint32 accountId, uint16 opcode, uint8 const* payload, uint16 size);
+
+        tbb::atomic<bool> m_active;
+        PacketCaptureFilter m_filter;
+        uint32 m_filterId;
+
+        ACE_Thread_Mutex m_lock;
+        FILE* m_file;
+        std::string m_fileName;
+        uint32 m_startTime;
+        std::set<uint32> m_accounts;                        // accounts with records, to add login record once
+        tbb::atomic<uint64> m_records;
+        tbb::atomic<uint64> m_bytes;
+};
+
+#define sPacketCapture (*ACE_Singleton<PacketCapture, ACE_Thread_Mutex>::instance())
+
+#endif
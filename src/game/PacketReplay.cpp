@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "PacketReplay.h"
+#include "PacketCapture.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include "World.h"
+#include "Log.h"
+#include "Timer.h"
+
+PacketReplay::PacketReplay() : m_total(0), m_next(0), m_speed(1.0f), m_shutdownWhenDone(false), m_running(false),
+    m_startTime(0), m_drainTime(0), m_duration(0), m_queued(0), m_skipped(0)
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        m_opcodeCount[i] = 0;
+        m_opcodeTime[i] = 0;
+    }
+
+    m_outputPackets = 0;
+    m_outputBytes = 0;
+}
+
+bool PacketReplay::Start(std::string const& fileName, float speed, bool shutdownWhenDone)
+{
+    if (m_running || speed <= 0.0f || !Load(fileName))
+        return false;
+
+    m_fileName = fileName;
+    m_speed = speed;
+    m_shutdownWhenDone = shutdownWhenDone;
+    m_total = m_records.size();
+    m_next = 0;
+    m_startTime = 0;
+    m_drainTime = 0;
+    m_duration = 0;
+    m_queued = 0;
+    m_skipped = 0;
+    m_ticks.clear();
+
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        m_opcodeCount[i] = 0;
+        m_opcodeTime[i] = 0;
+    }
+
+    m_outputPackets = 0;
+    m_outputBytes = 0;
+
+    for (std::vector<uint32>::const_iterator itr = m_accounts.begin(); itr != m_accounts.end(); ++itr)
+    {
+        WorldSession* session = new WorldSession(*itr, NULL, PERM_PLAYER, sWorld.getConfig(CONFIG_EXPANSION), LOCALE_enUS);
+        session->SetReplay(true);
+        sWorld.AddSession(session);
+    }
+
+    m_running = true;
+    sLog.outString("PacketReplay: replaying %u packets of %u accounts from %s at speed %.2f",
+        m_total, uint32(m_accounts.size()), fileName.c_str(), speed);
+    return true;
+}
+
+void PacketReplay::Stop()
+{
+    if (m_running)
+        Finish();
+}
+
+static bool RecordTimeLess(PacketReplay::ReplayRecord const& a, PacketReplay::ReplayRecord const& b)
+{
+    return a.time < b.time;
+}
+
+bool PacketReplay::Load(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: PacketReplay: can't open %s", fileName.c_str());
+        return false;
+    }
+
+    ByteBuffer buffer;
+    uint8 chunk[4096];
+    while (size_t read = fread(chunk, 1, sizeof(chunk), file))
+        buffer.append(chunk, read);
+    fclose(file);
+
+    m_records.clear();
+    m_accounts.clear();
+
+    uint32 magic = 0, version = 0;
+    if (buffer.size() >= PACKET_CAPTURE_HEADER_SIZE)
+    {
+        buffer >> magic >> version;
+        buffer.read_skip(PACKET_CAPTURE_HEADER_SIZE - 8);
+    }
+
+    if (magic != PACKET_CAPTURE_MAGIC || version != PACKET_CAPTURE_VERSION)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: PacketReplay: %s is not a packet capture of version %u", fileName.c_str(), PACKET_CAPTURE_VERSION);
+        return false;
+    }
+
+    std::set<uint32> accounts;
+    while (buffer.size() - buffer.rpos() >= PACKET_CAPTURE_RECORD_SIZE)
+    {
+        ReplayRecord record;
+        uint16 size;
+        buffer >> record.time >> record.accountId >> record.opcode >> size;
+
+        if (buffer.size() - buffer.rpos() < size || record.opcode >= NUM_MSG_TYPES)
+        {
+            sLog.outLog(LOG_DEFAULT, "ERROR: PacketReplay: %s is truncated or damaged after %u records", fileName.c_str(), uint32(m_records.size()));
+            break;
+        }
+
+        record.payload.resize(size);
+        if (size)
+            buffer.read(&record.payload[0], size);
+
+        m_records.push_back(record);
+        accounts.insert(record.accountId);
+    }
+
+    // records of different threads interleave, keep per account order but queue by time
+    std::stable_sort(m_records.begin(), m_records.end(), RecordTimeLess);
+
+    m_accounts.assign(accounts.begin(), accounts.end());
+    return !m_records.empty();
+}
+
+void PacketReplay::Update()
+{
+    if (!m_running)
+        return;
+
+    // sessions are added to world during next sessions update
+    if (!m_startTime)
+    {
+        m_startTime = WorldTimer::getMSTime();
+        return;
+    }
+
+    uint32 elapsed = uint32(WorldTimer::getMSTimeDiffToNow(m_startTime) * m_speed);
+    for (; m_next < m_records.size() && m_records[m_next].time <= elapsed; ++m_next)
+    {
+        ReplayRecord const& record = m_records[m_next];
+
+        WorldSession* session = sWorld.FindSession(record.accountId);
+        if (!session || !session->IsReplay())
+        {
+            ++m_skipped;
+            continue;
+        }
+
+        WorldPacket* packet = new WorldPacket(record.opcode, record.payload.size());
+        if (!record.payload.empty())
+            packet->append(&record.payload[0], record.payload.size());
+
+        session->QueuePacket(packet);
+        ++m_queued;
+    }
+
+    if (m_next < m_records.size())
+        return;
+
+    if (!m_drainTime)
+        m_drainTime = WorldTimer::getMSTime();
+    else if (WorldTimer::getMSTimeDiffToNow(m_drainTime) >= PACKET_REPLAY_DRAIN_TIME)
+        Finish();
+}
+
+void PacketReplay::Finish()
+{
+    m_running = false;
+    m_duration = m_startTime ? WorldTimer::getMSTimeDiffToNow(m_startTime) : 0;
+
+    // sessions without socket and replay flag log out on next update
+    for (std::vector<uint32>::const_iterator itr = m_accounts.begin(); itr != m_accounts.end(); ++itr)
+    {
+        WorldSession* session = sWorld.FindSession(*itr);
+        if (session && session->IsReplay())
+            session->SetReplay(false);
+    }
+
+    std::vector<std::string> lines;
+    BuildReport(lines);
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        sLog.outString("PacketReplay: %s", itr->c_str());
+
+    m_records.clear();
+
+    if (m_shutdownWhenDone)
+        World::StopNow(SHUTDOWN_EXIT_CODE);
+}
+
+void PacketReplay::RecordTick(uint32 usTime)
+{
+    if (m_running && m_startTime)
+        m_ticks.push_back(usTime);
+}
+
+void PacketReplay::RecordOpcode(uint16 opcode, uint32 usTime)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    ++m_opcodeCount[opcode];
+    m_opcodeTime[opcode] += usTime;
+}
+
+void PacketReplay::RecordOutput(uint32 bytes)
+{
+    ++m_outputPackets;
+    m_outputBytes += bytes;
+}
+
+void PacketReplay::BuildReport(std::vector<std::string>& lines) const
+{
+    char buf[256];
+    uint32 duration = m_running ? (m_startTime ? WorldTimer::getMSTimeDiffToNow(m_startTime) : 0) : m_duration;
+
+    snprintf(buf, sizeof(buf), "%s %s: " UI64FMTD " of %u packets queued, " UI64FMTD " skipped, %u accounts, %.1f s at speed %.2f",
+        m_running ? "running" : "finished", m_fileName.c_str(), m_queued, m_total, m_skipped,
+        uint32(m_accounts.size()), duration / 1000.0f, m_speed);
+    lines.push_back(buf);
+
+    if (!m_ticks.empty())
+    {
+        std::vector<uint32> ticks(m_ticks);
+        std::sort(ticks.begin(), ticks.end());
+
+        uint32 last = ticks.size() - 1;
+        snprintf(buf, sizeof(buf), "world tick of %u ticks: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms", uint32(ticks.size()),
+            ticks[last * 50 / 100] / 1000.0f, ticks[last * 90 / 100] / 1000.0f, ticks[last * 99 / 100] / 1000.0f, ticks[last] / 1000.0f);
+        lines.push_back(buf);
+    }
+
+    snprintf(buf, sizeof(buf), "output: " UI64FMTD " packets, " UI64FMTD " bytes (%.1f KB/s)", uint64(m_outputPackets), uint64(m_outputBytes),
+        duration ? m_outputBytes / 1.024f / duration : 0.0f);
+    lines.push_back(buf);
+
+    // opcodes taking most of handling time
+    std::vector<std::pair<uint64, uint16> > opcodes;
+    for (uint16 i = 0; i < NUM_MSG_TYPES; ++i)
+        if (m_opcodeCount[i])
+            opcodes.push_back(std::make_pair(uint64(m_opcodeTime[i]), i));
+
+    std::sort(opcodes.rbegin(), opcodes.rend());
+    if (opcodes.size() > 10)
+        opcodes.resize(10);
+
+    for (std::vector<std::pair<uint64, uint16> >::const_iterator itr = opcodes.begin(); itr != opcodes.end(); ++itr)
+    {
+        uint64 count = m_opcodeCount[itr->second];
+        snprintf(buf, sizeof(buf), "%s: " UI64FMTD " packets, %.2f ms total, %.1f us avg",
+            LookupOpcodeName(itr->second), count, itr->first / 1000.0f, float(itr->first) / count);
+        lines.push_back(buf);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_PACKETREPLAY_H
+#define HELLGROUND_PACKETREPLAY_H
+
+#include "Common.h"
+#include "Opcodes.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <tbb/atomic.h>
+
+// time given to sessions to handle last replayed packets before report
+#define PACKET_REPLAY_DRAIN_TIME    (5*IN_MILISECONDS)
+
+/**
+ * PacketReplay - drives sessions with packets recorded by PacketCapture.
+ *
+ * Every captured account gets a session without socket, packets are queued to it by world
+ * thread at their captured time (scaled by speed) and handled by normal session updates,
+ * so server does the same work as for real clients. Meant for a server running against
+ * a copy of database from capture time: replay sessions replace sessions of live accounts.
+ *
+ * Collects world tick times, handling time of each opcode and packets sent to replay
+ * sessions, reported when the file is done.
+ */
+class PacketReplay
+{
+    public:
+        PacketReplay();
+
+        bool Start(std::string const& fileName, float speed, bool shutdownWhenDone);
+        void Stop();
+
+        bool IsRunning() const { return m_running; }
+
+        // world thread, before sessions update
+        void Update();
+
+        void RecordTick(uint32 usTime);
+        void RecordOpcode(uint16 opcode, uint32 usTime);
+        void RecordOutput(uint32 bytes);
+
+        void BuildReport(std::vector<std::string>& lines) const;
+
+        struct ReplayRecord
+        {
+            uint32 time;
+            uint32 accountId;
+            uint16 opcode;
+            std::vector<uint8> payload;
+        };
+
+    private:
+        bool Load(std::string const& fileName);
+        void Finish();
+
+        std::vector<ReplayRecord> m_records;
+        uint32 m_total;
+        std::vector<uint32> m_accounts;
+        size_t m_next;
+
+        std::string m_fileName;
+        float m_speed;
+        bool m_shutdownWhenDone;
+        bool m_running;
+        uint32 m_startTime;
+        uint32 m_drainTime;                                 // when last record was queued, 0 before
+        uint32 m_duration;
+
+        uint64 m_queued;
+        uint64 m_skipped;                                   // records of accounts whose session is gone
+        std::vector<uint32> m_ticks;
+
+        tbb::atomic<uint64> m_opcodeCount[NUM_MSG_TYPES];
+        tbb::atomic<uint64> m_opcodeTime[NUM_MSG_TYPES];
+        tbb::atomic<uint64> m_outputPackets;
+        tbb::atomic<uint64> m_outputBytes;
+};
+
+#define sPacketReplay (*ACE_Singleton<PacketReplay, ACE_Thread_Mutex>::instance())
+
+#endif
@@ -68,6 +68,7 @@
 #include "AccountMgr.h"
 #include "PlayerAI.h"
 #include "GuildMgr.h"
+#include "PlayerDirectory.h"
 
 #include <cmath>
 #include <cctype>
@@ -1998,6 +1999,8 @@ void Player::AddToWorld()
         if (m_items[i])
             m_items[i]->AddToWorld();
     }
+
+    sPlayerDirectory.UpdatePlayer(this);
 }
 
 void Player::RemoveFromWorld()
@@ -2014,6 +2017,7 @@ void Player::RemoveFromWorld()
     }
 
     sOutdoorPvPMgr.HandlePlayerLeave(this);
+    sPlayerDirectory.RemovePlayer(GetGUID());
 
     for (int i = PLAYER_SLOT_START; i < PLAYER_SLOT_END; i++)
     {
@@ -6439,6 +6443,14 @@ void Player::ModifyArenaPoints(int32 value)
         SetUInt32Value(PLAYER_FIELD_ARENA_CURRENCY, GetArenaPoints() < sWorld.getConfig(CONFIG_MAX_ARENA_POINTS) - value ? GetArenaPoints() + value : sWorld.getConfig(CONFIG_MAX_ARENA_POINTS));
 }
 
+void Player::SetInGuild(uint32 GuildId)
+{
+    SetUInt32Value(PLAYER_GUILDID, GuildId);
+
+    if (IsInWorld())
+        sPlayerDirectory.UpdatePlayer(this);
+}
+
 uint32 Player::GetGuildIdFromDB(uint64 guid)
 {
     std::ostringstream ss;
@@ -6587,24 +6599,13 @@ void Player::UpdateZone(uint32 newZone)
     {
         sOutdoorPvPMgr.HandlePlayerLeaveZone(this, oldZoneId);
         sOutdoorPvPMgr.HandlePlayerEnterZone(this, m_zoneUpdateId);
+
+        if (IsInWorld())
+            sPlayerDirectory.UpdatePlayer(this);
     }
 
     if (sWorld.getConfig(CONFIG_WEATHER))
-    {
-        Weather *wth = sWorld.FindWeather(zone->ID);
-        if (wth)
-        {
-            wth->SendWeatherUpdateToPlayer(this);
-        }
-        else
-        {
-            if (!sWorld.AddWeather(zone->ID))
-            {
-                // send fine weather packet to remove old zone's weather
-                Weather::SendFineWeatherUpdateToPlayer(this);
-            }
-        }
-    }
+        sWorld.SendZoneWeather(this, zone->ID);
 
     pvpInfo.inHostileArea =
         GetTeam() == ALLIANCE && zone->team == AREATEAM_HORDE ||
@@ -15261,6 +15262,7 @@ void Player::_LoadActions(QueryResultAutoPtr result)
 void Player::_LoadAuras(QueryResultAutoPtr result, uint32 timediff)
 {
     m_Auras.clear();
+    m_procAuras.clear();
     for (int i = 0; i < TOTAL_AURAS; i++)
         m_modAuras[i].clear();
 
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "PlayerDirectory.h"
+#include "Player.h"
+#include "GuildMgr.h"
+#include "World.h"
+#include "WorldPacket.h"
+#include "GridMap.h"
+#include "DBCStores.h"
+#include "Util.h"
+
+#include <algorithm>
+
+PlayerDirectory::PlayerDirectory() : m_changed(false)
+{
+    m_snapshot = new PlayerDirectorySnapshot();
+    m_publishTimer.SetInterval(PLAYER_DIRECTORY_PUBLISH_INTERVAL);
+}
+
+PlayerDirectory::~PlayerDirectory()
+{
+    delete m_snapshot;
+}
+
+void PlayerDirectory::UpdatePlayer(Player* player)
+{
+    PlayerDirectoryEntry entry;
+    entry.guid = player->GetGUID();
+    entry.name = player->GetName();
+    entry.guildId = player->GetGuildId();
+    entry.level = player->getLevel();
+    entry.playerClass = player->getClass();
+    entry.race = player->getRace();
+    entry.gender = player->getGender();
+    entry.teamId = player->GetTeamId();
+    entry.visibility = player->GetVisibility();
+    entry.zoneId = player->GetCachedZone();
+    entry.arenaZoneId = 0;
+    entry.permissions = player->GetSession()->GetPermissions();
+    entry.removed = false;
+
+    if (player->InArena())
+        entry.arenaZoneId = sTerrainMgr.GetZoneId(player->GetBattleGroundEntryPointMap(), player->GetBattleGroundEntryPointX(),
+            player->GetBattleGroundEntryPointY(), player->GetBattleGroundEntryPointZ());
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_pendingLock);
+    m_pending.push_back(entry);
+}
+
+void PlayerDirectory::RemovePlayer(uint64 guid)
+{
+    PlayerDirectoryEntry entry;
+    entry.guid = guid;
+    entry.removed = true;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_pendingLock);
+    m_pending.push_back(entry);
+}
+
+void PlayerDirectory::Update(uint32 diff)
+{
+    std::vector<PlayerDirectoryEntry> pending;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_pendingLock);
+        pending.swap(m_pending);
+    }
+
+    for (std::vector<PlayerDirectoryEntry>::iterator itr = pending.begin(); itr != pending.end(); ++itr)
+    {
+        m_changed = true;
+
+        if (itr->removed)
+        {
+            m_entries.erase(itr->guid);
+            continue;
+        }
+
+        EntryMap::iterator existing = m_entries.find(itr->guid);
+        if (existing != m_entries.end())
+        {
+            // names are converted only when they change
+            if (existing->second.name == itr->name)
+                itr->wname.swap(existing->second.wname);
+
+            if (existing->second.guildId == itr->guildId)
+            {
+                itr->guildName.swap(existing->second.guildName);
+                itr->wguildName.swap(existing->second.wguildName);
+            }
+        }
+
+        if (itr->wname.empty() && Utf8toWStr(itr->name, itr->wname))
+            wstrToLower(itr->wname);
+
+        if (itr->guildId && itr->guildName.empty())
+        {
+            itr->guildName = sGuildMgr.GetGuildNameById(itr->guildId);
+            if (Utf8toWStr(itr->guildName, itr->wguildName))
+                wstrToLower(itr->wguildName);
+        }
+
+        m_entries[itr->guid] = *itr;
+    }
+
+    m_publishTimer.Update(diff);
+    if (!m_changed || !m_publishTimer.Passed())
+        return;
+
+    m_publishTimer.SetCurrent(0);
+    m_changed = false;
+
+    Publish();
+}
+
+void PlayerDirectory::Publish()
+{
+    PlayerDirectorySnapshot* snapshot = new PlayerDirectorySnapshot();
+    snapshot->arenaZonesHidden = sWorld.getConfig(CONFIG_ENABLE_FAKE_WHO_ON_ARENA);
+
+    for (EntryMap::const_iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+    {
+        if (itr->second.teamId < PLAYER_DIRECTORY_TEAMS)
+            snapshot->players[itr->second.teamId].push_back(itr->second);
+    }
+
+    for (uint8 team = 0; team < PLAYER_DIRECTORY_TEAMS; ++team)
+    {
+        PlayerDirectorySnapshot::EntryList& players = snapshot->players[team];
+        std::stable_sort(players.begin(), players.end());
+
+        for (uint32 i = 0; i < players.size(); ++i)
+        {
+            uint32 zoneId = snapshot->arenaZonesHidden && players[i].arenaZoneId ? players[i].arenaZoneId : players[i].zoneId;
+            snapshot->zones[team][zoneId].push_back(i);
+        }
+    }
+
+    PlayerDirectorySnapshot const* old = m_snapshot.fetch_and_store(snapshot);
+
+    // called between map updates, nobody reads old snapshot anymore
+    delete old;
+}
+
+// same rules as Player::IsVisibleGloballyfor
+static bool IsVisibleInWhoList(PlayerDirectoryEntry const& entry, WhoListQuery const& query)
+{
+    if (entry.guid == query.viewerGuid)
+        return true;
+
+    if (entry.visibility == VISIBILITY_ON)
+        return true;
+
+    if (query.viewerPermissions & PERM_GMT_HDEV)
+        return entry.permissions <= query.viewerPermissions;
+
+    return entry.visibility != VISIBILITY_OFF;
+}
+
+uint32 PlayerDirectory::BuildWhoList(WhoListQuery const& query, WorldPacket& data) const
+{
+    PlayerDirectorySnapshot const* snapshot = m_snapshot;
+
+    bool staff = query.viewerPermissions & PERM_GMT_HDEV;
+    bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
+    bool gmInWhoList = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
+    bool showArenaZones = query.viewerGameMaster || !snapshot->arenaZonesHidden;
+    uint32 maxCount = sWorld.getConfig(CONFIG_MAX_WHO);
+
+    bool hasStrings = false;
+    for (uint32 i = 0; i < query.strings.size(); ++i)
+        hasStrings = hasStrings || !query.strings[i].empty();
+
+    // area names are matched once per zone, not once per player
+    std::map<uint32, bool> zoneFitsStrings;
+
+    uint32 count = 0;
+    std::vector<uint32> indexes;
+
+    for (uint8 team = 0; team < PLAYER_DIRECTORY_TEAMS; ++team)
+    {
+        if (team != query.viewerTeamId && !staff && !allowTwoSideWhoList)
+            continue;
+
+        PlayerDirectorySnapshot::EntryList const& players = snapshot->players[team];
+
+        // candidates: zone index when asked for zones it was built for, otherwise level range
+        indexes.clear();
+        if (!query.zones.empty() && !(snapshot->arenaZonesHidden && query.viewerGameMaster))
+        {
+            for (std::vector<uint32>::const_iterator zone = query.zones.begin(); zone != query.zones.end(); ++zone)
+            {
+                PlayerDirectorySnapshot::ZoneIndex::const_iterator itr = snapshot->zones[team].find(*zone);
+                if (itr != snapshot->zones[team].end())
+                    indexes.insert(indexes.end(), itr->second.begin(), itr->second.end());
+            }
+
+            std::sort(indexes.begin(), indexes.end());
+            indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+        }
+        else
+        {
+            PlayerDirectoryEntry bound;
+            bound.level = query.levelMin;
+            uint32 first = std::lower_bound(players.begin(), players.end(), bound) - players.begin();
+            bound.level = query.levelMax;
+            uint32 last = std::upper_bound(players.begin(), players.end(), bound) - players.begin();
+
+            for (uint32 i = first; i < last; ++i)
+                indexes.push_back(i);
+        }
+
+        for (std::vector<uint32>::const_iterator idx = indexes.begin(); idx != indexes.end(); ++idx)
+        {
+            PlayerDirectoryEntry const& entry = players[*idx];
+
+            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
+            if (!staff && (entry.permissions & PERM_GMT) && !gmInWhoList)
+                continue;
+
+            if (!IsVisibleInWhoList(entry, query))
+                continue;
+
+            if (entry.level < query.levelMin || entry.level > query.levelMax)
+                continue;
+
+            if (!(query.classMask & (1 << entry.playerClass)) || !(query.raceMask & (1 << entry.race)))
+                continue;
+
+            uint32 zoneId = !showArenaZones && entry.arenaZoneId ? entry.arenaZoneId : entry.zoneId;
+            if (!query.zones.empty() && std::find(query.zones.begin(), query.zones.end(), zoneId) == query.zones.end())
+                continue;
+
+            if (!query.playerName.empty() && entry.wname.find(query.playerName) == std::wstring::npos)
+                continue;
+
+            if (!query.guildName.empty() && entry.wguildName.find(query.guildName) == std::wstring::npos)
+                continue;
+
+            if (hasStrings)
+            {
+                bool show = false;
+                for (uint32 i = 0; i < query.strings.size() && !show; ++i)
+                {
+                    if (!query.strings[i].empty())
+                        show = entry.wguildName.find(query.strings[i]) != std::wstring::npos || entry.wname.find(query.strings[i]) != std::wstring::npos;
+                }
+
+                if (!show)
+                {
+                    std::map<uint32, bool>::iterator fits = zoneFitsStrings.find(zoneId);
+                    if (fits == zoneFitsStrings.end())
+                    {
+                        std::string areaName;
+                        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(zoneId))
+                            areaName = areaEntry->area_name[query.viewerLocale];
+
+                        bool fit = false;
+                        for (uint32 i = 0; i < query.strings.size() && !fit; ++i)
+                            fit = !query.strings[i].empty() && Utf8FitTo(areaName, query.strings[i]);
+
+                        fits = zoneFitsStrings.insert(std::make_pair(zoneId, fit)).first;
+                    }
+
+                    show = fits->second;
+                }
+
+                if (!show)
+                    continue;
+            }
+
+            data << entry.name;                             // player name
+            data << entry.guildName;                        // guild name
+            data << uint32(entry.level);                    // player level
+            data << uint32(entry.playerClass);              // player class
+            data << uint32(entry.race);                     // player race
+            data << uint8(entry.gender);                    // player gender
+            data << uint32(zoneId);                         // player zone id
+
+            // 49 is maximum player count sent to client - can be overridden
+            // through config, but is unstable
+            if (++count == maxCount)
+                return count;
+        }
+    }
+
+    return count;
+}
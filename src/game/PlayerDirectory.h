@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_PLAYERDIRECTORY_H
+#define HELLGROUND_PLAYERDIRECTORY_H
+
+#include "Common.h"
+#include "Timer.h"
+#include "SharedDefines.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <tbb/atomic.h>
+
+class Player;
+class WorldPacket;
+
+// how often collected changes are published to /who readers (in milliseconds)
+#define PLAYER_DIRECTORY_PUBLISH_INTERVAL 1000
+
+#define PLAYER_DIRECTORY_TEAMS 2                            // TEAM_ALLIANCE, TEAM_HORDE
+
+struct PlayerDirectoryEntry
+{
+    uint64 guid;
+    std::string name;
+    std::wstring wname;                                     // lower case, filled by world thread
+    uint32 guildId;
+    std::string guildName;
+    std::wstring wguildName;                                // lower case, filled by world thread
+    uint32 level;
+    uint8 playerClass;
+    uint8 race;
+    uint8 gender;
+    uint8 teamId;
+    uint8 visibility;
+    uint32 zoneId;
+    uint32 arenaZoneId;                                     // zone of arena entry point while in arena
+    uint64 permissions;
+    bool removed;                                           // only in pending changes
+
+    bool operator<(PlayerDirectoryEntry const& other) const { return level < other.level; }
+};
+
+// parsed CMSG_WHO request with data of player asking
+struct WhoListQuery
+{
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 raceMask;
+    uint32 classMask;
+    std::vector<uint32> zones;
+    std::wstring playerName;                                // lower case
+    std::wstring guildName;                                 // lower case
+    std::vector<std::wstring> strings;                      // lower case
+
+    uint64 viewerGuid;
+    uint64 viewerPermissions;
+    uint8 viewerTeamId;
+    bool viewerGameMaster;                                  // in gm mode, sees real zones of arena players
+    LocaleConstant viewerLocale;
+};
+
+/// Immutable view of online players, sorted by level per team with zone index
+struct PlayerDirectorySnapshot
+{
+    typedef std::vector<PlayerDirectoryEntry> EntryList;
+    typedef UNORDERED_MAP<uint32, std::vector<uint32> > ZoneIndex;
+
+    EntryList players[PLAYER_DIRECTORY_TEAMS];
+    ZoneIndex zones[PLAYER_DIRECTORY_TEAMS];                // zone -> indexes into players, ascending
+    bool arenaZonesHidden;                                  // zone index uses entry point zone for arena players
+};
+
+/**
+ * PlayerDirectory - online player list for /who.
+ *
+ * Players push their who data whenever it changes (entering/leaving world, level, zone,
+ * guild or visibility change) from their own thread. World thread applies the changes,
+ * lowercases names once and publishes new snapshot every PLAYER_DIRECTORY_PUBLISH_INTERVAL.
+ * /who requests read the published snapshot without taking any lock, so they no longer
+ * scan all players under HashMapHolder<Player> lock.
+ *
+ * Snapshot is replaced only in serial part of world tick, when no session is updated,
+ * so a reader can use it for the whole packet handler.
+ */
+class PlayerDirectory
+{
+    friend class ACE_Singleton<PlayerDirectory, ACE_Thread_Mutex>;
+    PlayerDirectory();
+    ~PlayerDirectory();
+
+    public:
+        void UpdatePlayer(Player* player);
+        void RemovePlayer(uint64 guid);
+
+        // world thread only, outside of map updates
+        void Update(uint32 diff);
+
+        // fills SMSG_WHO body and returns number of listed players
+        uint32 BuildWhoList(WhoListQuery const& query, WorldPacket& data) const;
+
+    private:
+        void Publish();
+
+        ACE_Thread_Mutex m_pendingLock;
+        std::vector<PlayerDirectoryEntry> m_pending;
+
+        // world thread only
+        typedef UNORDERED_MAP<uint64, PlayerDirectoryEntry> EntryMap;
+        EntryMap m_entries;
+        bool m_changed;
+        ShortIntervalTimer m_publishTimer;
+
+        tbb::atomic<PlayerDirectorySnapshot const*> m_snapshot;
+};
+
+#define sPlayerDirectory (*ACE_Singleton<PlayerDirectory, ACE_Thread_Mutex>::instance())
+
+#endif
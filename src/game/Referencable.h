@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_REFERENCABLE_H
+#define HELLGROUND_REFERENCABLE_H
+
+#include "Platform/Define.h"
+#include "ace/Atomic_Op.h"
+#include "ace/Thread_Mutex.h"
+
+template<typename Countable>
+class HELLGROUND_IMPORT_EXPORT Referencable
+{
+    public:
+        Referencable() { m_count = 0; }
+
+        void AddRef() { ++m_count; }
+        bool Release() { return (--m_count < 1); }
+        bool IsReferenced() const { return (m_count > 0); }
+
+    private:
+        Referencable(const Referencable&);
+        Referencable& operator=(const Referencable&);
+
+        Countable m_count;
+};
+
+typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicLong;
+
+#endif
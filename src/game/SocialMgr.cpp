@@ -33,6 +33,7 @@
 PlayerSocial::PlayerSocial()
 {
     m_playerGUID = 0;
+    memset(m_ignoreFilter, 0, sizeof(m_ignoreFilter));
 }
 
 PlayerSocial::~PlayerSocial()
@@ -82,6 +83,9 @@ bool PlayerSocial::AddToSocialList(uint32 friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid] = fi;
     }
+
+    if (ignore)
+        UpdateIgnoreFilter();
     return true;
 }
 
@@ -105,6 +109,9 @@ void PlayerSocial::RemoveFromSocialList(uint32 friend_guid, bool ignore)
     {
         RealmDataDatabase.PExecute("UPDATE character_social SET flags = (flags & ~%u) WHERE guid = '%u' AND friend = '%u'", flag, GetPlayerGUID(), friend_guid);
     }
+
+    if (ignore)
+        UpdateIgnoreFilter();
 }
 
 void PlayerSocial::SetFriendNote(uint32 friend_guid, std::string note)
@@ -163,8 +170,27 @@ bool PlayerSocial::HasFriend(uint32 friend_guid)
     return false;
 }
 
+void PlayerSocial::UpdateIgnoreFilter()
+{
+    memset(m_ignoreFilter, 0, sizeof(m_ignoreFilter));
+
+    for (PlayerSocialMap::const_iterator itr = m_playerSocialMap.begin(); itr != m_playerSocialMap.end(); ++itr)
+    {
+        if (!(itr->second.Flags & SOCIAL_FLAG_IGNORED))
+            continue;
+
+        uint32 hash = IgnoreFilterHash(itr->first);
+        uint8 a = hash >> 24, b = (hash >> 16) & 0xFF;
+        m_ignoreFilter[a >> 6] |= uint64(1) << (a & 63);
+        m_ignoreFilter[b >> 6] |= uint64(1) << (b & 63);
+    }
+}
+
 bool PlayerSocial::HasIgnore(uint32 ignore_guid)
 {
+    if (!MayIgnore(ignore_guid))
+        return false;
+
     PlayerSocialMap::iterator itr = m_playerSocialMap.find(ignore_guid);
     if (itr != m_playerSocialMap.end())
         return itr->second.Flags & SOCIAL_FLAG_IGNORED;
@@ -331,6 +357,8 @@ PlayerSocial *SocialMgr::LoadFromDB(QueryResultAutoPtr result, uint32 guid)
             break;
     }
     while (result->NextRow());
+
+    social->UpdateIgnoreFilter();
     return social;
 }
 
@@ -134,8 +134,19 @@ class PlayerSocial
         void SetPlayerGUID(uint32 guid) { m_playerGUID = guid; }
         uint32 GetNumberOfSocialsWithFlag(SocialFlag flag);
     private:
+        // ignored guids set 2 of 256 bits, chat broadcasts look into social map only when both are set
+        void UpdateIgnoreFilter();
+        static uint32 IgnoreFilterHash(uint32 guid) { return guid * 2654435761u; }
+        bool MayIgnore(uint32 guid) const
+        {
+            uint32 hash = IgnoreFilterHash(guid);
+            uint8 a = hash >> 24, b = (hash >> 16) & 0xFF;
+            return (m_ignoreFilter[a >> 6] & (uint64(1) << (a & 63))) && (m_ignoreFilter[b >> 6] & (uint64(1) << (b & 63)));
+        }
+
         PlayerSocialMap m_playerSocialMap;
         uint32 m_playerGUID;
+        uint64 m_ignoreFilter[4];
 };
 
 class SocialMgr
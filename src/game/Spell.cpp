@@ -277,6 +277,7 @@ Spell::Spell(Unit* Caster, SpellEntry const *info, bool triggered, uint64 origin
 {
     m_spellState = SPELL_STATE_NULL;
     m_skipCheck = skipCheck;
+    m_targetsLoSChecked = false;
     m_selfContainer = NULL;
     m_triggeringContainer = triggeringContainer;
     m_referencedFromCurrentSpell = false;
@@ -1458,8 +1459,11 @@ void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const u
     {
         case SPELL_TARGET_TYPE_NONE:
         {
+            std::vector<Unit*> candidates;
+            SearchAreaCandidates(candidates, radius, type, TargetType, x, y, z);
+
             Hellground::SpellNotifierCreatureAndPlayer notifier(*this, TagUnitMap, radius, type, TargetType, entry, x, y, z);
-            Cell::VisitAllObjects(x, y, m_caster->GetMap(), notifier, radius);
+            notifier.Visit(candidates);
             if ((GetSpellEntry()->AttributesEx3 & SPELL_ATTR_EX3_PLAYERS_ONLY))
                 TagUnitMap.remove_if(Hellground::ObjectTypeIdCheck(TYPEID_PLAYER, false)); // above line will select also pets and totems, remove them
             break;
@@ -1469,8 +1473,11 @@ void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const u
             if (!entry)
                 break;
 
+            std::vector<Unit*> candidates;
+            SearchAreaCandidates(candidates, radius, type, TargetType, x, y, z);
+
             Hellground::SpellNotifierCreatureAndPlayer notifier(*this, TagUnitMap, radius, type, TargetType, entry, x, y, z);
-            Cell::VisitAllObjects(x, y, m_caster->GetMap(), notifier, radius);
+            notifier.Visit(candidates);
             break;
         }
         case SPELL_TARGET_TYPE_DEAD:
@@ -1489,6 +1496,22 @@ void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const u
     TagUnitMap.remove_if(Hellground::ObjectIsTotemCheck(true)); // totems should not be affected by AoE spells (check if no exceptions?)
 }
 
+void Spell::SearchAreaCandidates(std::vector<Unit*> &units, float radius, const uint32 type, SpellTargets TargetType, float x, float y, float z)
+{
+    uint32 typeMask = (GetSpellEntry()->AttributesEx3 & SPELL_ATTR_EX3_PLAYERS_ONLY) ? TYPEMASK_PLAYER : TYPEMASK_UNIT;
+
+    // SpellNotifierCreatureAndPlayer measures these from caster with model sizes, so take candidates around caster
+    if (type == PUSH_IN_FRONT || type == PUSH_IN_BACK || type == PUSH_IN_LINE || (type == PUSH_SRC_CENTER && TargetType != SPELL_TARGETS_ENTRY))
+    {
+        x = m_caster->GetPositionX();
+        y = m_caster->GetPositionY();
+        z = m_caster->GetPositionZ();
+        radius += m_caster->GetObjectSize();
+    }
+
+    m_caster->GetMap()->GetUnitIndex().GetUnitsInRange(x, y, z, radius, typeMask, units);
+}
+
 void Spell::SearchAreaTarget(std::list<GameObject*> &goList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry, SpellScriptTargetType spellScriptTargetType)
 {
     float x, y, z;
@@ -2210,8 +2233,15 @@ void Spell::SetTargetMap(uint32 i, uint32 cur)
             if (m_spellValue->MaxAffectedTargets)
                 Hellground::RandomResizeList(unitList, m_spellValue->MaxAffectedTargets);
 
+            // whole area is checked in one vmap query instead of one per target in CheckTarget
+            m_targetsLoSChecked = HasDefaultTargetLoSCheck(i);
+            if (m_targetsLoSChecked)
+                m_caster->FilterWithinLOS(unitList);
+
             for (std::list<Unit*>::iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
                 AddUnitTarget(*itr, i);
+
+            m_targetsLoSChecked = false;
         }
 
         if (!goList.empty())
@@ -5543,7 +5573,7 @@ bool Spell::CheckTarget(Unit* target, uint32 eff)
             // all ok by some way or another, skip normal check
             break;
         default:                                            // normal case
-            if (target!=m_caster && !SpellMgr::SpellIgnoreLOS(GetSpellEntry(), eff) && !target->IsWithinLOSInMap(m_caster))
+            if (target!=m_caster && !m_targetsLoSChecked && !SpellMgr::SpellIgnoreLOS(GetSpellEntry(), eff) && !target->IsWithinLOSInMap(m_caster))
                 return false;
 
             break;
@@ -5552,6 +5582,25 @@ bool Spell::CheckTarget(Unit* target, uint32 eff)
     return true;
 }
 
+// CheckTarget tests line of sight between target and caster only in its "normal case"
+bool Spell::HasDefaultTargetLoSCheck(uint32 eff) const
+{
+    if (IsTriggeredSpell() && !m_caster->ToTotem())
+        return false;
+
+    switch (GetSpellEntry()->Effect[eff])
+    {
+        case SPELL_EFFECT_FRIEND_SUMMON:
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_DUMMY:
+        case SPELL_EFFECT_RESURRECT:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return false;
+        default:
+            return !SpellMgr::SpellIgnoreLOS(GetSpellEntry(), eff);
+    }
+}
+
 Unit* Spell::SelectMagnetTarget()
 {
     Unit* target = m_targets.getUnitTarget();
@@ -405,6 +405,7 @@ class Spell
         Unit* SelectMagnetTarget();
         void HandleHitTriggerAura();
         bool CheckTarget(Unit* target, uint32 eff);
+        bool HasDefaultTargetLoSCheck(uint32 eff) const;
         bool CanAutoCast(Unit* target);
         bool CanIgnoreNotAttackableFlags();
 
@@ -614,6 +615,7 @@ class Spell
         void SearchAreaTarget(std::list<Unit*> &unitList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry = 0, SpellScriptTargetType spellScriptTargetType = SPELL_TARGET_TYPE_NONE);
         void SearchAreaTarget(std::list<GameObject*> &goList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry = 0, SpellScriptTargetType spellScriptTargetType = SPELL_TARGET_TYPE_NONE);
         void SearchChainTarget(std::list<Unit*> &unitList, float radius, uint32 unMaxTargets, SpellTargets TargetType);
+        void SearchAreaCandidates(std::vector<Unit*> &units, float radius, const uint32 type, SpellTargets TargetType, float x, float y, float z);
         WorldObject* SearchNearbyTarget(float range, SpellTargets TargetType);
         bool IsValidSingleTargetEffect(Unit const* target, Targets type) const;
         bool IsValidSingleTargetSpell(Unit const* target) const;
@@ -647,6 +649,7 @@ class Spell
         SpellEntry const* m_spellInfo;
 
         bool m_skipCheck;
+        bool m_targetsLoSChecked;                           // area targets already filtered by line of sight
 
         PathFinder _path;
 };
@@ -756,74 +759,89 @@ namespace Hellground
                 return;
 
             for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
-            {
-                if (!itr->getSource()->isAlive() || (itr->getSource()->GetTypeId() == TYPEID_PLAYER && ((Player*)itr->getSource())->IsTaxiFlying()))
-                    continue;
+                Check(itr->getSource());
+        }
 
-                if (itr->getSource()->m_invisibilityMask && itr->getSource()->m_invisibilityMask & (1 << 10) && !i_caster->canDetectInvisibilityOf(itr->getSource(), i_caster))
-                    continue;
+        // candidates from map unit index, same checks as grid visit
+        inline void Visit(std::vector<Unit*> &units)
+        {
+            ASSERT(i_data);
 
-                switch (i_TargetType)
+            if (!i_caster)
+                return;
+
+            for (std::vector<Unit*>::iterator itr = units.begin(); itr != units.end(); ++itr)
+                Check(*itr);
+        }
+
+        inline void Check(Unit* target)
+        {
+            if (!target->isAlive() || (target->GetTypeId() == TYPEID_PLAYER && ((Player*)target)->IsTaxiFlying()))
+                return;
+
+            if (target->m_invisibilityMask && target->m_invisibilityMask & (1 << 10) && !i_caster->canDetectInvisibilityOf(target, i_caster))
+                return;
+
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_ALLY:
+                    if (!target->isTargetableForAttack() || !i_caster->IsFriendlyTo(target))
+                        return;
+                    break;
+                case SPELL_TARGETS_ENEMY:
                 {
-                    case SPELL_TARGETS_ALLY:
-                        if (!itr->getSource()->isTargetableForAttack() || !i_caster->IsFriendlyTo(itr->getSource()))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_ENEMY:
-                    {
-                        if (itr->getSource()->GetTypeId()==TYPEID_UNIT && ((Creature*)itr->getSource())->isTotem())
-                            continue;
-                        if (!itr->getSource()->isTargetableForAttack())
-                            continue;
+                    if (target->GetTypeId()==TYPEID_UNIT && ((Creature*)target)->isTotem())
+                        return;
+                    if (!target->isTargetableForAttack())
+                        return;
 
-                        Unit* check = i_caster->GetCharmerOrOwnerOrSelf();
+                    Unit* check = i_caster->GetCharmerOrOwnerOrSelf();
 
-                        if (check->GetTypeId()==TYPEID_PLAYER)
-                        {
-                            if (check->IsFriendlyTo(itr->getSource()))
-                                continue;
-                        }
-                        else
-                        {
-                            if (!check->IsHostileTo(itr->getSource()))
-                                continue;
-                        }
-                    }break;
-                    case SPELL_TARGETS_ENTRY:
+                    if (check->GetTypeId()==TYPEID_PLAYER)
                     {
-                        if (itr->getSource()->GetEntry()!= i_entry)
-                            continue;
-                    }break;
-                    default: continue;
-                }
-
-                switch (i_push_type)
+                        if (check->IsFriendlyTo(target))
+                            return;
+                    }
+                    else
+                    {
+                        if (!check->IsHostileTo(target))
+                            return;
+                    }
+                }break;
+                case SPELL_TARGETS_ENTRY:
                 {
-                    case PUSH_IN_FRONT:
-                        if (i_caster->isInFront((Unit*)(itr->getSource()), i_radius, M_PI/3))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_BACK:
-                        if (i_caster->isInBack((Unit*)(itr->getSource()), i_radius, M_PI/3))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_LINE:
-                        if (i_caster->isInLine((Unit*)(itr->getSource()), i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    default:
-                        if (i_TargetType != SPELL_TARGETS_ENTRY && i_push_type == PUSH_SRC_CENTER && i_caster) // if caster then check distance from caster to target (because of model collision)
-                        {
-                            if (i_caster->IsWithinDistInMap(itr->getSource(), i_radius))
-                                i_data->push_back(itr->getSource());
-                        }
-                        else
-                        {
-                            if ((itr->getSource()->GetDistanceSq(i_x, i_y, i_z) < i_radiusSq))
-                                i_data->push_back(itr->getSource());
-                        }
-                        break;
-                }
+                    if (target->GetEntry()!= i_entry)
+                        return;
+                }break;
+                default: return;
+            }
+
+            switch (i_push_type)
+            {
+                case PUSH_IN_FRONT:
+                    if (i_caster->isInFront(target, i_radius, M_PI/3))
+                        i_data->push_back(target);
+                    break;
+                case PUSH_IN_BACK:
+                    if (i_caster->isInBack(target, i_radius, M_PI/3))
+                        i_data->push_back(target);
+                    break;
+                case PUSH_IN_LINE:
+                    if (i_caster->isInLine(target, i_radius))
+                        i_data->push_back(target);
+                    break;
+                default:
+                    if (i_TargetType != SPELL_TARGETS_ENTRY && i_push_type == PUSH_SRC_CENTER && i_caster) // if caster then check distance from caster to target (because of model collision)
+                    {
+                        if (i_caster->IsWithinDistInMap(target, i_radius))
+                            i_data->push_back(target);
+                    }
+                    else
+                    {
+                        if ((target->GetDistanceSq(i_x, i_y, i_z) < i_radiusSq))
+                            i_data->push_back(target);
+                    }
+                    break;
             }
         }
 
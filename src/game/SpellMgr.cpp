@@ -34,6 +34,8 @@ bool IsAreaEffectTarget[TOTAL_SPELL_TARGETS];
 
 SpellMgr::SpellMgr()
 {
+    mSpellProcTriggerGeneration = 0;
+
     for (int i = 0; i < TOTAL_SPELL_EFFECTS; ++i)
     {
         switch (i)
@@ -1368,6 +1370,7 @@ bool SpellMgr::IsAffectedBySpell(SpellEntry const *spellInfo, uint32 spellId, ui
 
 void SpellMgr::LoadSpellProcEvents()
 {
+    mSpellProcTriggerTable.clear();                         // points into map, drop before map reload
     mSpellProcEventMap.clear();                             // need for reload case
 
     uint32 count = 0;
@@ -1383,6 +1386,7 @@ void SpellMgr::LoadSpellProcEvents()
 
         sLog.outString();
         sLog.outString(">> Loaded %u spell proc event conditions", count );
+        BuildSpellProcTriggerTable();
         return;
     }
 
@@ -1434,6 +1438,8 @@ void SpellMgr::LoadSpellProcEvents()
     else
         sLog.outString(">> Loaded %u spell proc event conditions", count);
 
+    BuildSpellProcTriggerTable();
+
     /*
     // Commented for now, as it still produces many errors (still quite many spells miss spell_proc_event)
     for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
@@ -1464,6 +1470,32 @@ void SpellMgr::LoadSpellProcEvents()
     */
 }
 
+void SpellMgr::BuildSpellProcTriggerTable()
+{
+    ++mSpellProcTriggerGeneration;
+    mSpellProcTriggerTable.resize(sSpellStore.GetNumRows());
+
+    for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
+    {
+        SpellProcTriggerEntry& entry = mSpellProcTriggerTable[id];
+        entry.procEvent = NULL;
+        entry.procFlags = 0;
+
+        SpellEntry const* spellInfo = sSpellStore.LookupEntry(id);
+        if (!spellInfo)
+            continue;
+
+        SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(id);
+        if (itr != mSpellProcEventMap.end())
+            entry.procEvent = &itr->second;
+
+        if (entry.procEvent && entry.procEvent->procFlags)
+            entry.procFlags = entry.procEvent->procFlags;
+        else
+            entry.procFlags = spellInfo->procFlags;
+    }
+}
+
 /*
 bool SpellMgr::IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const * spellProcEvent, SpellEntry const * procSpell, uint32 procFlags)
 {
@@ -3522,6 +3554,9 @@ void SpellMgr::LoadSpellCustomAttr()
         }
     }
     CreatureAI::FillAISpellEntry();
+
+    // procFlags of some spells were changed above
+    BuildSpellProcTriggerTable();
 }
 
 // TODO: move this to database along with slot position in cast bar
@@ -240,6 +240,15 @@ struct SpellProcEventEntry
 
 typedef UNORDERED_MAP<uint32, SpellProcEventEntry> SpellProcEventMap;
 
+// proc data precompiled at load for every spell, indexed by spell id
+struct SpellProcTriggerEntry
+{
+    SpellProcEventEntry const* procEvent;                   // spell_proc_event data, NULL if spell has none
+    uint32      procFlags;                                  // spell_proc_event procFlags if set, else spell procFlags
+};
+
+typedef std::vector<SpellProcTriggerEntry> SpellProcTriggerTable;
+
 struct SpellEnchantProcEntry
 {
     uint32      customChance;
@@ -466,12 +475,21 @@ class HELLGROUND_IMPORT_EXPORT SpellMgr
         // Spell proc events
         SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const
         {
-            SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(spellId);
-            if (itr != mSpellProcEventMap.end())
-                return &itr->second;
+            if (spellId < mSpellProcTriggerTable.size())
+                return mSpellProcTriggerTable[spellId].procEvent;
             return NULL;
         }
 
+        SpellProcTriggerEntry const* GetSpellProcTrigger(uint32 spellId) const
+        {
+            if (spellId < mSpellProcTriggerTable.size())
+                return &mSpellProcTriggerTable[spellId];
+            return NULL;
+        }
+
+        // changes each time proc trigger table is rebuilt, units then reindex their proc auras
+        uint32 GetSpellProcTriggerGeneration() const { return mSpellProcTriggerGeneration; }
+
         static bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const * spellProcEvent, uint32 EventProcFlag, SpellEntry const * procSpell, uint32 procFlags, uint32 procExtra, bool active);
 
         SpellEnchantProcEntry const* GetSpellEnchantProcEvent(uint32 enchId) const
@@ -764,6 +782,7 @@ class HELLGROUND_IMPORT_EXPORT SpellMgr
         void LoadSpellAffects();
         void LoadSpellElixirs();
         void LoadSpellProcEvents();
+        void BuildSpellProcTriggerTable();
         void LoadSpellTargetPositions();
         void LoadSpellThreats();
         void LoadSkillLineAbilityMap();
@@ -785,6 +804,8 @@ class HELLGROUND_IMPORT_EXPORT SpellMgr
         SpellAffectMap     mSpellAffectMap;
         SpellElixirMap     mSpellElixirs;
         SpellProcEventMap  mSpellProcEventMap;
+        SpellProcTriggerTable mSpellProcTriggerTable;
+        uint32 mSpellProcTriggerGeneration;
         SkillLineAbilityMap mSkillLineAbilityMap;
         SpellPetAuraMap     mSpellPetAuraMap;
         SpellLinkedMap      mSpellLinkedMap;
@@ -24,6 +24,7 @@
 #include "Log.h"
 #include "ObjectAccessor.h"
 #include "CreatureAI.h"
+#include "ObjectMgr.h"
 
 TemporarySummon::TemporarySummon(uint64 summoner) :
 Creature(), m_type(TEMPSUMMON_TIMED_OR_CORPSE_DESPAWN), m_timer(0), m_lifetime(0), m_summoner(summoner)
@@ -31,6 +32,16 @@ Creature(), m_type(TEMPSUMMON_TIMED_OR_CORPSE_DESPAWN), m_timer(0), m_lifetime(0
      m_tempSummon = true;
 }
 
+TemporarySummon::~TemporarySummon()
+{
+    if (IsInWorld())
+        Creature::RemoveFromWorld();
+
+    // summons always get newly generated guid, values exist only after Create
+    if (m_uint32Values)
+        sObjectMgr.ReleaseLowGuid(HIGHGUID_UNIT, GetGUIDLow());
+}
+
 void TemporarySummon::Update(uint32 update_diff, uint32 diff)
 {
     if (m_deathState == DEAD)
@@ -28,11 +28,7 @@ class TemporarySummon : public Creature
 {
     public:
         explicit TemporarySummon(uint64 summoner = 0);
-        virtual ~TemporarySummon()
-        {
-            if (IsInWorld())
-                Creature::RemoveFromWorld();
-        }
+        virtual ~TemporarySummon();
         void Update(uint32 update_diff, uint32 time); 
         void Summon(TemporarySummonType type, uint32 lifetime);
         void UnSummon();
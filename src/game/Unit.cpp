@@ -55,7 +55,9 @@
 #include "MovementGenerator.h"
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
+#include "movement/MoveSplineBatch.h"
 #include "luaengine/HookMgr.h"
+#include "PlayerDirectory.h"
 
 #include <math.h>
 
@@ -266,6 +268,8 @@ Unit::Unit() :
     m_procDeep(0), m_AI_locked(false), m_removedAurasCount(0)
 {
     m_modAuras = new AuraList[TOTAL_AURAS];
+    m_modAurasHaveHoles = false;
+    m_procAurasGeneration = sSpellMgr.GetSpellProcTriggerGeneration();
     m_objectType |= TYPEMASK_UNIT;
     m_objectTypeId = TYPEID_UNIT;
                                                             // 2.3.2 - 0x70
@@ -363,6 +367,9 @@ Unit::Unit() :
     m_GMToSendCombatStats = 0;
 
     _AINotifyScheduled = false;
+    _visibilityUpdateScheduled = false;
+    m_unitIndexSlot = UNIT_INDEX_NO_SLOT;
+    m_unitIndexCell = 0;
 
     WorthHonor = false;
 }
@@ -391,11 +398,10 @@ Unit::~Unit()
 
     for (int i = 0; i < TOTAL_AURAS; i++)
     {
-        while (!m_modAuras[i].empty())
-        {
-            delete m_modAuras[i].front();
-            m_modAuras[i].pop_front();
-        }
+        for (AuraList::const_iterator itr = m_modAuras[i].begin(); itr != m_modAuras[i].end(); ++itr)
+            delete *itr;
+
+        m_modAuras[i].clear();
     }
 
     delete [] m_modAuras;
@@ -532,6 +538,12 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
     if (m_movesplineTimer.Passed() || arrived)
     {
         m_movesplineTimer.Reset(POSITION_UPDATE_DELAY);
+
+        // creatures on the way are relocated by map, together with other moving creatures
+        if (!arrived && GetTypeId() == TYPEID_UNIT && sWorld.getConfig(CONFIG_MOVEMENT_BATCH_SPLINES) && IsInWorld() &&
+            GetMap()->GetMoveSplineBatch().Add(*movespline, GetGUID()))
+            return;
+
         Movement::Location loc = movespline->ComputePosition();
 
         if (GetTypeId() == TYPEID_PLAYER)
@@ -3239,11 +3251,27 @@ uint32 Unit::GetWeaponSkillValue (WeaponAttackType attType, Unit const* target)
 
 void Unit::_DeleteAuras()
 {
-    while (!m_removedAuras.empty())
+    // single pass, popping front of slot list rescans every cleared slot before it
+    for (AuraList::const_iterator itr = m_removedAuras.begin(); itr != m_removedAuras.end(); ++itr)
+        delete *itr;
+
+    m_removedAuras.clear();
+}
+
+void Unit::_CompactAuraLists()
+{
+    if (m_modAurasHaveHoles)
     {
-        delete m_removedAuras.front();
-        m_removedAuras.pop_front();
+        for (int i = 0; i < TOTAL_AURAS; ++i)
+            m_modAuras[i].Compact();
+
+        m_modAurasHaveHoles = false;
     }
+
+    m_scAuras.Compact();
+    m_interruptableAuras.Compact();
+    m_ccAuras.Compact();
+    m_removedAuras.Compact();
 }
 
 void Unit::_UpdateSpells(uint32 time)
@@ -3261,6 +3289,9 @@ void Unit::_UpdateSpells(uint32 time)
         }
     }
 
+    // no aura list is iterated at this point
+    _CompactAuraLists();
+
     // m_AurasUpdateIterator can be updated in inderect called code at aura remove to skip next planned to update but removed auras
     AuraMap::iterator eraseIter;
     for (m_AurasUpdateIterator = m_Auras.begin(); m_AurasUpdateIterator != m_Auras.end();)
@@ -3947,6 +3978,7 @@ bool Unit::AddAura(Aura *Aur)
     // add aura, register in lists and arrays
     Aur->_AddAura();
     m_Auras.insert(AuraMap::value_type(spellEffectPair(Aur->GetId(), Aur->GetEffIndex()), Aur));
+    _RegisterProcAura(Aur);
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].push_back(Aur);
@@ -4517,6 +4549,7 @@ void Unit::RemoveAura(AuraMap::iterator &i, AuraRemoveMode mode)
     // some ShapeshiftBoosts at remove trigger removing other auras including parent Shapeshift aura
     // remove aura from list before to prevent deleting it before
     m_Auras.erase(i);
+    _UnregisterProcAura(Aur);
     ++m_removedAurasCount;                                       // internal count used by unit update
 
     SpellEntry const* AurSpellEntry = Aur->GetSpellProto();
@@ -4527,6 +4560,7 @@ void Unit::RemoveAura(AuraMap::iterator &i, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur); //**
+        m_modAurasHaveHoles = true;
 
         if (Aur->GetSpellProto()->AuraInterruptFlags)
         {
@@ -9757,6 +9791,9 @@ void Unit::SetVisibility(UnitVisibility x)
 {
     m_Visibility = x;
 
+    if (GetTypeId() == TYPEID_PLAYER && IsInWorld())
+        sPlayerDirectory.UpdatePlayer((Player*)this);
+
     switch (x)
     {
         case VISIBILITY_OFF:
@@ -10691,6 +10728,9 @@ void Unit::SetLevel(uint32 lvl)
     // group update
     if ((GetTypeId() == TYPEID_PLAYER) && ((Player*)this)->GetGroup())
         ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+
+    if (GetTypeId() == TYPEID_PLAYER && IsInWorld())
+        sPlayerDirectory.UpdatePlayer((Player*)this);
 }
 
 void Unit::SetHealth(uint32 val, bool ignoreAliveCheck)
@@ -10883,7 +10923,16 @@ uint32 Unit::GetCreatePowers(Powers power) const
 void Unit::AddToWorld()
 {
     if (!IsInWorld())
+    {
         WorldObject::AddToWorld();
+        GetMap()->GetUnitIndex().Insert(this);
+    }
+}
+
+void Unit::RelocateInUnitIndex()
+{
+    if (m_unitIndexSlot != UNIT_INDEX_NO_SLOT)
+        GetMap()->GetUnitIndex().Relocate(this);
 }
 
 void Unit::setHover(bool val)
@@ -10909,6 +10958,8 @@ void Unit::RemoveFromWorld()
         RemoveBindSightAuras();
         RemoveNotOwnSingleTargetAuras();
         GetViewPoint().Event_RemovedFromWorld();
+        _SetVisibilityUpdateScheduled(false);
+        GetMap()->GetUnitIndex().Remove(this);
 
         WorldObject::RemoveFromWorld();
     }
@@ -11009,6 +11060,17 @@ struct ProcTriggeredData
 typedef std::list< ProcTriggeredData > ProcTriggeredList;
 typedef std::list< uint32> RemoveSpellList;
 
+// same order as auras have in Unit::AuraMap
+struct ProcAuraOrder
+{
+    bool operator()(Aura const* left, Aura const* right) const
+    {
+        if (left->GetId() != right->GetId())
+            return left->GetId() < right->GetId();
+        return left->GetEffIndex() < right->GetEffIndex();
+    }
+};
+
 // List of auras that CAN be trigger but may not exist in spell_proc_event
 // in most case need for drop charges
 // in some types of aura need do additional check
@@ -11184,15 +11246,24 @@ void Unit::ProcDamageAndSpellfor (bool isVictim, Unit * pTarget, uint32 procFlag
 
     RemoveSpellList removedSpells;
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (AuraMap::const_iterator itr = GetAuras().begin(); itr!= GetAuras().end(); ++itr)
+
+    // spell_proc_event was reloaded, auras able to proc may have changed
+    if (m_procAurasGeneration != sSpellMgr.GetSpellProcTriggerGeneration())
+        _RebuildProcAuras();
+
+    // Fill procTriggered list, only indexed auras can trigger
+    for (AuraProcIndex::const_iterator itr = m_procAuras.begin(); itr != m_procAuras.end(); ++itr)
     {
+        SpellProcTriggerEntry const* procTrigger = sSpellMgr.GetSpellProcTrigger((*itr)->GetId());
+        if (!procTrigger || !(procTrigger->procFlags & procFlag))
+            continue;
+
         SpellProcEventEntry const* spellProcEvent = NULL;
         bool active = (damage > 0) || (procExtra & PROC_EX_ABSORB && (isVictim && procSpell == NULL));
-        if (!IsTriggeredAtSpellProcEvent(itr->second, procSpell, procFlag, procExtra, attType, isVictim, active, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(*itr, procSpell, procFlag, procExtra, attType, isVictim, active, spellProcEvent))
            continue;
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, *itr));
     }
     // Handle effects proceed this time
     for (ProcTriggeredList::iterator i = procTriggered.begin(); i != procTriggered.end(); ++i)
@@ -11956,6 +12027,46 @@ Pet* Unit::CreateTamedPetFrom(Creature* creatureTarget,uint32 spell_id)
     return pet;
 }
 
+void Unit::_RegisterProcAura(Aura* aura)
+{
+    uint32 auraName = aura->GetModifier()->m_auraname;
+    if (auraName >= TOTAL_AURAS || isNonTriggerAura[auraName])
+        return;
+
+    SpellProcTriggerEntry const* procTrigger = sSpellMgr.GetSpellProcTrigger(aura->GetId());
+    if (!procTrigger || !procTrigger->procFlags)
+        return;
+
+    // If not trigger by default and without spell_proc_event - never procs
+    if (!isTriggerAura[auraName] && !procTrigger->procEvent)
+        return;
+
+    // after auras of same spell effect, as in aura map
+    m_procAuras.insert(std::upper_bound(m_procAuras.begin(), m_procAuras.end(), aura, ProcAuraOrder()), aura);
+}
+
+void Unit::_UnregisterProcAura(Aura* aura)
+{
+    for (AuraProcIndex::iterator itr = m_procAuras.begin(); itr != m_procAuras.end(); ++itr)
+    {
+        if (*itr == aura)
+        {
+            m_procAuras.erase(itr);
+            return;
+        }
+    }
+}
+
+void Unit::_RebuildProcAuras()
+{
+    m_procAuras.clear();
+    m_procAurasGeneration = sSpellMgr.GetSpellProcTriggerGeneration();
+
+    // aura map order, so plain append keeps index sorted
+    for (AuraMap::const_iterator itr = m_Auras.begin(); itr != m_Auras.end(); ++itr)
+        _RegisterProcAura(itr->second);
+}
+
 bool Unit::IsTriggeredAtSpellProcEvent(Aura* aura, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, bool active, SpellProcEventEntry const*& spellProcEvent)
 {
     SpellEntry const* spellProto = aura->GetSpellProto ();
@@ -12262,11 +12373,11 @@ void Unit::OnRelocated()
     if (distsq > GetTerrain()->GetSpecifics()->viewupdatedistance)
     {
         GetPosition(_notifiedPosition);
-        UpdateVisibilityAndView();
+        GetMap()->ScheduleVisibilityUpdate(this);
         return;
     }
 
-    ScheduleAINotify(GetTerrain()->GetSpecifics()->ainotifyperiod);
+    ScheduleAINotify(GetMap()->GetAINotifyPeriod());
 }
 
 void Unit::UpdateVisibilityAndView()
@@ -12298,6 +12409,17 @@ void Unit::UpdateVisibilityAndView()
     ScheduleAINotify(0);
 }
 
+void Unit::UpdateVisibilityAndViewNearBand()
+{
+    GetViewPoint().Call_UpdateVisibilityForOwnerNearBand();
+
+    Hellground::VisibleChangesNotifier notifier(*this);
+    Cell::VisitWorldObjects(this, notifier, GetMap()->GetVisibilityNearBandDistance() + World::GetVisibleObjectGreyDistance());
+
+    GetViewPoint().Event_ViewPointVisibilityChanged();
+    ScheduleAINotify(0);
+}
+
 void Unit::Kill(Unit *pVictim, bool durabilityLoss)
 {
     // Prevent double kill the exact unit
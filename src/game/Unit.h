@@ -25,6 +25,7 @@
 #include "Object.h"
 #include "Opcodes.h"
 #include "SpellAuraDefines.h"
+#include "AuraSlotList.h"
 #include "UpdateFields.h"
 #include "SharedDefines.h"
 #include "ThreatManager.h"
@@ -834,7 +835,7 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
         typedef std::set<Unit*> AttackerSet;
         typedef std::pair<uint32, uint8> spellEffectPair;
         typedef std::multimap< spellEffectPair, Aura*> AuraMap;
-        typedef std::list<Aura *> AuraList;
+        typedef AuraSlotList AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<AuraType> AuraTypeSet;
         typedef std::set<uint32> ComboPointHolderSet;
@@ -1383,6 +1384,7 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
         void DestroyForNearbyPlayers();
 
         void UpdateVisibilityAndView();
+        void UpdateVisibilityAndViewNearBand();
 
         // common function for visibility checks for player/creatures with detection code
         virtual bool canSeeOrDetect(Unit const* u, WorldObject const*, bool detect, bool inVisibleList = false, bool is3dDistance = true) const;
@@ -1401,6 +1403,14 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
         void ScheduleAINotify(uint32 delay);
         bool IsAINotifyScheduled() const { return _AINotifyScheduled;}
         void _SetAINotifyScheduled(bool on) { _AINotifyScheduled = on;}
+        bool IsVisibilityUpdateScheduled() const { return _visibilityUpdateScheduled;}
+        void _SetVisibilityUpdateScheduled(bool on) { _visibilityUpdateScheduled = on;}
+
+        // slot in map unit index, UNIT_INDEX_NO_SLOT when not indexed
+        uint32 GetUnitIndexSlot() const { return m_unitIndexSlot; }
+        uint32 GetUnitIndexCell() const { return m_unitIndexCell; }
+        void _SetUnitIndexSlot(uint32 cell, uint32 slot) { m_unitIndexCell = cell; m_unitIndexSlot = slot; }
+        void RelocateInUnitIndex();
 
         Position _notifiedPosition;
 
@@ -1408,6 +1418,9 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
 
     private:
         bool _AINotifyScheduled;
+        bool _visibilityUpdateScheduled;
+        uint32 m_unitIndexSlot;
+        uint32 m_unitIndexCell;
 
 #pragma endregion VisibilityRelocation
 
@@ -1630,6 +1643,7 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
 
         void _UpdateSpells(uint32 time);
         void _DeleteAuras();
+        void _CompactAuraLists();
 
         void _UpdateAutoRepeatSpell();
         bool m_AutoRepeatFirstCast;
@@ -1657,11 +1671,17 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
         AuraList m_removedAuras;
 
         AuraList *m_modAuras;
+        bool m_modAurasHaveHoles;                  // some m_modAuras slots were cleared since last compaction
         AuraList m_scAuras;                        // cast singlecast auras
         AuraList m_interruptableAuras;
         AuraList m_ccAuras;
         uint32 m_interruptMask;
 
+        // auras able to proc, kept in aura map order (spell id, effect index, apply order)
+        typedef std::vector<Aura*> AuraProcIndex;
+        AuraProcIndex m_procAuras;
+        uint32 m_procAurasGeneration;                       // SpellMgr proc trigger table the index was built for
+
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
         float m_weaponDamage[MAX_ATTACK][2];
         bool m_canModifyStats;
@@ -1686,6 +1706,9 @@ class HELLGROUND_IMPORT_EXPORT Unit : public WorldObject
         uint32 m_state;                                     // Even derived shouldn't modify
 
     private:
+        void _RegisterProcAura(Aura* aura);
+        void _UnregisterProcAura(Aura* aura);
+        void _RebuildProcAuras();
         bool IsTriggeredAtSpellProcEvent(Aura* aura, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, bool active, SpellProcEventEntry const*& spellProcEvent);
         bool HandleDummyAuraProc(  Unit *pVictim, uint32 damage, Aura* triggredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
         bool HandleHasteAuraProc(  Unit *pVictim, uint32 damage, Aura* triggredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
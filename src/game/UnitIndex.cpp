@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "UnitIndex.h"
+#include "Unit.h"
+#include "CellImpl.h"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define UNIT_INDEX_USE_SSE
+#endif
+
+uint32 CellUnitIndex::Insert(Unit* unit)
+{
+    m_x.push_back(unit->GetPositionX());
+    m_y.push_back(unit->GetPositionY());
+    m_z.push_back(unit->GetPositionZ());
+    m_size.push_back(unit->GetObjectSize());
+    m_typeMask.push_back(unit->GetTypeMask());
+    m_units.push_back(unit);
+
+    return m_units.size() - 1;
+}
+
+void CellUnitIndex::Remove(uint32 slot)
+{
+    uint32 last = m_units.size() - 1;
+    if (slot != last)
+    {
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_z[slot] = m_z[last];
+        m_size[slot] = m_size[last];
+        m_typeMask[slot] = m_typeMask[last];
+        m_units[slot] = m_units[last];
+
+        // unit moved from last slot stays in the same cell
+        m_units[slot]->_SetUnitIndexSlot(m_units[slot]->GetUnitIndexCell(), slot);
+    }
+
+    m_x.pop_back();
+    m_y.pop_back();
+    m_z.pop_back();
+    m_size.pop_back();
+    m_typeMask.pop_back();
+    m_units.pop_back();
+}
+
+void CellUnitIndex::Update(uint32 slot, Unit* unit)
+{
+    m_x[slot] = unit->GetPositionX();
+    m_y[slot] = unit->GetPositionY();
+    m_z[slot] = unit->GetPositionZ();
+    // combat reach changes with scale and shapeshifts, refresh it with position
+    m_size[slot] = unit->GetObjectSize();
+}
+
+void CellUnitIndex::GetUnitsInRange(float x, float y, float z, float radius, uint32 typeMask, std::vector<Unit*>& units) const
+{
+    uint32 count = m_units.size();
+    uint32 i = 0;
+
+#ifdef UNIT_INDEX_USE_SSE
+    const __m128 cx = _mm_set1_ps(x);
+    const __m128 cy = _mm_set1_ps(y);
+    const __m128 cz = _mm_set1_ps(z);
+    const __m128 cr = _mm_set1_ps(radius);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_x[i]), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_y[i]), cy);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(&m_z[i]), cz);
+        __m128 r = _mm_add_ps(_mm_loadu_ps(&m_size[i]), cr);
+
+        __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, _mm_mul_ps(r, r)));
+        if (!mask)
+            continue;
+
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            if ((mask & (1 << j)) && (m_typeMask[i + j] & typeMask))
+                units.push_back(m_units[i + j]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        float dx = m_x[i] - x;
+        float dy = m_y[i] - y;
+        float dz = m_z[i] - z;
+        float r = radius + m_size[i];
+
+        if (dx*dx + dy*dy + dz*dz < r*r && (m_typeMask[i] & typeMask))
+            units.push_back(m_units[i]);
+    }
+}
+
+uint32 MapUnitIndex::ComputeCellId(float x, float y)
+{
+    CellPair p = Hellground::ComputeCellPair(x, y).normalize();
+    return p.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + p.x_coord;
+}
+
+void MapUnitIndex::Insert(Unit* unit)
+{
+    if (unit->GetUnitIndexSlot() != UNIT_INDEX_NO_SLOT)
+        return;
+
+    uint32 cellId = ComputeCellId(unit->GetPositionX(), unit->GetPositionY());
+    unit->_SetUnitIndexSlot(cellId, m_cells[cellId].Insert(unit));
+}
+
+void MapUnitIndex::Remove(Unit* unit)
+{
+    if (unit->GetUnitIndexSlot() == UNIT_INDEX_NO_SLOT)
+        return;
+
+    CellIndexMap::iterator itr = m_cells.find(unit->GetUnitIndexCell());
+    if (itr != m_cells.end())
+    {
+        itr->second.Remove(unit->GetUnitIndexSlot());
+        if (itr->second.empty())
+            m_cells.erase(itr);
+    }
+
+    unit->_SetUnitIndexSlot(0, UNIT_INDEX_NO_SLOT);
+}
+
+void MapUnitIndex::Relocate(Unit* unit)
+{
+    uint32 cellId = ComputeCellId(unit->GetPositionX(), unit->GetPositionY());
+    if (cellId != unit->GetUnitIndexCell())
+    {
+        Remove(unit);
+        Insert(unit);
+        return;
+    }
+
+    m_cells[cellId].Update(unit->GetUnitIndexSlot(), unit);
+}
+
+void MapUnitIndex::GetUnitsInRange(float x, float y, float z, float radius, uint32 typeMask, std::vector<Unit*>& units) const
+{
+    if (radius > MAX_VISIBILITY_DISTANCE)
+        radius = MAX_VISIBILITY_DISTANCE;
+
+    CellArea area = Cell::CalculateCellArea(x, y, radius);
+    for (uint32 xx = area.low_bound.x_coord; xx <= area.high_bound.x_coord; ++xx)
+    {
+        for (uint32 yy = area.low_bound.y_coord; yy <= area.high_bound.y_coord; ++yy)
+        {
+            CellIndexMap::const_iterator itr = m_cells.find(yy * TOTAL_NUMBER_OF_CELLS_PER_MAP + xx);
+            if (itr != m_cells.end())
+                itr->second.GetUnitsInRange(x, y, z, radius, typeMask, units);
+        }
+    }
+}
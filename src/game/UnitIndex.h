@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_UNITINDEX_H
+#define HELLGROUND_UNITINDEX_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <vector>
+
+class Unit;
+
+#define UNIT_INDEX_NO_SLOT 0xFFFFFFFF
+
+/// CellUnitIndex - positions of all units standing in one cell, kept as struct of arrays
+/// so radius queries can filter by distance without touching Unit objects
+class CellUnitIndex
+{
+    public:
+        bool empty() const { return m_units.empty(); }
+        uint32 size() const { return m_units.size(); }
+
+        uint32 Insert(Unit* unit);
+        void Remove(uint32 slot);
+        void Update(uint32 slot, Unit* unit);
+
+        // appends units with center closer than radius + own object size, no other checks are done
+        void GetUnitsInRange(float x, float y, float z, float radius, uint32 typeMask, std::vector<Unit*>& units) const;
+
+    private:
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+        std::vector<float> m_size;
+        std::vector<uint32> m_typeMask;
+        std::vector<Unit*> m_units;
+};
+
+/// MapUnitIndex - per map set of cell indexes, units are synced on add/remove from world and relocation
+class MapUnitIndex
+{
+    public:
+        void Insert(Unit* unit);
+        void Remove(Unit* unit);
+        void Relocate(Unit* unit);
+
+        // candidates for area searches, caller still has to do all exact checks (distance with model size, los, faction...)
+        void GetUnitsInRange(float x, float y, float z, float radius, uint32 typeMask, std::vector<Unit*>& units) const;
+
+    private:
+        static uint32 ComputeCellId(float x, float y);
+
+        typedef UNORDERED_MAP<uint32, CellUnitIndex> CellIndexMap;
+        CellIndexMap m_cells;
+};
+
+#endif
@@ -27,6 +27,9 @@
 void WaypointMgr::Free()
 {
     _waypointPathMap.clear();
+
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, _segmentLock);
+    _segmentMap.clear();
 }
 
 void WaypointMgr::Load()
@@ -98,6 +101,18 @@ void WaypointMgr::UpdatePath(uint32 id)
     if (_waypointPathMap.find(id)!= _waypointPathMap.end())
         _waypointPathMap[id]->clear();
 
+    {
+        // nodes could move, generated segments of path are no longer valid
+        ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, _segmentLock);
+        for (WaypointSegmentMap::iterator itr = _segmentMap.begin(); itr != _segmentMap.end();)
+        {
+            if (uint32(itr->first >> 32) == id)
+                _segmentMap.erase(itr++);
+            else
+                ++itr;
+        }
+    }
+
     QueryResultAutoPtr result = GameDataDatabase.PQuery("SELECT `id`,`point`,`position_x`,`position_y`,`position_z`,`move_type`,`delay`,`action`,`action_chance` FROM `waypoint_data` WHERE id = %u ORDER BY `point`", id);
 
     if (!result)
@@ -140,3 +155,21 @@ void WaypointMgr::UpdatePath(uint32 id)
 
    _waypointPathMap[id] = path_data;
 }
+
+bool WaypointMgr::GetSegment(uint32 pathId, uint32 node, uint32 mapId, uint8 moveTraits, WaypointSegment& points)
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, _segmentLock, false);
+
+    WaypointSegmentMap::const_iterator itr = _segmentMap.find(SegmentKey(pathId, node, mapId, moveTraits));
+    if (itr == _segmentMap.end())
+        return false;
+
+    points = itr->second;
+    return true;
+}
+
+void WaypointMgr::CacheSegment(uint32 pathId, uint32 node, uint32 mapId, uint8 moveTraits, WaypointSegment const& points)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, _segmentLock);
+    _segmentMap[SegmentKey(pathId, node, mapId, moveTraits)] = points;
+}
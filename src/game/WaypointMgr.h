@@ -22,6 +22,8 @@
 #define HELLGROUND_WAYPOINTMGR_H
 
 #include <ace/Singleton.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <G3D/Vector3.h>
 
 #include <vector>
 #include "Utilities/UnorderedMap.h"
@@ -46,6 +48,10 @@ struct WaypointData
 typedef std::vector<WaypointData*> WaypointPath;
 typedef UNORDERED_MAP<uint32, WaypointPath*> WaypointPathMap;
 
+// generated path from previous node to given one, the same for every creature of same kind standing at previous node
+typedef std::vector<G3D::Vector3> WaypointSegment;
+typedef UNORDERED_MAP<uint64, WaypointSegment> WaypointSegmentMap;
+
 class WaypointMgr
 {
     friend class ACE_Singleton<WaypointMgr, ACE_Thread_Mutex>;
@@ -67,9 +73,21 @@ class WaypointMgr
 
         inline uint32 GetRecordsCount() { return records; }
 
+        // segments are generated on first use, mmap tiles are not loaded at startup
+        bool GetSegment(uint32 pathId, uint32 node, uint32 mapId, uint8 moveTraits, WaypointSegment& points);
+        void CacheSegment(uint32 pathId, uint32 node, uint32 mapId, uint8 moveTraits, WaypointSegment const& points);
+
     private:
+        static uint64 SegmentKey(uint32 pathId, uint32 node, uint32 mapId, uint8 moveTraits)
+        {
+            return (uint64(pathId) << 32) | ((node & 0xFFFF) << 16) | ((moveTraits & 0x3) << 14) | (mapId & 0x3FFF);
+        }
+
         int32 records;
         WaypointPathMap _waypointPathMap;
+
+        WaypointSegmentMap _segmentMap;
+        ACE_RW_Thread_Mutex _segmentLock;
 };
 
 #define sWaypointMgr (*ACE_Singleton<WaypointMgr, ACE_Thread_Mutex>::instance())
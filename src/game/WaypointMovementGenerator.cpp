@@ -29,6 +29,7 @@
 
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
+#include "movemap/PathFinder.h"
 
 void WaypointMovementGenerator<Creature>::LoadPath(Creature &creature)
 {
@@ -115,7 +116,7 @@ bool WaypointMovementGenerator<Creature>::tryToMove(Creature &creature)
     const WaypointData *node = _path->at(_currentNode);
 
     Movement::MoveSplineInit init(creature);
-    init.MoveTo(node->x, node->y, node->z, _pathFinding && node->moveType != M_FLY);
+    moveToNode(creature, init, node);
 
     if (node->moveType == M_FLY)
         init.SetFly();
@@ -131,6 +132,38 @@ bool WaypointMovementGenerator<Creature>::tryToMove(Creature &creature)
     return true;
 }
 
+void WaypointMovementGenerator<Creature>::moveToNode(Creature &creature, Movement::MoveSplineInit &init, const WaypointData *node)
+{
+    if (!_pathFinding || node->moveType == M_FLY)
+    {
+        init.MoveTo(node->x, node->y, node->z);
+        return;
+    }
+
+    // creatures following same path mostly start from previous node, generated segment is shared by them
+    // in water path filter depends on current liquid, such segments are not shared
+    const WaypointData *prev = _path->at(_currentNode ? _currentNode - 1 : _path->size() - 1);
+    bool shared = sWorld.getConfig(CONFIG_WAYPOINT_MOVEMENT_SEGMENT_CACHE) &&
+        creature.GetDistanceSq(prev->x, prev->y, prev->z) < 1.0f && !creature.IsInWater() && !creature.IsUnderWater();
+
+    uint8 moveTraits = (creature.CanWalk() ? 0x1 : 0) | (creature.CanSwim() ? 0x2 : 0);
+    if (shared && sWaypointMgr.GetSegment(_pathId, _currentNode, creature.GetMapId(), moveTraits, init.Path()))
+        return;
+
+    PathFinder path(&creature);
+    if (path.calculate(node->x, node->y, node->z) && path.getPathType() & ~PATHFIND_NOPATH)
+    {
+        // shortcuts and incomplete paths depend on loaded tiles, only full paths are kept
+        if (shared && path.getPathType() == PATHFIND_NORMAL)
+            sWaypointMgr.CacheSegment(_pathId, _currentNode, creature.GetMapId(), moveTraits, path.getPath());
+
+        init.MovebyPath(path.getPath());
+        return;
+    }
+
+    init.MoveTo(node->x, node->y, node->z);
+}
+
 bool WaypointMovementGenerator<Creature>::Update(Creature &creature, const uint32 &diff)
 {
     // way point movement can be switched on/off
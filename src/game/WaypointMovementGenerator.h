@@ -56,6 +56,11 @@ class HELLGROUND_IMPORT_EXPORT PathMovementBase
         uint32 _currentNode;
 };
 
+namespace Movement
+{
+    class MoveSplineInit;
+}
+
 template<class T>
 class WaypointMovementGenerator;
 
@@ -88,6 +93,7 @@ class WaypointMovementGenerator<Creature> : public MovementGeneratorMedium< Crea
 
         bool atNode(Creature&);
         bool tryToMove(Creature&);
+        void moveToNode(Creature&, Movement::MoveSplineInit&, const WaypointData*);
 
         TimeTrackerSmall _nextMoveTime;
         bool _pathFinding;
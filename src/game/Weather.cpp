@@ -233,7 +233,8 @@ bool Weather::UpdateWeather()
 
     WorldPacket data(SMSG_WEATHER, (4+4+4));
     data << uint32(state) << (float)m_grade << uint8(0);
-    player->BroadcastPacket(&data, true);
+    // weathers are updated in parallel with maps, send through sessions instead of visiting map cells
+    sWorld.SendZoneMessage(m_zone, &data);
 
     ///- Log the event
     char const* wthstr;
@@ -51,6 +51,7 @@
 #include "TemporarySummon.h"
 #include "WaypointMovementGenerator.h"
 #include "VMapFactory.h"
+#include "WorldModel.h"
 #include "movemap/MoveMap.h"
 #include "GameEvent.h"
 #include "PoolManager.h"
@@ -69,6 +70,10 @@
 #include "luaengine/HookMgr.h"
 //#include "Timer.h"
 #include "GuildMgr.h"
+#include "PlayerDirectory.h"
+#include "ObjectPool.h"
+#include "ChatFanout.h"
+#include "PacketReplay.h"
 #include <tbb/parallel_for.h>
 
 extern bool StartEluna();
@@ -91,6 +96,13 @@ void MapUpdateDiffInfo::InitializeMapData()
             for (int i = DIFF_SESSION_UPDATE; i < DIFF_MAX_CUMULATIVE_INFO; i++)
                 _cumulativeDiffInfo[map->first.nMapId][i] = 0;
         }
+
+        if (_cumulativeCountInfo.find(map->first.nMapId) == _cumulativeCountInfo.end())
+        {
+            _cumulativeCountInfo[map->first.nMapId] = new atomic_uint[COUNT_MAX_CUMULATIVE_INFO];
+            for (int i = COUNT_VISIBILITY_UPDATES; i < COUNT_MAX_CUMULATIVE_INFO; i++)
+                _cumulativeCountInfo[map->first.nMapId][i] = 0;
+        }
     }
 }
 
@@ -105,6 +117,17 @@ void MapUpdateDiffInfo::PrintCumulativeMapUpdateDiff()
                 sLog.outLog(LOG_DIFF, "Map[%u] diff for: %i - %u", itr->first, i, diff);
         }
     }
+
+    // counts are logged whenever map did something, they aren't comparable with time threshold
+    for (CumulativeDiffMap::iterator itr = _cumulativeCountInfo.begin(); itr != _cumulativeCountInfo.end(); ++itr)
+    {
+        for (int i = COUNT_VISIBILITY_UPDATES; i < COUNT_MAX_CUMULATIVE_INFO; i++)
+        {
+            uint32 count = itr->second[i].value();
+            if (count)
+                sLog.outLog(LOG_DIFF, "Map[%u] count for: %i - %u", itr->first, i, count);
+        }
+    }
     ClearDiffInfo();
 }
 
@@ -130,6 +153,7 @@ World::World()
     m_updateTimeCount = 0;
 
     m_massMuteTime = 0;
+    m_oldMailsTime = 0;
 
     loggedInAlliances = 0;
     loggedInHordes = 0;
@@ -154,6 +178,8 @@ World::World()
 /// World destructor
 World::~World()
 {
+    sChatFanout.Deactivate();
+
     ///- Empty the kicked session set
     while (!m_sessions.empty())
     {
@@ -428,6 +454,8 @@ bool World::RemoveQueuedPlayer(WorldSession* sess)
 /// Find a Weather object by the given zoneid
 Weather* World::FindWeather(uint32 id) const
 {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_weathersLock, NULL);
+
     WeatherMap::const_iterator itr = m_weathers.find(id);
 
     if (itr != m_weathers.end())
@@ -440,6 +468,8 @@ Weather* World::FindWeather(uint32 id) const
 void World::RemoveWeather(uint32 id)
 {
     // not called at the moment. Kept for completeness
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_weathersLock);
+
     WeatherMap::iterator itr = m_weathers.find(id);
 
     if (itr != m_weathers.end())
@@ -459,6 +489,8 @@ Weather* World::AddWeather(uint32 zone_id)
     if (!weatherChances)
         return NULL;
 
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_weathersLock, NULL);
+
     Weather* w = new Weather(zone_id,weatherChances);
     m_weathers[w->GetZone()] = w;
     w->ReGenerate();
@@ -466,6 +498,103 @@ Weather* World::AddWeather(uint32 zone_id)
     return w;
 }
 
+/// Send zone weather to player entering it, creates Weather object for first player in zone
+void World::SendZoneWeather(Player* player, uint32 zone_id)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_weathersLock);
+
+    WeatherMap::const_iterator itr = m_weathers.find(zone_id);
+    if (itr != m_weathers.end())
+    {
+        itr->second->SendWeatherUpdateToPlayer(player);
+        return;
+    }
+
+    WeatherZoneChances const* weatherChances = sObjectMgr.GetWeatherChances(zone_id);
+
+    // send fine weather packet to remove old zone's weather
+    if (!weatherChances)
+    {
+        Weather::SendFineWeatherUpdateToPlayer(player);
+        return;
+    }
+
+    Weather* w = new Weather(zone_id, weatherChances);
+    m_weathers[zone_id] = w;
+    w->ReGenerate();
+    w->SendWeatherUpdateToPlayer(player);
+}
+
+/// Send an update signal to Weather objects, remove them for zones with no player
+void World::UpdateWeathers(uint32 diff)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_weathersLock);
+
+    WeatherMap::iterator itr, next;
+    for (itr = m_weathers.begin(); itr != m_weathers.end(); itr = next)
+    {
+        next = itr;
+        ++next;
+
+        if (!itr->second->Update(diff))
+        {
+            Weather *temp = itr->second;
+            m_weathers.erase(itr);
+            delete temp;
+        }
+    }
+}
+
+/// Load expired mails, receivers online state is checked later by ReturnOldMails
+void World::LoadOldMails()
+{
+    switch (m_configs[CONFIG_RETURNOLDMAILS_MODE])
+    {
+        case 1:
+            break;
+        case 0:
+        default:
+            if (++mail_timer <= mail_timer_expires)
+                return;
+
+            mail_timer = 0;
+            break;
+    }
+
+    m_oldMailsTime = time(NULL);
+    sObjectMgr.LoadExpiredMails(m_oldMails, m_oldMailsTime);
+}
+
+/// Return mails with items or delete old mails
+void World::ReturnOldMails()
+{
+    if (!m_oldMails.empty())
+        sObjectMgr.ReturnOrDeleteOldMails(m_oldMails, m_oldMailsTime, true);
+}
+
+void World::UpdateUptime()
+{
+    uint32 tmpDiff = (m_gameTime - m_startTime);
+    uint32 maxClientsNum = GetMaxActiveSessionCount();
+
+    RealmDataDatabase.PExecute("UPDATE uptime SET uptime = %d, maxplayers = %d WHERE starttime = " UI64FMTD, tmpDiff, maxClientsNum, uint64(m_startTime));
+}
+
+static void LoadOldMailsTask(uint32 /*diff*/)
+{
+    sWorld.LoadOldMails();
+}
+
+static void UpdateWeathersTask(uint32 diff)
+{
+    sWorld.UpdateWeathers(diff);
+}
+
+static void UpdateUptimeTask(uint32 /*diff*/)
+{
+    sWorld.UpdateUptime();
+}
+
 /// Initialize config values
 void World::LoadConfigSettings(bool reload)
 {
@@ -496,6 +625,19 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_ADDON_CHANNEL, "AddonChannel", false);
     loadConfig(CONFIG_SAVE_RESPAWN_TIME_IMMEDIATELY, "SaveRespawnTimeImmediately", true);
     loadConfig(CONFIG_GRID_UNLOAD, "GridUnload", true);
+    loadConfig(CONFIG_GRID_PRELOAD_ENABLED, "GridPreload.Enable", false);
+    loadConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD, "GridPreload.LookAhead", 20000);
+    loadConfig(CONFIG_GRID_PRELOAD_CELLS_PER_TICK, "GridPreload.CellsPerTick", 4);
+    loadConfig(CONFIG_GRID_PRELOAD_TERRAIN_PER_TICK, "GridPreload.TerrainGridsPerTick", 2);
+
+    loadConfig(CONFIG_OBJECT_POOL_ENABLED, "ObjectPool.Enable", false);
+    loadConfig(CONFIG_OBJECT_POOL_RESERVE, "ObjectPool.ReserveOnGridLoad", false);
+    ObjectSlabPool::SetEnabled(getConfig(CONFIG_OBJECT_POOL_ENABLED));
+
+    loadConfig(CONFIG_GUID_REUSE_DELAY, "GuidReuseDelay", 300);
+
+    loadConfig(CONFIG_MOVEMENT_RELAY_FULL_RATE_DIST, "Movement.RelayFullRateDistance", 40);
+    loadConfig(CONFIG_MOVEMENT_RELAY_FAR_HEARTBEAT_RATE, "Movement.RelayFarHeartbeatRate", 3);
 
     loadConfig(CONFIG_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 600000);
     loadConfig(CONFIG_INTERVAL_SAVE, "PlayerSaveInterval", 900000);
@@ -516,6 +658,13 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_INTERVAL_LOG_UPDATE, "RecordUpdateTimeDiffInterval", 60000);
     loadConfig(CONFIG_MIN_LOG_UPDATE, "MinRecordUpdateTimeDiff", 10);
 
+    loadConfig(CONFIG_TICK_TRACE_ENABLED, "TickTrace.Enable", false);
+    loadConfig(CONFIG_TICK_TRACE_BUFFER_SIZE, "TickTrace.BufferSize", 131072);
+    loadConfig(CONFIG_TICK_TRACE_DUMP_THRESHOLD, "TickTrace.DumpThreshold", 0);
+    loadConfig(CONFIG_TICK_TRACE_DUMP_SECONDS, "TickTrace.DumpSeconds", 5);
+    sTickTracer.Configure(m_configs[CONFIG_TICK_TRACE_BUFFER_SIZE], m_configs[CONFIG_TICK_TRACE_DUMP_THRESHOLD], m_configs[CONFIG_TICK_TRACE_DUMP_SECONDS]);
+    sTickTracer.SetEnabled(m_configs[CONFIG_TICK_TRACE_ENABLED]);
+
     // Server settings
     if (m_configs[CONFIG_REALM_ZONE] == REALM_ZONE_RUSSIAN)
         m_configs[CONFIG_DECLINED_NAMES_USED] = true;
@@ -570,6 +719,14 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_GROUPLEADER_RECONNECT_PERIOD, "GroupLeaderReconnectPeriod", 180);
     loadConfig(CONFIG_INSTANCE_RESET_TIME_HOUR, "Instance.ResetTimeHour", 4);
     loadConfig(CONFIG_INSTANCE_UNLOAD_DELAY, "Instance.UnloadDelay", 1800000);
+    loadConfig(CONFIG_INSTANCE_UNLOAD_GRIDS_PER_TICK, "Instance.UnloadGridsPerTick", 4);
+    loadConfig(CONFIG_INSTANCE_PREWARM_POPULAR, "Instance.PrewarmPopular", 0);
+    loadConfig(CONFIG_INSTANCE_PREWARM_GRIDS_PER_TICK, "Instance.PrewarmGridsPerTick", 2);
+
+    m_prewarmMapIds.clear();
+    Tokens prewarmMaps = StrSplit(sConfig.GetStringDefault("Instance.PrewarmMaps", ""), ", ");
+    for (Tokens::const_iterator itr = prewarmMaps.begin(); itr != prewarmMaps.end(); ++itr)
+        m_prewarmMapIds.insert(atoi(itr->c_str()));
     loadConfig(CONFIG_MAIL_DELIVERY_DELAY, "Mail.DeliveryDelay", HOUR);
     loadConfig(CONFIG_EXTERNAL_MAIL, "Mail.External", 0);
     loadConfig(CONFIG_EXTERNAL_MAIL_INTERVAL, "Mail.ExternalInterval", 1);
@@ -636,6 +793,9 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_CHATFLOOD_MESSAGE_COUNT, "ChatFlood.MessageCount",10);
     loadConfig(CONFIG_CHATFLOOD_MESSAGE_DELAY, "ChatFlood.MessageDelay",1);
     loadConfig(CONFIG_CHATFLOOD_MUTE_TIME, "ChatFlood.MuteTime",10);
+    loadConfig(CONFIG_CHAT_FANOUT_ENABLED, "Chat.Fanout.Enable", true);
+    loadConfig(CONFIG_CHAT_FANOUT_MIN_RECIPIENTS, "Chat.Fanout.MinRecipients", 50);
+    loadConfig(CONFIG_CHAT_CHANNEL_RATE_LIMIT, "Chat.Channel.RateLimit", 0);
 
     // Game master settings
     loadConfig(CONFIG_GM_LOGIN_STATE, "GM.LoginState",2);
@@ -810,12 +970,30 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
     loadConfig(CONFIG_PET_LOS, "vmap.petLOS", false);
     loadConfig(CONFIG_VMAP_TOTEM, "vmap.totem", false);
+    loadConfig(CONFIG_VMAP_SIMD_INTERSECTION, "vmap.simdIntersection", true);
+    VMAP::GroupModel::setSimdIntersection(getConfig(CONFIG_VMAP_SIMD_INTERSECTION));
+
+    loadConfig(CONFIG_VMAP_LOS_CACHE_TTL, "vmap.losCache.TTL", 0);
+    loadConfig(RATE_VMAP_LOS_CACHE_QUANTUM, "vmap.losCache.Quantum", 0.5f);
+    if (rate_values[RATE_VMAP_LOS_CACHE_QUANTUM] < 0.1f)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: vmap.losCache.Quantum (%f) must be >= 0.1, set to 0.1.", rate_values[RATE_VMAP_LOS_CACHE_QUANTUM]);
+        rate_values[RATE_VMAP_LOS_CACHE_QUANTUM] = 0.1f;
+    }
 
     loadConfig(CONFIG_MMAP_ENABLED, "mmap.enabled", true);
     sLog.outString("WORLD: mmap pathfinding %sabled", getConfig(CONFIG_MMAP_ENABLED) ? "en" : "dis");
+    loadConfig(CONFIG_MMAP_MAP_TILE_FILES, "mmap.mapTileFiles", true);
 
     // visibility and radiuses
     loadConfig(CONFIG_GROUP_VISIBILITY, "Visibility.GroupMode", 0);
+    loadConfig(CONFIG_VISIBILITY_UPDATE_MAX_PER_TICK, "Visibility.Update.MaxPerTick", 0);
+    loadConfig(CONFIG_VISIBILITY_NEAR_BAND_PCT, "Visibility.Update.NearBandPct", 50);
+    if (m_configs[CONFIG_VISIBILITY_NEAR_BAND_PCT] < 10)
+        m_configs[CONFIG_VISIBILITY_NEAR_BAND_PCT] = 10;
+    if (m_configs[CONFIG_VISIBILITY_NEAR_BAND_PCT] > 100)
+        m_configs[CONFIG_VISIBILITY_NEAR_BAND_PCT] = 100;
+    loadConfig(CONFIG_VISIBILITY_FAR_BAND_INTERVAL, "Visibility.Update.FarBandInterval", 4);
     m_activeObjectUpdateDistanceOnContinents = sConfig.GetIntDefault("Visibility.Distance.ActiveObjectUpdate.Continents", DEFAULT_VISIBILITY_DISTANCE);
     m_activeObjectUpdateDistanceInInstances = sConfig.GetIntDefault("Visibility.Distance.ActiveObjectUpdate.Instances", DEFAULT_VISIBILITY_DISTANCE);
 
@@ -828,12 +1006,22 @@ void World::LoadConfigSettings(bool reload)
     loadConfig(CONFIG_TARGET_POS_RECHECK_TIMER, "Movement.RecheckTimer", 100);
     loadConfig(CONFIG_WAYPOINT_MOVEMENT_PATHFINDING_ON_CONTINENTS, "Movement.WaypointPathfinding.Continents", true);
     loadConfig(CONFIG_WAYPOINT_MOVEMENT_PATHFINDING_IN_INSTANCES, "Movement.WaypointPathfinding.Instances", true);
-
-    // CoreBalancer
-    loadConfig(CONFIG_COREBALANCER_ENABLED, "CoreBalancer.Enable", false);
-    loadConfig(CONFIG_COREBALANCER_PLAYABLE_DIFF, "CoreBalancer.PlayableDiff", 200);
-    loadConfig(CONFIG_COREBALANCER_INTERVAL, "CoreBalancer.BalanceInterval", 300000);
-    loadConfig(CONFIG_COREBALANCER_VISIBILITY_PENALTY, "CoreBalancer.VisibilityPenalty", 25);
+    loadConfig(CONFIG_WAYPOINT_MOVEMENT_SEGMENT_CACHE, "Movement.WaypointPathfinding.Cache", true);
+    loadConfig(CONFIG_MOVEMENT_BATCH_SPLINES, "Movement.BatchSplines", true);
+
+    // MapLoadGovernor
+    loadConfig(CONFIG_MAPGOVERNOR_ENABLED, "MapGovernor.Enable", false);
+    loadConfig(CONFIG_MAPGOVERNOR_MAX_UPDATE_TIME, "MapGovernor.MaxUpdateTime", 50);
+    loadConfig(CONFIG_MAPGOVERNOR_RECOVER_PCT, "MapGovernor.RecoverPct", 60);
+    loadConfig(CONFIG_MAPGOVERNOR_INTERVAL, "MapGovernor.Interval", 10000);
+    if (m_configs[CONFIG_MAPGOVERNOR_INTERVAL] < 1000)
+        m_configs[CONFIG_MAPGOVERNOR_INTERVAL] = 1000;
+    loadConfig(CONFIG_MAPGOVERNOR_RECOVER_INTERVALS, "MapGovernor.RecoverIntervals", 3);
+    loadConfig(CONFIG_MAPGOVERNOR_VISIBILITY_PENALTY, "MapGovernor.VisibilityPenalty", 25);
+    loadConfig(CONFIG_MAPGOVERNOR_STEP_FEATURES, "MapGovernor.Step.Features", true);
+    loadConfig(CONFIG_MAPGOVERNOR_STEP_VISIBILITY, "MapGovernor.Step.Visibility", true);
+    loadConfig(CONFIG_MAPGOVERNOR_STEP_AI_NOTIFY, "MapGovernor.Step.AINotify", true);
+    loadConfig(CONFIG_MAPGOVERNOR_STEP_UPDATE_INTERVAL, "MapGovernor.Step.UpdateInterval", true);
 
     // VMSS system
     loadConfig(CONFIG_VMSS_ENABLE, "VMSS.Enable", false);
@@ -1462,6 +1650,12 @@ void World::SetInitialWorldSettings()
     sLog.outString("Starting Map System");
     sMapMgr.Initialize();
 
+    if (getConfig(CONFIG_CHAT_FANOUT_ENABLED))
+    {
+        sLog.outString("Starting Chat Fanout thread");
+        sChatFanout.Activate();
+    }
+
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
@@ -1501,8 +1695,9 @@ void World::SetInitialWorldSettings()
     if (getConfig(CONFIG_ENABLE_PASSIVE_ANTICHEAT) && m_ac.activate() == -1)
         sLog.outString("Couldn't activate AntiCheat");
 
-    if (getConfig(CONFIG_COREBALANCER_ENABLED))
-        _coreBalancer.Initialize();
+    std::string replayFile = sConfig.GetStringDefault("PacketReplay.File", "");
+    if (!replayFile.empty() && !sPacketReplay.Start(replayFile, sConfig.GetFloatDefault("PacketReplay.Speed", 1.0f), true))
+        sLog.outString("Couldn't start packet replay of %s", replayFile.c_str());
 
     sLog.outString("WORLD: World initialized");
 }
@@ -1579,11 +1774,9 @@ void World::LoadAutobroadcasts()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    ACE_Time_Value tickStart = ACE_OS::gettimeofday();
     m_updateTime = uint32(diff);
 
-    if (getConfig(CONFIG_COREBALANCER_ENABLED))
-        _coreBalancer.Update(diff);
-
     bool accumulateMapDiff = getConfig(CONFIG_CUMULATIVE_LOG_METHOD) == 1 ? true : false;
     if (getConfig(CONFIG_INTERVAL_LOG_UPDATE))
     {
@@ -1639,30 +1832,6 @@ void World::Update(uint32 diff)
 
         diffRecorder.RecordTimeFor("ResetDailyQuests");
     }
-    /// <ul><li> Handle auctions when the timer has passed
-    if (m_timers[WUPDATE_OLDMAILS].Passed())
-    {
-        m_timers[WUPDATE_OLDMAILS].Reset();
-
-        ///- Update mails (return old mails with item, or delete them)
-        switch (m_configs[CONFIG_RETURNOLDMAILS_MODE])
-        {
-            case 1:
-                sObjectMgr.ReturnOrDeleteOldMails(true);
-                break;
-            case 0:
-            default:
-                if (++mail_timer > mail_timer_expires)
-                {
-                    mail_timer = 0;
-                    sObjectMgr.ReturnOrDeleteOldMails(true);
-                }
-                break;
-        }
-
-        diffRecorder.RecordTimeFor("ReturnOldMails");
-    }
-
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
@@ -1673,6 +1842,9 @@ void World::Update(uint32 diff)
         diffRecorder.RecordTimeFor("UpdateAuctions");
     }
 
+    // replayed packets are queued before sessions handle them
+    sPacketReplay.Update();
+
     /// <li> Handle session updates when the timer has passed
     if (m_timers[WUPDATE_SESSIONS].Passed())
     {
@@ -1692,40 +1864,6 @@ void World::Update(uint32 diff)
     sWorldEventProcessor.ExecuteEvents();
     diffRecorder.RecordTimeFor("ExecuteWorldEvents");
 
-    /// <li> Handle weather updates when the timer has passed
-    if (m_timers[WUPDATE_WEATHERS].Passed())
-    {
-        m_timers[WUPDATE_WEATHERS].Reset();
-
-        ///- Send an update signal to Weather objects
-        WeatherMap::iterator itr, next;
-        for (itr = m_weathers.begin(); itr != m_weathers.end(); itr = next)
-        {
-            next = itr;
-            ++next;
-
-            ///- and remove Weather objects for zones with no player as interval > WorldTick
-            if (!itr->second->Update(m_timers[WUPDATE_WEATHERS].GetInterval()))
-            {
-                Weather *temp = itr->second;
-                m_weathers.erase(itr);
-                delete temp;
-            }
-        }
-
-        diffRecorder.RecordTimeFor("UpdateWeathers");
-    }
-
-    /// <li> Update uptime table
-    if (m_timers[WUPDATE_UPTIME].Passed())
-    {
-        uint32 tmpDiff = (m_gameTime - m_startTime);
-        uint32 maxClientsNum = sWorld.GetMaxActiveSessionCount();
-
-        m_timers[WUPDATE_UPTIME].Reset();
-        RealmDataDatabase.PExecute("UPDATE uptime SET uptime = %d, maxplayers = %d WHERE starttime = " UI64FMTD, tmpDiff, maxClientsNum, uint64(m_startTime));
-    }
-
     diffRecorder.ResetDiff();
 
     if (sWorld.getConfig(CONFIG_AUTOBROADCAST_INTERVAL))
@@ -1777,10 +1915,42 @@ void World::Update(uint32 diff)
     ///- Update objects when the timer has passed (maps, transport, creatures,...)
     MAP_UPDATE_DIFF(MapUpdateDiff().InitializeMapData())
 
-    sMapMgr.Update(diff);                // As interval = 0
+    ACE_Time_Value serialBeforeEnd = ACE_OS::gettimeofday();
+
+    sMapMgr.StartUpdate(diff);           // As interval = 0
+
+    ///- Global work not touching map objects runs on map update threads in parallel with maps,
+    ///- auctions and sql callbacks stay serial as they modify online players
+    MapUpdater* updater = sMapMgr.GetMapUpdater();
+
+    /// <ul><li> Load old mails to return or delete, applied after map updates
+    if (m_timers[WUPDATE_OLDMAILS].Passed())
+    {
+        m_timers[WUPDATE_OLDMAILS].Reset();
+        updater->schedule_global("LoadOldMails", &LoadOldMailsTask, diff);
+    }
+
+    /// <li> Handle weather updates when the timer has passed
+    if (m_timers[WUPDATE_WEATHERS].Passed())
+    {
+        m_timers[WUPDATE_WEATHERS].Reset();
+        updater->schedule_global("UpdateWeathers", &UpdateWeathersTask, m_timers[WUPDATE_WEATHERS].GetInterval());
+    }
+
+    /// <li> Update uptime table
+    if (m_timers[WUPDATE_UPTIME].Passed())
+    {
+        m_timers[WUPDATE_UPTIME].Reset();
+        updater->schedule_global("UpdateUptime", &UpdateUptimeTask, diff);
+    }
+
+    sMapMgr.FinishUpdate(diff);
 
     diffRecorder.RecordTimeFor("MapManager::update");
 
+    ReturnOldMails();
+    diffRecorder.RecordTimeFor("ReturnOldMails");
+
     if (accumulateMapDiff)
     {
         MAP_UPDATE_DIFF(MapUpdateDiff().PrintCumulativeMapUpdateDiff())
@@ -1792,6 +1962,13 @@ void World::Update(uint32 diff)
     sOutdoorPvPMgr.Update(diff);
     diffRecorder.RecordTimeFor("UpdateOutdoorPvPMgr");
 
+    sPlayerDirectory.Update(diff);
+    diffRecorder.RecordTimeFor("UpdatePlayerDirectory");
+
+    // objects deleted during map updates can be reused from now on
+    sObjectPoolMgr.Recycle();
+    diffRecorder.RecordTimeFor("RecycleObjectPools");
+
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
@@ -1852,6 +2029,31 @@ void World::Update(uint32 diff)
 
     ///- used by eluna
     sHookMgr->OnWorldUpdate(diff);
+
+    UpdateTickPhaseStats(tickStart, serialBeforeEnd, ACE_OS::gettimeofday(), updater->GetLastTickStats());
+}
+
+void World::UpdateTickPhaseStats(ACE_Time_Value const& tickStart, ACE_Time_Value const& serialBeforeEnd, ACE_Time_Value const& tickEnd, MapUpdaterTickStats const& parallel)
+{
+    uint32 tickTime = WorldTimer::getUSTimeDiff(tickStart, tickEnd);
+    uint32 serialBefore = WorldTimer::getUSTimeDiff(tickStart, serialBeforeEnd);
+
+    sPacketReplay.RecordTick(tickTime);
+
+    ++m_tickPhaseStats.ticks;
+    m_tickPhaseStats.serialBefore += serialBefore;
+    m_tickPhaseStats.parallel += parallel.wallTime;
+    m_tickPhaseStats.serialAfter += tickTime > serialBefore + parallel.wallTime ? tickTime - serialBefore - parallel.wallTime : 0;
+    m_tickPhaseStats.longestRequest += parallel.longestTime;
+    m_tickPhaseStats.busy += parallel.busyTime;
+
+    if (tickTime > m_tickPhaseStats.worstTick)
+    {
+        m_tickPhaseStats.worstTick = tickTime;
+        m_tickPhaseStats.worstLongestTime = parallel.longestTime;
+        m_tickPhaseStats.worstLongestMapId = parallel.longestMapId;
+        m_tickPhaseStats.worstLongestName = parallel.longestName;
+    }
 }
 
 void World::UpdateSessions(const uint32 & diff)
@@ -1907,6 +2109,8 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket *packet, WorldSession *self, uint32 team)
 {
+    ChatFanoutMessage message(packet);
+
     SessionMap::iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -1916,9 +2120,11 @@ void World::SendGlobalMessage(WorldPacket *packet, WorldSession *self, uint32 te
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            message.AddRecipient(itr->second);
         }
     }
+
+    message.Send();
 }
 
 void World::QueueGuildAnnounce(uint32 guildid, uint32 team, std::string &msg)
@@ -2004,6 +2210,7 @@ void World::SendGlobalGMMessage(WorldPacket *packet, WorldSession *self, uint32
 void World::SendWorldText(int32 string_id, uint32 preventFlags, ...)
 {
     std::vector<std::vector<WorldPacket*> > data_cache;     // 0 = default, i => i-1 locale index
+    std::vector<ChatRecipientList> recipients;              // sessions of each data_cache locale
 
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2044,14 +2251,22 @@ void World::SendWorldText(int32 string_id, uint32 preventFlags, ...)
         else
             data_list = &data_cache[cache_idx];
 
-        for (int i = 0; i < data_list->size(); ++i)
-            itr->second->SendPacket((*data_list)[i]);
+        if (recipients.size() < cache_idx+1)
+            recipients.resize(cache_idx+1);
+
+        recipients[cache_idx].push_back(itr->second);
     }
 
-    // free memory
+    // send and free memory
     for (int i = 0; i < data_cache.size(); ++i)
         for (int j = 0; j < data_cache[i].size(); ++j)
+        {
+            ChatFanoutMessage message(data_cache[i][j]);
+            message.AddRecipients(recipients[i]);
+            message.Send();
+
             delete data_cache[i][j];
+        }
 }
 
 // send global message for players in range <minLevel, maxLevel> which don't have account flags
@@ -2906,60 +3121,3 @@ void World::loadConfig(WorldConfigs index, const char* name, bool def)
     if (index < CONFIG_VALUE_COUNT)
         m_configs[index] = sConfig.GetBoolDefault(name, def);
 }
-
-CBTresholds World::GetCoreBalancerTreshold()
-{
-    return _coreBalancer.GetTreshold();
-}
-
-CoreBalancer::CoreBalancer() : _diffSum(0), _diffCount(0), _balanceTimer(0)
-{
-    _treshold = CB_DISABLE_NONE;
-}
-
-void CoreBalancer::Initialize()
-{
-    _balanceTimer.Reset(sWorld.getConfig(CONFIG_COREBALANCER_INTERVAL));
-}
-
-void CoreBalancer::Update(const uint32 diff)
-{
-    _diffSum += diff;
-    ++_diffCount;
-
-    _balanceTimer.Update(diff);
-    if (_balanceTimer.Passed())
-    {
-        uint32 diffAvg = _diffSum / _diffCount;;
-        if (diffAvg > sWorld.getConfig(CONFIG_COREBALANCER_PLAYABLE_DIFF))
-            IncreaseTreshold();
-        else
-        {
-            if (diffAvg +20 < sWorld.getConfig(CONFIG_COREBALANCER_PLAYABLE_DIFF))
-                DecreaseTreshold();
-        }
-
-        _diffSum = diff;
-        _diffCount = 1;
-
-        _balanceTimer.Reset(sWorld.getConfig(CONFIG_COREBALANCER_INTERVAL));
-    }
-}
-
-void CoreBalancer::IncreaseTreshold()
-{
-    uint32 t = _treshold;
-    if (t >= CB_TRESHOLD_MAX)
-        return;
-
-    _treshold = CBTresholds(++t);
-}
-
-void CoreBalancer::DecreaseTreshold()
-{
-    uint32 t = _treshold;
-    if (t <= CB_DISABLE_NONE)
-        return;
-
-    _treshold = CBTresholds(--t);
-}
@@ -46,7 +46,9 @@ class WorldPacket;
 class WorldSession;
 class Player;
 class Weather;
+struct Mail;
 struct ScriptAction;
+struct MapUpdaterTickStats;
 struct ScriptInfo;
 class SqlResultQueue;
 class QueryResult;
@@ -106,6 +108,15 @@ enum WorldConfigs
     CONFIG_ADDON_CHANNEL,
     CONFIG_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_GRID_UNLOAD,
+    CONFIG_GRID_PRELOAD_ENABLED,
+    CONFIG_GRID_PRELOAD_LOOKAHEAD,
+    CONFIG_GRID_PRELOAD_CELLS_PER_TICK,
+    CONFIG_GRID_PRELOAD_TERRAIN_PER_TICK,
+    CONFIG_OBJECT_POOL_ENABLED,
+    CONFIG_OBJECT_POOL_RESERVE,
+    CONFIG_GUID_REUSE_DELAY,
+    CONFIG_MOVEMENT_RELAY_FULL_RATE_DIST,
+    CONFIG_MOVEMENT_RELAY_FAR_HEARTBEAT_RATE,
 
     CONFIG_SOCKET_SELECTTIME,
     CONFIG_INTERVAL_GRIDCLEAN,
@@ -126,6 +137,10 @@ enum WorldConfigs
     CONFIG_SESSION_UPDATE_MIN_LOG_DIFF,
     CONFIG_INTERVAL_LOG_UPDATE,
     CONFIG_MIN_LOG_UPDATE,
+    CONFIG_TICK_TRACE_ENABLED,
+    CONFIG_TICK_TRACE_BUFFER_SIZE,
+    CONFIG_TICK_TRACE_DUMP_THRESHOLD,
+    CONFIG_TICK_TRACE_DUMP_SECONDS,
 
     // Server settings
     CONFIG_GAME_TYPE,
@@ -184,6 +199,9 @@ enum WorldConfigs
     CONFIG_GROUPLEADER_RECONNECT_PERIOD,
     CONFIG_INSTANCE_RESET_TIME_HOUR,
     CONFIG_INSTANCE_UNLOAD_DELAY,
+    CONFIG_INSTANCE_UNLOAD_GRIDS_PER_TICK,
+    CONFIG_INSTANCE_PREWARM_POPULAR,
+    CONFIG_INSTANCE_PREWARM_GRIDS_PER_TICK,
     CONFIG_MAIL_DELIVERY_DELAY,
     CONFIG_EXTERNAL_MAIL,
     CONFIG_EXTERNAL_MAIL_INTERVAL,
@@ -232,6 +250,9 @@ enum WorldConfigs
     CONFIG_CHATFLOOD_MESSAGE_COUNT,
     CONFIG_CHATFLOOD_MESSAGE_DELAY,
     CONFIG_CHATFLOOD_MUTE_TIME,
+    CONFIG_CHAT_FANOUT_ENABLED,
+    CONFIG_CHAT_FANOUT_MIN_RECIPIENTS,
+    CONFIG_CHAT_CHANNEL_RATE_LIMIT,
 
     // Game master settings
     CONFIG_GM_LOGIN_STATE,
@@ -342,22 +363,36 @@ enum WorldConfigs
     CONFIG_VMAP_INDOOR_CHECK,
     CONFIG_PET_LOS,
     CONFIG_VMAP_TOTEM,
+    CONFIG_VMAP_SIMD_INTERSECTION,
+    CONFIG_VMAP_LOS_CACHE_TTL,
     CONFIG_MMAP_ENABLED,
+    CONFIG_MMAP_MAP_TILE_FILES,
 
     // visibility and radiuses
     CONFIG_GROUP_VISIBILITY,
+    CONFIG_VISIBILITY_UPDATE_MAX_PER_TICK,
+    CONFIG_VISIBILITY_NEAR_BAND_PCT,
+    CONFIG_VISIBILITY_FAR_BAND_INTERVAL,
     
     // movement
     CONFIG_TARGET_POS_RECALCULATION_RANGE,
     CONFIG_TARGET_POS_RECHECK_TIMER,
     CONFIG_WAYPOINT_MOVEMENT_PATHFINDING_ON_CONTINENTS,
     CONFIG_WAYPOINT_MOVEMENT_PATHFINDING_IN_INSTANCES,
-
-    // CoreBalancer
-    CONFIG_COREBALANCER_ENABLED,
-    CONFIG_COREBALANCER_PLAYABLE_DIFF,
-    CONFIG_COREBALANCER_INTERVAL,
-    CONFIG_COREBALANCER_VISIBILITY_PENALTY,
+    CONFIG_WAYPOINT_MOVEMENT_SEGMENT_CACHE,
+    CONFIG_MOVEMENT_BATCH_SPLINES,
+
+    // MapLoadGovernor
+    CONFIG_MAPGOVERNOR_ENABLED,
+    CONFIG_MAPGOVERNOR_MAX_UPDATE_TIME,
+    CONFIG_MAPGOVERNOR_RECOVER_PCT,
+    CONFIG_MAPGOVERNOR_INTERVAL,
+    CONFIG_MAPGOVERNOR_RECOVER_INTERVALS,
+    CONFIG_MAPGOVERNOR_VISIBILITY_PENALTY,
+    CONFIG_MAPGOVERNOR_STEP_FEATURES,
+    CONFIG_MAPGOVERNOR_STEP_VISIBILITY,
+    CONFIG_MAPGOVERNOR_STEP_AI_NOTIFY,
+    CONFIG_MAPGOVERNOR_STEP_UPDATE_INTERVAL,
 
     // VMSS system
     CONFIG_VMSS_ENABLE,
@@ -461,6 +496,7 @@ enum Rates
     CONFIG_FLOAT_RATE_RAF_LEVELPERLEVEL,
     
     CONFIG_ANTICHEAT_SPEEDHACK_TOLERANCE,
+    RATE_VMAP_LOS_CACHE_QUANTUM,
     MAX_RATES
 };
 
@@ -576,11 +612,40 @@ enum CumulateMapDiff
 
     DIFF_MAP_SPECIAL_DATA_UPDATE = 10,
 
-    DIFF_MAX_CUMULATIVE_INFO     = 11
+    DIFF_VISIBILITY_UPDATE       = 11,
+
+    DIFF_MAX_CUMULATIVE_INFO     = 12
+};
+
+// per map event counts accumulated next to update diffs, not times
+enum CumulateMapCount
+{
+    COUNT_VISIBILITY_UPDATES     = 0,                       // visibility passes done
+
+    COUNT_MAX_CUMULATIVE_INFO    = 1
 };
 
 typedef ACE_Atomic_Op<ACE_Thread_Mutex, uint32> atomic_uint;
 
+// world tick phases accumulated since last reset, times in microseconds
+struct TickPhaseStats
+{
+    TickPhaseStats() : ticks(0), serialBefore(0), parallel(0), serialAfter(0), longestRequest(0), busy(0),
+        worstTick(0), worstLongestTime(0), worstLongestMapId(0), worstLongestName("") {}
+
+    uint32 ticks;
+    uint64 serialBefore;                                    // world thread until maps are scheduled
+    uint64 parallel;                                        // maps and global tasks on map update threads
+    uint64 serialAfter;                                     // transports and rest of world thread work
+    uint64 longestRequest;                                  // slowest map or task of each tick
+    uint64 busy;                                            // all map and task run times
+
+    uint32 worstTick;
+    uint32 worstLongestTime;                                // slowest request of worst tick
+    uint32 worstLongestMapId;
+    char const* worstLongestName;
+};
+
 struct MapUpdateDiffInfo
 {
 
@@ -588,6 +653,9 @@ struct MapUpdateDiffInfo
     {
         for (CumulativeDiffMap::iterator itr = _cumulativeDiffInfo.begin(); itr != _cumulativeDiffInfo.end(); ++itr)
             delete itr->second;
+
+        for (CumulativeDiffMap::iterator itr = _cumulativeCountInfo.begin(); itr != _cumulativeCountInfo.end(); ++itr)
+            delete itr->second;
     }
 
     void InitializeMapData();
@@ -599,6 +667,12 @@ struct MapUpdateDiffInfo
             for (int i = DIFF_SESSION_UPDATE; i < DIFF_MAX_CUMULATIVE_INFO; i++)
                 itr->second[i] = 0;
         }
+
+        for (CumulativeDiffMap::iterator itr = _cumulativeCountInfo.begin(); itr != _cumulativeCountInfo.end(); ++itr)
+        {
+            for (int i = COUNT_VISIBILITY_UPDATES; i < COUNT_MAX_CUMULATIVE_INFO; i++)
+                itr->second[i] = 0;
+        }
     }
 
     void CumulateDiffFor(CumulateMapDiff type, uint32 diff, uint32 mapid)
@@ -606,54 +680,17 @@ struct MapUpdateDiffInfo
         _cumulativeDiffInfo[mapid][type] += diff;
     }
 
+    void CumulateCountFor(CumulateMapCount type, uint32 count, uint32 mapid)
+    {
+        _cumulativeCountInfo[mapid][type] += count;
+    }
+
     void PrintCumulativeMapUpdateDiff();
 
     typedef std::map<uint32, atomic_uint*> CumulativeDiffMap;
 
     CumulativeDiffMap _cumulativeDiffInfo;
-};
-
-enum CBTresholds
-{
-    CB_DISABLE_NONE           = 0,
-    CB_DISABLE_LOW_PRIORITY   = 1,
-    CB_DISABLE_MID_PRIORITY   = 2,
-    CB_DISABLE_HIGH_PRIORITY  = 3,
-    CB_VISIBILITY_PENALTY     = 4,
-
-    CB_TRESHOLD_MAX,
-};
-
-
-inline
-bool operator>(FeaturePriority rhs, CBTresholds lhs)
-{
-    return static_cast<int>(rhs) > static_cast<int>(lhs);
-}
-
-inline
-bool operator<=(FeaturePriority rhs, CBTresholds lhs)
-{
-    return !(rhs > lhs);
-}
-
-class CoreBalancer
-{
-    public:
-        CoreBalancer();
-
-        void Initialize();
-        void Update(const uint32);
-        void IncreaseTreshold();
-        void DecreaseTreshold();
-
-        CBTresholds GetTreshold() const { return _treshold; }
-
-    private:
-        uint32 _diffSum;
-        uint32 _diffCount;
-        CBTresholds _treshold;
-        TimeTrackerSmall _balanceTimer;
+    CumulativeDiffMap _cumulativeCountInfo;
 };
 
 /// The World
@@ -695,6 +732,7 @@ class HELLGROUND_EXPORT World
         Weather* FindWeather(uint32 id) const;
         Weather* AddWeather(uint32 zone_id);
         void RemoveWeather(uint32 zone_id);
+        void SendZoneWeather(Player* player, uint32 zone_id);
 
         /// Get the active session server limit (or security level limitations)
         uint32 GetPlayerAmountLimit() const { return m_playerLimit; }
@@ -740,6 +778,8 @@ class HELLGROUND_EXPORT World
         uint32 GetUptime() const { return uint32(m_gameTime - m_startTime); }
         /// Update time
         uint32 GetUpdateTime() const { return m_updateTime; }
+        TickPhaseStats const& GetTickPhaseStats() const { return m_tickPhaseStats; }
+        void ResetTickPhaseStats() { m_tickPhaseStats = TickPhaseStats(); }
         void SetRecordDiffInterval(int32 t) { if (t >= 0) m_configs[CONFIG_INTERVAL_LOG_UPDATE] = (uint32)t; }
 
         /// Get the maximum skill level a player can reach
@@ -825,6 +865,7 @@ class HELLGROUND_EXPORT World
         bool IsScriptScheduled() const { return m_scheduledScripts > 0; }
 
         bool IsAllowedMap(uint32 mapid) { return m_forbiddenMapIds.count(mapid) == 0 ;}
+        std::set<uint32> const& GetPrewarmMapIds() const { return m_prewarmMapIds; }
 
         static float GetVisibleObjectGreyDistance()         { return m_VisibleObjectGreyDistance;     }
 
@@ -837,6 +878,13 @@ class HELLGROUND_EXPORT World
         void UpdateResultQueue();
         void InitResultQueue();
 
+        // global tasks run on map update threads in parallel with maps
+        void LoadOldMails();
+        void UpdateWeathers(uint32 diff);
+        void UpdateUptime();
+
+        // applies mails collected by LoadOldMails, world thread only
+        void ReturnOldMails();
         void ForceGameEventUpdate();
 
         void UpdateRealmCharCount(uint32 accid);
@@ -891,14 +939,13 @@ class HELLGROUND_EXPORT World
         LfgContainerType lfgHordeContainer;
         LfgContainerType lfgAllyContainer;
 
-        CBTresholds GetCoreBalancerTreshold();
-
         MAP_UPDATE_DIFF(MapUpdateDiffInfo& MapUpdateDiff() { return m_mapUpdateDiffInfo; })
 
     protected:
         void _UpdateGameTime();
         void InitDailyQuestResetTime();
         void ResetDailyQuests();
+        void UpdateTickPhaseStats(ACE_Time_Value const& tickStart, ACE_Time_Value const& serialBeforeEnd, ACE_Time_Value const& tickEnd, MapUpdaterTickStats const& parallel);
 
     private:
         static volatile bool m_stopEvent;
@@ -919,17 +966,20 @@ class HELLGROUND_EXPORT World
         IntervalTimer m_timers[WUPDATE_COUNT];
         uint32 mail_timer;
         uint32 mail_timer_expires;
+        std::vector<Mail*> m_oldMails;                      // filled by LoadOldMails task during map updates
+        time_t m_oldMailsTime;
         uint32 m_updateTime, m_updateTimeSum, m_avgUpdateTime, m_curAvgUpdateTime;
 
         uint32 m_updateTimeCount;
 
         MAP_UPDATE_DIFF(MapUpdateDiffInfo m_mapUpdateDiffInfo)
         uint64 m_serverUpdateTimeSum, m_serverUpdateTimeCount;
+        TickPhaseStats m_tickPhaseStats;
 
-        CoreBalancer _coreBalancer;
-
+        // weathers are added by map threads on zone change
         typedef UNORDERED_MAP<uint32, Weather*> WeatherMap;
         WeatherMap m_weathers;
+        mutable ACE_Thread_Mutex m_weathersLock;
         SessionMap m_sessions;
         typedef UNORDERED_MAP<uint32, time_t> DisconnectMap;
         DisconnectMap m_disconnects;
@@ -950,6 +1000,7 @@ class HELLGROUND_EXPORT World
         std::string m_motd;
         std::string m_dataPath;
         std::set<uint32> m_forbiddenMapIds;
+        std::set<uint32> m_prewarmMapIds;
 
         uint64 m_massMuteTime;
         std::string m_massMuteReason;
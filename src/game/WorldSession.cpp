@@ -48,6 +48,9 @@
 #include "WardenChat.h"
 #include "luaengine/HookMgr.h"
 #include "GuildMgr.h"
+#include "PacketCapture.h"
+#include "PacketReplay.h"
+#include "ChatFanout.h"
 
 bool MapSessionFilter::Process(WorldPacket * packet)
 {
@@ -90,15 +93,19 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
     return (plr->IsInWorld() == false);
 }
 
+RecvPathStats sRecvPathStats;
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket *sock, uint64 permissions, uint8 expansion, LocaleConstant locale, time_t mute_time, std::string mute_reason, time_t trollmute_time, std::string trollmute_reason, uint64 accFlags, uint16 opcDisabled) :
 LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mute_time), m_muteReason(mute_reason),
-m_trollmuteTime(trollmute_time), m_trollmuteReason(trollmute_reason), _player(NULL), m_Socket(sock),
+m_trollmuteTime(trollmute_time), m_trollmuteReason(trollmute_reason), _player(NULL), m_Socket(sock), m_replay(false),
 m_permissions(permissions), _accountId(id), m_expansion(expansion), m_opcodesDisabled(opcDisabled),
 m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
 _logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerSave(false), m_playerRecentlyLogout(false), m_latency(0), m_clientTimeDelay(0),
-m_accFlags(accFlags), m_Warden(NULL)
+m_movementHeartbeats(0), m_accFlags(accFlags), m_Warden(NULL), _recvLatencySum(0), _recvLatencyCount(0), _recvLatencyMax(0)
 {
+    _recvOverflow = false;
+
     _mailSendTimer.Reset(5*IN_MILISECONDS);
 
     _kickTimer.Reset(sWorld.getConfig(CONFIG_SESSION_UPDATE_IDLE_KICK));
@@ -135,9 +142,12 @@ WorldSession::~WorldSession()
     if (m_Warden)
         delete m_Warden;
 
-    WorldPacket* packet;
-    while (_recvQueue.next(packet))
-        delete packet;
+    ReceivedPacket received;
+    while (_recvQueue.next(received))
+        delete received.packet;
+
+    for (std::deque<ReceivedPacket>::iterator itr = _recvOverflowQueue.begin(); itr != _recvOverflowQueue.end(); ++itr)
+        delete itr->packet;
 
     static SqlStatementID updateAccountOnline;
     static SqlStatementID updateCharactersOnline;
@@ -208,7 +218,11 @@ void WorldSession::RemoveAccountFlag(AccountFlags flag)
 void WorldSession::SendPacket(WorldPacket const* packet)
 {
     if (!m_Socket)
+    {
+        if (m_replay)
+            sPacketReplay.RecordOutput(packet->size());
         return;
+    }
 
     #ifdef HELLGROUND_DEBUG
 
@@ -246,10 +260,30 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 
     #endif                                                  // !HELLGROUND_DEBUG
 
+    // chat fanout thread still holds earlier packets for this client, send behind them to keep order
+    if (m_Socket->HasFanoutPending())
+    {
+        if (WorldSocket* socket = AcquireSocket())
+        {
+            if (sChatFanout.QueueOrdered(*packet, socket))
+                return;
+        }
+    }
+
     if (m_Socket->SendPacket(*packet) == -1)
         m_Socket->CloseSocket();
 }
 
+WorldSocket* WorldSession::AcquireSocket()
+{
+    WorldSocket* socket = m_Socket;
+    if (!socket || socket->IsClosed())
+        return NULL;
+
+    socket->AddReference();
+    return socket;
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
@@ -260,12 +294,81 @@ void WorldSession::QueuePacket(WorldPacket* new_packet)
     if (i != _opcodesCooldown.end())
     {
         if (!i->second.Passed())
+        {
+            delete new_packet;
             return;
+        }
 
         i->second.SetCurrent(0);
     }
 
-    _recvQueue.add(new_packet);
+    ReceivedPacket received;
+    received.packet = new_packet;
+    received.receivedTime = WorldTimer::getMSTime();
+
+    // once anything went to overflow queue ring must stay untouched until it is drained
+    if (_recvOverflow || !_recvQueue.push(received))
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, _recvOverflowLock);
+        _recvOverflowQueue.push_back(received);
+        _recvOverflow = true;
+        ++sRecvPathStats.packetsOverflowed;
+    }
+}
+
+/// Take next packet accepted by updater, ring first then overflow queue
+bool WorldSession::NextReceivedPacket(WorldPacket*& packet, PacketFilter& updater)
+{
+    ReceivedPacket received;
+
+    if (_recvQueue.front(received))
+    {
+        if (!updater.Process(received.packet))
+            return false;
+
+        _recvQueue.pop_front();
+    }
+    else
+    {
+        // producer does not use ring while flag is set, so ring stays empty here
+        if (!_recvOverflow)
+            return false;
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _recvOverflowLock, false);
+
+        if (_recvOverflowQueue.empty())
+            return false;
+
+        received = _recvOverflowQueue.front();
+        if (!updater.Process(received.packet))
+            return false;
+
+        _recvOverflowQueue.pop_front();
+        if (_recvOverflowQueue.empty())
+            _recvOverflow = false;
+    }
+
+    uint32 latency = WorldTimer::getMSTimeDiffToNow(received.receivedTime);
+    _recvLatencySum += latency;
+    ++_recvLatencyCount;
+    if (latency > _recvLatencyMax)
+        _recvLatencyMax = latency;
+
+    packet = received.packet;
+
+    if (sPacketCapture.IsActive() && !m_replay)
+        sPacketCapture.Record(*this, *packet, received.receivedTime);
+
+    return true;
+}
+
+/// Return handled packet to socket free list, socket is still referenced by session here
+void WorldSession::RecyclePacket(WorldPacket* packet)
+{
+    if (m_Socket)
+        m_Socket->RecyclePacket(packet);
+    else
+        delete packet;
 }
 
 /// Logging helper for unexpected opcodes
@@ -383,18 +486,26 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     try
     {
-        while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
+        while ((m_Socket ? !m_Socket->IsClosed() : m_replay) && NextReceivedPacket(packet, updater))
         {
+            TraceZone traceOpcode(LookupOpcodeName(packet->GetOpcode()), packet->GetOpcode());
+
             if (verbose > 0)
             {
                 RecordVerboseTimeDiff(true);
                 ProcessPacket(packet);
                 packetOpcodeInfo.push_back(VerboseLogInfo(packet->GetOpcode(), RecordVerboseTimeDiff(false)));
             }
+            else if (m_replay)
+            {
+                ACE_Time_Value start = ACE_OS::gettimeofday();
+                ProcessPacket(packet);
+                sPacketReplay.RecordOpcode(packet->GetOpcode(), WorldTimer::getUSTimeDiff(start, ACE_OS::gettimeofday()));
+            }
             else
                 ProcessPacket(packet);
 
-            delete packet;
+            RecyclePacket(packet);
         }
     }
     catch (...)
@@ -403,6 +514,20 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         KickPlayer();
     }
 
+    if (_recvLatencyCount)
+    {
+        sRecvPathStats.latencySum += _recvLatencySum;
+        sRecvPathStats.latencyCount += _recvLatencyCount;
+
+        uint32 latencyMax = sRecvPathStats.latencyMax;
+        while (_recvLatencyMax > latencyMax)
+            latencyMax = sRecvPathStats.latencyMax.compare_and_swap(_recvLatencyMax, latencyMax);
+
+        _recvLatencySum = 0;
+        _recvLatencyCount = 0;
+        _recvLatencyMax = 0;
+    }
+
     bool overtime = false;
     uint32 overtimediff = RecordSessionTimeDiff("[%s]: packets. Accid %u ", __FUNCTION__, GetAccountId());
 
@@ -466,7 +591,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     {
         ///- If necessary, log the player out
         time_t currTime = time(NULL);
-        if (!m_Socket || (ShouldLogOut(currTime) && !m_playerLoading))
+        if ((!m_Socket && !m_replay) || (ShouldLogOut(currTime) && !m_playerLoading))
             LogoutPlayer(true);
     }
 
@@ -477,7 +602,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         m_Socket = NULL;
     }
 
-    if (!m_Socket)
+    if (!m_Socket && !m_replay)
         return false;                                       //Will remove this session from the world session map
 
     return true;
@@ -683,6 +808,8 @@ void WorldSession::KickPlayer()
 {
     if (m_Socket)
         m_Socket->CloseSocket();
+
+    m_replay = false;
 }
 
 /// Cancel channeling handler
@@ -32,6 +32,9 @@
 #include "AuctionHouseMgr.h"
 #include "WardenBase.h"
 #include "Item.h"
+#include "SPSCQueue.h"
+
+#include <deque>
 
 struct ItemPrototype;
 struct AuctionEntry;
@@ -148,6 +151,22 @@ class WorldSessionFilter : public PacketFilter
         bool ProcessWardenUpdate() const { return true; }
 };
 
+/// Counters of the client packet receive path, reported by .server packetstats
+struct RecvPathStats
+{
+    tbb::atomic<uint64> packetsAllocated;                  // receive buffers created by sockets
+    tbb::atomic<uint64> packetsReused;                     // receive buffers taken from socket free lists
+    tbb::atomic<uint64> packetsOverflowed;                 // packets queued past full session ring
+    tbb::atomic<uint64> latencySum;                        // ms between socket read and handler dispatch
+    tbb::atomic<uint64> latencyCount;
+    tbb::atomic<uint32> latencyMax;
+};
+
+extern RecvPathStats sRecvPathStats;
+
+// packets a session may hold before socket thread has to fall back to locked overflow queue
+#define WORLDSESSION_RECV_QUEUE_SIZE 256
+
 /// Player session in the World
 class HELLGROUND_IMPORT_EXPORT WorldSession
 {
@@ -163,6 +182,12 @@ class HELLGROUND_IMPORT_EXPORT WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        // socket with added reference for sending outside of session updates, NULL when disconnected
+        WorldSocket* AcquireSocket();
+
+        // session without socket driven by PacketReplay, ends when flag is cleared
+        bool IsReplay() const { return m_replay; }
+        void SetReplay(bool replay) { m_replay = replay; }
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName *declinedName);
@@ -272,10 +297,8 @@ class HELLGROUND_IMPORT_EXPORT WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction);
         static void SendAuctionOutbiddedMail(AuctionEntry *auction);
         void SendAuctionCancelledToBidderMail(AuctionEntry *auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
-            uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull);
-        void BuildListAuctionItems(AuctionHouseObject::AuctionEntryMap const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
-            uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull);
+        void BuildListAuctionItems(AuctionHouseObject* auctionHouse, AuctionListFilter const& filter, WorldPacket& data, uint32 listfrom, uint32 usable,
+            uint32& count, uint32& totalcount, bool isFull);
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid);
 
@@ -760,11 +783,13 @@ class HELLGROUND_IMPORT_EXPORT WorldSession
 
         
         uint32 m_clientTimeDelay;
+        uint32 m_movementHeartbeats;                        // relayed heartbeats of controlled mover
 
         // logging helper
         void logUnexpectedOpcode(WorldPacket *packet, const char * reason);
         Player *_player;
         WorldSocket *m_Socket;
+        bool m_replay;
         std::string m_Address;
 
         uint64 m_permissions;
@@ -796,7 +821,27 @@ class HELLGROUND_IMPORT_EXPORT WorldSession
         typedef UNORDERED_MAP<uint16,ShortIntervalTimer> OpcodesCooldown;
         OpcodesCooldown _opcodesCooldown;
 
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+        struct ReceivedPacket
+        {
+            WorldPacket* packet;
+            uint32 receivedTime;
+        };
+
+        bool NextReceivedPacket(WorldPacket*& packet, PacketFilter& updater);
+        void RecyclePacket(WorldPacket* packet);
+
+        // socket thread is the only producer, session updater the only consumer
+        ACE_Based::SPSCQueue<ReceivedPacket, WORLDSESSION_RECV_QUEUE_SIZE> _recvQueue;
+
+        // used only when ring is full, set by producer and cleared by consumer under lock
+        // while set producer appends here so packet order is kept
+        std::deque<ReceivedPacket> _recvOverflowQueue;
+        ACE_Thread_Mutex _recvOverflowLock;
+        tbb::atomic<bool> _recvOverflow;
+
+        uint64 _recvLatencySum;
+        uint32 _recvLatencyCount;
+        uint32 _recvLatencyMax;
 
         uint32 m_currentSessionTime;
         uint32 m_currentVerboseTime;
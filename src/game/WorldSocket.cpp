@@ -83,6 +83,7 @@ m_Header(sizeof(ClientPktHeader)),
 m_OutBuffer(0),
 m_OutBufferSize(65536),
 m_OutActive(false),
+m_FanoutPending(0),
 m_Seed(static_cast<uint32>(rand32()))
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
@@ -103,6 +104,12 @@ WorldSocket::~WorldSocket(void)
     WorldPacket* pct;
     while (m_PacketQueue.dequeue_head(pct) == 0)
         delete pct;
+
+    while (m_FreeSmallPackets.next(pct))
+        delete pct;
+
+    while (m_FreeLargePackets.next(pct))
+        delete pct;
 }
 
 bool WorldSocket::IsClosed(void) const
@@ -377,7 +384,12 @@ int WorldSocket::handle_input_header(void)
 
     header.size -= 4;
 
-    ACE_NEW_RETURN(m_RecvWPct, WorldPacket((uint16) header.cmd, header.size), -1);
+    m_RecvWPct = AcquirePacket((uint16) header.cmd, header.size);
+    if (!m_RecvWPct)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
 
     if (header.size > 0)
     {
@@ -392,6 +404,41 @@ int WorldSocket::handle_input_header(void)
     return 0;
 }
 
+WorldPacket* WorldSocket::AcquirePacket(uint16 opcode, size_t size)
+{
+    WorldPacket* pct = NULL;
+    bool small = size <= WORLDSOCKET_SMALL_PACKET_SIZE;
+
+    if (small ? m_FreeSmallPackets.next(pct) : m_FreeLargePackets.next(pct))
+    {
+        pct->Initialize(opcode, size);
+        ++sRecvPathStats.packetsReused;
+        return pct;
+    }
+
+    // small packets get full class capacity so they never grow after recycling
+    ++sRecvPathStats.packetsAllocated;
+    return new (std::nothrow) WorldPacket(opcode, small ? WORLDSOCKET_SMALL_PACKET_SIZE : size);
+}
+
+void WorldSocket::RecyclePacket(WorldPacket* pct)
+{
+    size_t capacity = pct->capacity();
+
+    if (capacity <= WORLDSOCKET_SMALL_PACKET_SIZE)
+    {
+        if (m_FreeSmallPackets.push(pct))
+            return;
+    }
+    else if (capacity <= WORLDSOCKET_LARGE_PACKET_SIZE)
+    {
+        if (m_FreeLargePackets.push(pct))
+            return;
+    }
+
+    delete pct;
+}
+
 int WorldSocket::handle_input_payload(void)
 {
     // set errno properly here on error !!!
@@ -37,6 +37,7 @@
 #include <ace/Guard_T.h>
 #include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
+#include <ace/Atomic_Op.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -44,6 +45,16 @@
 
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
+#include "SPSCQueue.h"
+
+/// Receive buffers up to this size are kept in small free list and allocated with this capacity.
+#define WORLDSOCKET_SMALL_PACKET_SIZE 128
+
+/// Larger receive buffers are kept up to this capacity, anything bigger is freed.
+#define WORLDSOCKET_LARGE_PACKET_SIZE 1024
+
+/// Number of free receive buffers kept per size class.
+#define WORLDSOCKET_FREE_PACKETS 32
 
 class ACE_Message_Block;
 class WorldPacket;
@@ -126,6 +137,16 @@ class WorldSocket : protected WorldHandler
         /// Remove reference to this object.
         long RemoveReference (void);
 
+        /// Chat fanout copies queued for this socket and not sent yet, while there are any
+        /// session sends its packets behind them through fanout thread to keep packet order.
+        void FanoutQueued (void) { ++m_FanoutPending; }
+        void FanoutSent (void) { --m_FanoutPending; }
+        bool HasFanoutPending (void) const { return m_FanoutPending.value() != 0; }
+
+        /// Give back a packet received on this socket once the session has handled it.
+        /// Must be called only from thread updating the owning session.
+        void RecyclePacket (WorldPacket* pct);
+
     protected:
         /// things called by ACE framework.
         WorldSocket (void);
@@ -153,6 +174,7 @@ class WorldSocket : protected WorldHandler
     private:
         /// Helper functions for processing incoming data.
         int handle_input_header (void);
+        WorldPacket* AcquirePacket (uint16 opcode, size_t size);
         int handle_input_payload (void);
         int handle_input_missing_data (void);
 
@@ -212,6 +234,10 @@ class WorldSocket : protected WorldHandler
         /// It wont free memory when its deleted. m_RecvWPct takes care of freeing.
         ACE_Message_Block m_RecvPct;
 
+        /// Handled packets returned by session, filled by session updater, drained by reactor thread.
+        ACE_Based::SPSCQueue<WorldPacket*, WORLDSOCKET_FREE_PACKETS> m_FreeSmallPackets;
+        ACE_Based::SPSCQueue<WorldPacket*, WORLDSOCKET_FREE_PACKETS> m_FreeLargePackets;
+
         /// Fragment of the received header.
         ACE_Message_Block m_Header;
 
@@ -231,6 +257,9 @@ class WorldSocket : protected WorldHandler
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// Number of chat fanout requests holding this socket
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_FanoutPending;
+
         uint32 m_Seed;
 
         uint8 operatingSystem; // stores client's operating system
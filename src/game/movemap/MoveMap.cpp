@@ -130,8 +130,23 @@ namespace MMAP
         char *fileName = new char[pathLen];
         snprintf(fileName, pathLen, (sWorld.GetDataPath()+"mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
 
-        FILE *file = fopen(fileName, "rb");
-        if (!file)
+        // mapped tile is used in place: pages are loaded on first touch, only those detour writes
+        // links to become private copies, the rest stays shared page cache
+        ACE_Mem_Map* mappedFile = NULL;
+        if (sWorld.getConfig(CONFIG_MMAP_MAP_TILE_FILES))
+        {
+            mappedFile = new ACE_Mem_Map();
+            if (mappedFile->map(fileName, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) == 0)
+                mappedFile->close_handle();
+            else
+            {
+                delete mappedFile;
+                mappedFile = NULL;
+            }
+        }
+
+        FILE *file = mappedFile ? NULL : fopen(fileName, "rb");
+        if (!mappedFile && !file)
         {
             sLog.outDebug("MMAP:loadMap: Could not open mmtile file '%s'", fileName);
             delete [] fileName;
@@ -141,11 +156,18 @@ namespace MMAP
 
         // read header
         MmapTileHeader fileHeader;
-        fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
+        memset(&fileHeader, 0, sizeof(MmapTileHeader));
+        if (file)
+            fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
+        else if (mappedFile->size() >= sizeof(MmapTileHeader))
+            memcpy(&fileHeader, mappedFile->addr(), sizeof(MmapTileHeader));
 
         if (fileHeader.mmapMagic != MMAP_MAGIC)
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            if (file)
+                fclose(file);
+            delete mappedFile;
             return false;
         }
 
@@ -153,29 +175,51 @@ namespace MMAP
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                                                 mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
+            if (file)
+                fclose(file);
+            delete mappedFile;
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        ASSERT(data);
+        unsigned char* data = NULL;
+        if (mappedFile)
+        {
+            if (mappedFile->size() - sizeof(MmapTileHeader) < fileHeader.size)
+            {
+                sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                delete mappedFile;
+                return false;
+            }
 
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if(!result)
+            data = (unsigned char*)mappedFile->addr() + sizeof(MmapTileHeader);
+        }
+        else
         {
-            sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+            ASSERT(data);
+
+            size_t result = fread(data, fileHeader.size, 1, file);
+            if(!result)
+            {
+                sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                fclose(file);
+                dtFree(data);
+                return false;
+            }
+
             fclose(file);
-            return false;
         }
 
-        fclose(file);
-
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if(DT_SUCCESS == mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef))
+        // mapped data is not, mapping is closed after the tile is removed
+        if(DT_SUCCESS == mmap->navMesh->addTile(data, fileHeader.size, mappedFile ? 0 : DT_TILE_FREE_DATA, 0, &tileRef))
         {
             mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            if (mappedFile)
+                mmap->mappedTiles.insert(std::pair<uint32, ACE_Mem_Map*>(packedGridPos, mappedFile));
             ++loadedTiles;
             sLog.outDetail("MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
             return true;
@@ -183,13 +227,26 @@ namespace MMAP
         else
         {
             sLog.outLog(LOG_DEFAULT, "ERROR: MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            if (mappedFile)
+                delete mappedFile;
+            else
+                dtFree(data);
             return false;
         }
 
         return false;
     }
 
+    void MMapManager::unmapTile(MMapData* mmap, uint32 packedGridPos)
+    {
+        MMapTileFiles::iterator itr = mmap->mappedTiles.find(packedGridPos);
+        if (itr == mmap->mappedTiles.end())
+            return;
+
+        delete itr->second;
+        mmap->mappedTiles.erase(itr);
+    }
+
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
@@ -225,6 +282,7 @@ namespace MMAP
         else
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
+            unmapTile(mmap, packedGridPos);
             --loadedTiles;
             sLog.outDetail("MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
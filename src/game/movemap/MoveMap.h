@@ -22,6 +22,8 @@
 
 #include "Utilities/UnorderedMap.h"
 
+#include <ace/Mem_Map.h>
+
 #include "../../dep/recastnavigation/Detour/Include/DetourAlloc.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMeshQuery.h"
@@ -42,6 +44,7 @@ namespace MMAP
 {
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
     typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef UNORDERED_MAP<uint32, ACE_Mem_Map*> MMapTileFiles;
 
     // dummy struct to hold map's mmap data
     struct MMapData
@@ -54,6 +57,10 @@ namespace MMAP
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
+
+            // tiles of freed navMesh pointed into these
+            for (MMapTileFiles::iterator i = mappedTiles.begin(); i != mappedTiles.end(); ++i)
+                delete i->second;
         }
 
         dtNavMesh* navMesh;
@@ -61,6 +68,7 @@ namespace MMAP
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        MMapTileFiles mappedTiles;          // maps [map grid coords] to mmtile file used in place by [dtTile]
     };
 
 
@@ -87,6 +95,7 @@ namespace MMAP
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
         private:
             bool loadMapData(uint32 mapId);
+            void unmapTile(MMapData* mmap, uint32 packedGridPos);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet loadedMMaps;
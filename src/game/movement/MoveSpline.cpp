@@ -58,6 +58,26 @@ Location MoveSpline::ComputePosition() const
     return c;
 }
 
+bool MoveSpline::GetCurrentSegment(const Vector3*& points, float& u, bool& linear) const
+{
+    ASSERT(Initialized());
+
+    if (splineflags.falling || splineflags.done)
+        return false;
+
+    // linear splines are initialized like catmullrom ones, so virtual points around segment exist for both
+    if (spline.mode() != SplineBase::ModeLinear && spline.mode() != SplineBase::ModeCatmullrom)
+        return false;
+
+    u = 1.f;
+    int32 seg_time = spline.length(point_Idx,point_Idx+1);
+    if (seg_time > 0)
+        u = (time_passed - spline.length(point_Idx)) / (float)seg_time;
+    points = &spline.getPoint(point_Idx - 1);
+    linear = spline.mode() == SplineBase::ModeLinear;
+    return true;
+}
+
 void MoveSpline::computeFallElevation(float& el) const
 {
     float z_now = spline.getPoint(spline.first()).z - Movement::computeFallElevation(MSToSec(time_passed));
@@ -107,6 +107,10 @@ namespace Movement
 
         Location ComputePosition() const;
 
+        /** Control points of current segment (4, starting at point_Idx-1) and position u in it, used by MoveSplineBatch.
+            Returns false when position needs ComputePosition: falling or finished spline. */
+        bool GetCurrentSegment(const Vector3*& points, float& u, bool& linear) const;
+
         uint32 GetId() const { return m_Id;}
         bool Finalized() const { return splineflags.done; }
         bool isCyclic() const { return splineflags.cyclic;}
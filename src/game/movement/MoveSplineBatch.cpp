@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "MoveSplineBatch.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Movement
+{
+
+bool MoveSplineBatch::Add(const MoveSpline& spline, uint64 guid)
+{
+    const Vector3* points;
+    float u;
+    bool linear;
+    if (!spline.GetCurrentSegment(points, u, linear))
+        return false;
+
+    m_guids.push_back(guid);
+    m_splineIds.push_back(spline.GetId());
+    m_u.push_back(u);
+    m_linear.push_back(linear ? ~uint32(0) : 0);
+    for (uint8 k = 0; k < 4; ++k)
+    {
+        m_points[k][0].push_back(points[k].x);
+        m_points[k][1].push_back(points[k].y);
+        m_points[k][2].push_back(points[k].z);
+    }
+    return true;
+}
+
+void MoveSplineBatch::Evaluate()
+{
+    uint32 count = m_guids.size();
+    if (!count)
+        return;
+
+    m_x.resize(count);
+    m_y.resize(count);
+    m_z.resize(count);
+    m_o.resize(count);
+
+#ifdef __SSE2__
+    uint32 blocks = count & ~3;
+    if (blocks)
+        EvaluateBlocks(blocks);
+    EvaluateScalar(blocks, count - blocks);
+#else
+    EvaluateScalar(0, count);
+#endif
+}
+
+void MoveSplineBatch::Clear()
+{
+    m_guids.clear();
+    m_splineIds.clear();
+    m_u.clear();
+    m_linear.clear();
+    for (uint8 k = 0; k < 4; ++k)
+        for (uint8 axis = 0; axis < 3; ++axis)
+            m_points[k][axis].clear();
+}
+
+void MoveSplineBatch::EvaluateScalar(uint32 first, uint32 count)
+{
+    for (uint32 i = first; i < first + count; ++i)
+    {
+        float t = m_u[i];
+        float w[4], d[4];
+        if (m_linear[i])
+        {
+            w[0] = 0.f; w[1] = 1.f - t; w[2] = t;   w[3] = 0.f;
+            d[0] = 0.f; d[1] = -1.f;    d[2] = 1.f; d[3] = 0.f;
+        }
+        else
+        {
+            // (t^3, t^2, t, 1) and (3t^2, 2t, 1, 0) times catmullrom coefficients
+            float t2 = t * t, t3 = t2 * t;
+            w[0] = -0.5f * t3 + t2 - 0.5f * t;
+            w[1] = 1.5f * t3 - 2.5f * t2 + 1.f;
+            w[2] = -1.5f * t3 + 2.f * t2 + 0.5f * t;
+            w[3] = 0.5f * t3 - 0.5f * t2;
+            d[0] = -1.5f * t2 + 2.f * t - 0.5f;
+            d[1] = 4.5f * t2 - 5.f * t;
+            d[2] = -4.5f * t2 + 4.f * t + 0.5f;
+            d[3] = 1.5f * t2 - t;
+        }
+
+        float pos[3], der[3];
+        for (uint8 axis = 0; axis < 3; ++axis)
+        {
+            pos[axis] = der[axis] = 0.f;
+            for (uint8 k = 0; k < 4; ++k)
+            {
+                pos[axis] += w[k] * m_points[k][axis][i];
+                der[axis] += d[k] * m_points[k][axis][i];
+            }
+        }
+
+        m_x[i] = pos[0];
+        m_y[i] = pos[1];
+        m_z[i] = pos[2];
+        m_o[i] = atan2(der[1], der[0]);
+    }
+}
+
+#ifdef __SSE2__
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 Weigh(__m128 w0, __m128 w1, __m128 w2, __m128 w3, const std::vector<float> (&points)[4][3], uint8 axis, uint32 i)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, _mm_loadu_ps(&points[0][axis][i])), _mm_mul_ps(w1, _mm_loadu_ps(&points[1][axis][i]))),
+                      _mm_add_ps(_mm_mul_ps(w2, _mm_loadu_ps(&points[2][axis][i])), _mm_mul_ps(w3, _mm_loadu_ps(&points[3][axis][i]))));
+}
+
+void MoveSplineBatch::EvaluateBlocks(uint32 count)
+{
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.f);
+
+    for (uint32 i = 0; i < count; i += 4)
+    {
+        const __m128 t = _mm_loadu_ps(&m_u[i]);
+        const __m128 t2 = _mm_mul_ps(t, t);
+        const __m128 t3 = _mm_mul_ps(t2, t);
+        const __m128 linear = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&m_linear[i]));
+
+        // catmullrom weights of position and derivative, see EvaluateScalar
+        __m128 w0 = _mm_sub_ps(_mm_sub_ps(t2, _mm_mul_ps(half, t3)), _mm_mul_ps(half, t));
+        __m128 w1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.5f), t3), _mm_mul_ps(_mm_set1_ps(2.5f), t2)), one);
+        __m128 w2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.f), t2), _mm_mul_ps(_mm_set1_ps(1.5f), t3)), _mm_mul_ps(half, t));
+        __m128 w3 = _mm_mul_ps(half, _mm_sub_ps(t3, t2));
+        __m128 d0 = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.f), t), _mm_mul_ps(_mm_set1_ps(1.5f), t2)), half);
+        __m128 d1 = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(4.5f), t2), _mm_mul_ps(_mm_set1_ps(5.f), t));
+        __m128 d2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(4.f), t), _mm_mul_ps(_mm_set1_ps(4.5f), t2)), half);
+        __m128 d3 = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.5f), t2), t);
+
+        // linear lanes: (0, 1 - t, t, 0) and (0, -1, 1, 0)
+        w0 = _mm_andnot_ps(linear, w0);
+        w1 = Select(linear, _mm_sub_ps(one, t), w1);
+        w2 = Select(linear, t, w2);
+        w3 = _mm_andnot_ps(linear, w3);
+        d0 = _mm_andnot_ps(linear, d0);
+        d1 = Select(linear, _mm_set1_ps(-1.f), d1);
+        d2 = Select(linear, one, d2);
+        d3 = _mm_andnot_ps(linear, d3);
+
+        _mm_storeu_ps(&m_x[i], Weigh(w0, w1, w2, w3, m_points, 0, i));
+        _mm_storeu_ps(&m_y[i], Weigh(w0, w1, w2, w3, m_points, 1, i));
+        _mm_storeu_ps(&m_z[i], Weigh(w0, w1, w2, w3, m_points, 2, i));
+
+        float dx[4], dy[4];
+        _mm_storeu_ps(dx, Weigh(d0, d1, d2, d3, m_points, 0, i));
+        _mm_storeu_ps(dy, Weigh(d0, d1, d2, d3, m_points, 1, i));
+        for (uint8 lane = 0; lane < 4; ++lane)
+            m_o[i + lane] = atan2(dy[lane], dx[lane]);
+    }
+}
+#endif
+
+}
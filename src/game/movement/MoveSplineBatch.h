@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_MOVESPLINEBATCH_H
+#define HELLGROUND_MOVESPLINEBATCH_H
+
+#include "MoveSpline.h"
+
+namespace Movement
+{
+    /**
+     * MoveSplineBatch - positions of many moving units evaluated together.
+     *
+     * Add() copies control points of spline's current segment into struct of arrays, Evaluate()
+     * then computes position and direction of 4 splines at a time (SSE2 builds), with the same
+     * catmullrom and linear weights as SplineBase. Results are read by index until Clear().
+     */
+    class MoveSplineBatch
+    {
+    public:
+        // false when spline can't be batched and has to use MoveSpline::ComputePosition
+        bool Add(const MoveSpline& spline, uint64 guid);
+
+        void Evaluate();
+        void Clear();
+
+        uint32 Size() const { return m_guids.size();}
+        bool Empty() const { return m_guids.empty();}
+        uint64 GetGuid(uint32 i) const { return m_guids[i];}
+        uint32 GetSplineId(uint32 i) const { return m_splineIds[i];}
+        Location GetLocation(uint32 i) const { return Location(m_x[i], m_y[i], m_z[i], m_o[i]);}
+
+    private:
+        void EvaluateScalar(uint32 first, uint32 count);
+#ifdef __SSE2__
+        void EvaluateBlocks(uint32 count);
+#endif
+
+        std::vector<uint64> m_guids;
+        std::vector<uint32> m_splineIds;
+        std::vector<float>  m_u;
+        std::vector<uint32> m_linear;               // ~0 for linear segment, lane mask in SSE2 path
+        std::vector<float>  m_points[4][3];         // [control point][axis]
+
+        std::vector<float>  m_x, m_y, m_z, m_o;
+    };
+}
+
+#endif
@@ -246,10 +246,10 @@ bool BIH::writeToFile(FILE *wf) const
     check += fwrite(&bounds.low(), sizeof(float), 3, wf);
     check += fwrite(&bounds.high(), sizeof(float), 3, wf);
     check += fwrite(&treeSize, sizeof(uint32), 1, wf);
-    check += fwrite(&tree[0], sizeof(uint32), treeSize, wf);
+    check += fwrite(tree.data(), sizeof(uint32), treeSize, wf);
     count = objects.size();
     check += fwrite(&count, sizeof(uint32), 1, wf);
-    check += fwrite(&objects[0], sizeof(uint32), count, wf);
+    check += fwrite(objects.data(), sizeof(uint32), count, wf);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
@@ -262,14 +262,33 @@ bool BIH::readFromFile(FILE *rf)
     check += fread(&hi, sizeof(float), 3, rf);
     bounds = AABox(lo, hi);
     check += fread(&treeSize, sizeof(uint32), 1, rf);
-    tree.resize(treeSize);
-    check += fread(&tree[0], sizeof(uint32), treeSize, rf);
+    BIHVector tempTree(treeSize);
+    if (treeSize)
+        check += fread(&tempTree[0], sizeof(uint32), treeSize, rf);
+    tree.assign(tempTree);
     check += fread(&count, sizeof(uint32), 1, rf);
-    objects.resize(count); // = new uint32[nObjects];
-    check += fread(&objects[0], sizeof(uint32), count, rf);
+    BIHVector tempObjects(count); // = new uint32[nObjects];
+    if (count)
+        check += fread(&tempObjects[0], sizeof(uint32), count, rf);
+    objects.assign(tempObjects);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
+bool BIH::readFromFile(VMAP::ChunkReader &reader)
+{
+    uint32 treeSize, count;
+    Vector3 lo, hi;
+    bool result = true;
+    if (result && !reader.read(&lo, sizeof(float) * 3)) result = false;
+    if (result && !reader.read(&hi, sizeof(float) * 3)) result = false;
+    bounds = AABox(lo, hi);
+    if (result && !reader.read(&treeSize, sizeof(uint32))) result = false;
+    if (result && !reader.readArray(tree, treeSize)) result = false;
+    if (result && !reader.read(&count, sizeof(uint32))) result = false;
+    if (result && !reader.readArray(objects, count)) result = false;
+    return result;
+}
+
 void BIH::BuildStats::updateLeaf(int depth, int n)
 {
     numLeaves++;
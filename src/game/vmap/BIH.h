@@ -33,6 +33,7 @@
 #include <cmath>
 
 #include "LockedVector.h"
+#include "MappedFile.h"
 
 #define MAX_STACK_SIZE 64
 
@@ -123,18 +124,32 @@ class BIH
             if (printStats)
                 stats.printStats();
 
-            objects.resize(dat.numPrims);
-            for (uint32 i=0; i<dat.numPrims; ++i)
-                objects[i] = dat.indices[i];
+            BIHVector tempObjects(dat.indices, dat.indices + dat.numPrims);
             //nObjects = dat.numPrims;
-            tree = tempTree;
+            objects.assign(tempObjects);
+            tree.assign(tempTree);
             delete[] dat.primBound;
             delete[] dat.indices;
         }
-        uint32 primCount() { return objects.size(); }
+        uint32 primCount() const { return objects.size(); }
+
+        uint32 primIndex(uint32 position) const { return objects[position]; }
 
         template<typename RayCallback>
         void intersectRay(const Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst=false) const
+        {
+            ObjectLeafCallback<RayCallback> leafCallback(intersectCallback, objects);
+            intersectRayLeaves(r, leafCallback, maxDist, stopAtFirst);
+        }
+
+        /**
+        Same traversal as intersectRay, but whole leaf is passed to the callback:
+        bool operator()(const Ray &r, uint32 first, uint32 count, float &maxDist, bool stopAtFirst)
+        gets positions [first, first + count) of primitives in tree order (see primIndex)
+        and returns true when traversal shall stop.
+        */
+        template<typename LeafCallback>
+        void intersectRayLeaves(const Ray &r, LeafCallback& leafCallback, float &maxDist, bool stopAtFirst=false) const
         {
             float intervalMin = -1.0f;
             float intervalMax = -1.0f;
@@ -259,14 +274,8 @@ class BIH
                         {
                             // leaf - test some objects
                             int n = tree[node + 1];
-                            while (n > 0)
-                            {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
-                                if(stopAtFirst && hit)
-                                    return;
-                                --n;
-                                ++offset;
-                            }
+                            if (n > 0 && leafCallback(r, offset, n, maxDist, stopAtFirst))
+                                return;
                             break;
                         }
                     }
@@ -403,12 +412,33 @@ class BIH
 
         bool writeToFile(FILE *wf) const;
         bool readFromFile(FILE *rf);
+        //! tree and objects are used in place when the reader works on mapped file
+        bool readFromFile(VMAP::ChunkReader &reader);
 
     protected:
-        BIHVector tree;
-        BIHVector objects;
+        VMAP::MappedArray<uint32> tree;
+        VMAP::MappedArray<uint32> objects;
         AABox bounds;
 
+        // passes objects of a leaf one by one to intersectRay callback
+        template<typename RayCallback>
+        struct ObjectLeafCallback
+        {
+            ObjectLeafCallback(RayCallback& callback, const VMAP::MappedArray<uint32>& objs): intersectCallback(callback), objects(objs) {}
+            bool operator()(const Ray &r, uint32 first, uint32 count, float &maxDist, bool stopAtFirst)
+            {
+                for (uint32 i = first; i < first + count; ++i)
+                {
+                    bool hit = intersectCallback(r, objects[i], maxDist, stopAtFirst);
+                    if (stopAtFirst && hit)
+                        return true;
+                }
+                return false;
+            }
+            RayCallback& intersectCallback;
+            const VMAP::MappedArray<uint32>& objects;
+        };
+
         struct buildData
         {
             uint32 *indices;
@@ -23,6 +23,8 @@
 #include <string>
 #include <Platform/Define.h>
 #include <G3D/Table.h>
+#include <G3D/Vector3.h>
+#include <vector>
 
 //===========================================================
 
@@ -63,6 +65,11 @@ namespace VMAP
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
             virtual bool isInLineOfSight2(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            test line of sight between many targets and one position (x,y,z), with map tree found only once
+            rays are cast from the targets, pResults[i] is true when pTargets[i] is visible
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float x, float y, float z, const std::vector<G3D::Vector3> &pTargets, std::vector<bool> &pResults) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_MAPPEDFILE_H
+#define HELLGROUND_MAPPEDFILE_H
+
+#include <Platform/Define.h>
+
+#include <vector>
+#include <cstring>
+
+namespace VMAP
+{
+    /**
+    Read only array of plain data, either holding its own copy or pointing into a memory mapped file.
+    Copies of a mapped array point to the same memory, owner of the mapping has to outlive them.
+    */
+    template<class T>
+    class MappedArray
+    {
+        public:
+            MappedArray(): iData(0), iSize(0) {}
+            MappedArray(const MappedArray &other): iData(0), iSize(0) { *this = other; }
+
+            MappedArray& operator=(const MappedArray &other)
+            {
+                if (this == &other)
+                    return *this;
+                iStorage = other.iStorage;
+                iSize = other.iSize;
+                iData = other.isMapped() ? other.iData : (iStorage.empty() ? 0 : &iStorage[0]);
+                return *this;
+            }
+
+            //! takes over content of passed vector, which gets swapped with old storage
+            void assign(std::vector<T> &values)
+            {
+                iStorage.swap(values);
+                iSize = iStorage.size();
+                iData = iStorage.empty() ? 0 : &iStorage[0];
+            }
+
+            void mapTo(const T *data, uint32 size)
+            {
+                std::vector<T>().swap(iStorage);
+                iData = data;
+                iSize = size;
+            }
+
+            void clear() { mapTo(0, 0); }
+
+            const T& operator[](uint32 index) const { return iData[index]; }
+            const T* data() const { return iData; }
+            uint32 size() const { return iSize; }
+            bool empty() const { return iSize == 0; }
+            bool isMapped() const { return iData && iStorage.empty(); }
+
+        private:
+            std::vector<T> iStorage;
+            const T *iData;
+            uint32 iSize;
+    };
+
+    /**
+    Reads vmap file content from memory. When the memory is a mapping of the file, 4 byte aligned
+    arrays are used in place, otherwise (and for files written without alignment) they are copied.
+    */
+    class ChunkReader
+    {
+        public:
+            ChunkReader(const char *data, uint32 size, bool mapped): iData(data), iSize(size), iPos(0), iMapped(mapped) {}
+
+            bool read(void *dest, uint32 size)
+            {
+                if (size > iSize - iPos)
+                    return false;
+                memcpy(dest, iData + iPos, size);
+                iPos += size;
+                return true;
+            }
+
+            bool readChunk(const char *compare, uint32 len)
+            {
+                if (len > iSize - iPos || memcmp(iData + iPos, compare, len) != 0)
+                    return false;
+                iPos += len;
+                return true;
+            }
+
+            bool skip(uint32 size)
+            {
+                if (size > iSize - iPos)
+                    return false;
+                iPos += size;
+                return true;
+            }
+
+            //! aligned files pad variable sized data to 4 bytes
+            bool skipPadding() { return skip((4 - (iPos & 3)) & 3); }
+
+            template<class T>
+            bool readArray(MappedArray<T> &array, uint32 count)
+            {
+                if (count > (iSize - iPos) / sizeof(T))
+                    return false;
+
+                const char *src = iData + iPos;
+                iPos += count * sizeof(T);
+                if (iMapped && !(size_t(src) & 3))
+                {
+                    array.mapTo(reinterpret_cast<const T*>(src), count);
+                    return true;
+                }
+
+                std::vector<T> values(count);
+                if (count)
+                    memcpy(&values[0], src, count * sizeof(T));
+                array.assign(values);
+                return true;
+            }
+
+            bool isMapped() const { return iMapped; }
+
+        private:
+            const char *iData;
+            uint32 iSize;
+            uint32 iPos;
+            bool iMapped;
+    };
+}
+
+#endif // _MAPPEDFILE_H
@@ -28,6 +28,9 @@
 #include <sstream>
 #include <iomanip>
 
+#include <ace/OS_NS_dirent.h>
+#include <ace/OS_NS_stdio.h>
+
 using G3D::Vector3;
 using G3D::AABox;
 using G3D::inf;
@@ -494,4 +497,47 @@ namespace VMAP
         //std::cout << "readRawFile2: '" << pModelFilename << "' tris: " << nElements << " nodes: " << nNodes << std::endl;
         return success;
     }
+
+    bool TileAssembler::convertModelsForMapping(const std::string& pDirName)
+    {
+        ACE_DIR* dirp = ACE_OS::opendir(pDirName.c_str());
+        if (!dirp)
+        {
+            printf("Could not open directory %s\n", pDirName.c_str());
+            return false;
+        }
+
+        uint32 converted = 0, failed = 0;
+        ACE_DIRENT* dp;
+        while ((dp = ACE_OS::readdir(dirp)) != NULL)
+        {
+            int l = strlen(dp->d_name);
+            if (l < 5 || memcmp(&dp->d_name[l - 4], ".vmo", 4))
+                continue;
+
+            std::string fileName = pDirName + "/" + dp->d_name;
+            std::string tmpName = fileName + ".tmp";
+
+            // written next to the original and renamed, so running server never sees half written file
+            bool result;
+            {
+                WorldModel model;
+                result = model.readFile(fileName) && model.writeFile(tmpName, true);
+            }
+
+            if (result && ACE_OS::rename(tmpName.c_str(), fileName.c_str()) == 0)
+                ++converted;
+            else
+            {
+                printf("Could not convert %s\n", fileName.c_str());
+                remove(tmpName.c_str());
+                ++failed;
+            }
+        }
+
+        ACE_OS::closedir(dirp);
+
+        printf("Converted %u model files for memory mapping, %u failed\n", converted, failed);
+        return failed == 0;
+    }
 }
@@ -84,6 +84,9 @@ namespace VMAP
             void setModelNameFilterMethod(bool (*pFilterMethod)(char *pName)) { iFilterMethod = pFilterMethod; }
             std::string getDirEntryNameFromModName(unsigned int pMapId, const std::string& pModPosName);
             unsigned int getUniqueNameId(const std::string pName);
+
+            //! rewrites .vmo files of the directory in aligned format, which WorldModel can use in place when mapped
+            static bool convertModelsForMapping(const std::string& pDirName);
     };
 
 }                                                           // VMAP
@@ -26,6 +26,7 @@
 namespace VMAP
 {
     const char VMAP_MAGIC[] = "VMAP_3.0";                   // used in final vmap files
+    const char VMAP_ALIGNED_MAGIC[] = "VMAP_3.A";           // model files converted for memory mapping
     const char RAW_VMAP_MAGIC[] = "VMAP003";                // used in extracted vmap files with raw data
 
     // defined in TileAssembler.cpp currently...
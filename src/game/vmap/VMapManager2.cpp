@@ -187,6 +187,30 @@ namespace VMAP
         return result;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, float x, float y, float z, const std::vector<G3D::Vector3> &pTargets, std::vector<bool> &pResults)
+    {
+        pResults.assign(pTargets.size(), true);
+
+        if (isClusterComputingEnabled())
+        {
+            for (uint32 i = 0; i < pTargets.size(); ++i)
+                pResults[i] = sLoSProxy.isInLineOfSight(pMapId, pTargets[i].x, pTargets[i].y, pTargets[i].z, x, y, z);
+            return;
+        }
+
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        Vector3 pos = convertPositionToInternalRep(x, y, z);
+        for (uint32 i = 0; i < pTargets.size(); ++i)
+        {
+            Vector3 target = convertPositionToInternalRep(pTargets[i].x, pTargets[i].y, pTargets[i].z);
+            if (target != pos)
+                pResults[i] = instanceTree->second->isInLineOfSight(target, pos);
+        }
+    }
+
     //=========================================================
     /**
     get the hit position and return true if we hit something
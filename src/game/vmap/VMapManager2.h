@@ -92,6 +92,7 @@ namespace VMAP
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) ;
             bool isInLineOfSight2(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2);
+            void isInLineOfSight(unsigned int pMapId, float x, float y, float z, const std::vector<G3D::Vector3> &pTargets, std::vector<bool> &pResults);
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -22,6 +22,12 @@
 #include "VMapDefinitions.h"
 #include "MapTree.h"
 
+#include <ace/Mem_Map.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -33,7 +39,7 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    bool IntersectTriangle(const MeshTriangle &tri, const Vector3 *points, const G3D::Ray &ray, float &distance)
     {
         static const float EPS = 1e-5f;
 
@@ -86,7 +92,7 @@ namespace VMAP
     class TriBoundFunc
     {
         public:
-            TriBoundFunc(std::vector<Vector3> &vert): vertices(vert.begin()) {}
+            TriBoundFunc(const std::vector<Vector3> &vert): vertices(vert.empty() ? 0 : &vert[0]) {}
             void operator()(const MeshTriangle &tri, G3D::AABox &out) const
             {
                 G3D::Vector3 lo = vertices[tri.idx0];
@@ -98,9 +104,20 @@ namespace VMAP
                 out = G3D::AABox(lo, hi);
             }
         protected:
-            const std::vector<Vector3>::const_iterator vertices;
+            const Vector3 *vertices;
     };
 
+    //! aligned files keep every array 4 byte aligned, so it can be used in place when mapped
+    static bool writePadding(FILE *wf)
+    {
+        static const char padding[4] = { 0, 0, 0, 0 };
+        long pos = ftell(wf);
+        if (pos < 0)
+            return false;
+        uint32 size = (4 - (pos & 3)) & 3;
+        return fwrite(padding, 1, size, wf) == size;
+    }
+
     // ===================== WmoLiquid ==================================
 
     WmoLiquid::WmoLiquid(uint32 width, uint32 height, const Vector3 &corner, uint32 type):
@@ -219,22 +236,28 @@ namespace VMAP
         return result;
     }
 
-    bool WmoLiquid::readFromFile(FILE *rf, WmoLiquid *&out)
+    bool WmoLiquid::readFromFile(ChunkReader &reader, WmoLiquid *&out)
     {
         bool result = true;
         WmoLiquid *liquid = new WmoLiquid();
-        if (result && fread(&liquid->iTilesX, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&liquid->iTilesY, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&liquid->iCorner, sizeof(Vector3), 1, rf) != 1) result = false;
-        if (result && fread(&liquid->iType, sizeof(uint32), 1, rf) != 1) result = false;
-        uint32 size = (liquid->iTilesX + 1)*(liquid->iTilesY + 1);
-        liquid->iHeight = new float[size];
-        if (result && fread(liquid->iHeight, sizeof(float), size, rf) != size) result = false;
-        size = liquid->iTilesX * liquid->iTilesY;
-        liquid->iFlags = new uint8[size];
-        if (result && fread(liquid->iFlags, sizeof(uint8), size, rf) != size) result = false;
+        if (result && !reader.read(&liquid->iTilesX, sizeof(uint32))) result = false;
+        if (result && !reader.read(&liquid->iTilesY, sizeof(uint32))) result = false;
+        if (result && !reader.read(&liquid->iCorner, sizeof(Vector3))) result = false;
+        if (result && !reader.read(&liquid->iType, sizeof(uint32))) result = false;
+        if (result)
+        {
+            uint32 size = (liquid->iTilesX + 1)*(liquid->iTilesY + 1);
+            liquid->iHeight = new float[size];
+            if (!reader.read(liquid->iHeight, sizeof(float) * size)) result = false;
+            size = liquid->iTilesX * liquid->iTilesY;
+            liquid->iFlags = new uint8[size];
+            if (result && !reader.read(liquid->iFlags, sizeof(uint8) * size)) result = false;
+        }
         if (!result)
+        {
             delete liquid;
+            liquid = 0;
+        }
         out = liquid;
         return result;
     }
@@ -243,7 +266,8 @@ namespace VMAP
 
     GroupModel::GroupModel(const GroupModel &other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(0)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree),
+        triangleBlocks(other.triangleBlocks), triangleStride(other.triangleStride), iLiquid(0)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -251,13 +275,42 @@ namespace VMAP
 
     void GroupModel::setMeshData(std::vector<Vector3> &vert, std::vector<MeshTriangle> &tri)
     {
-        vertices.swap(vert);
-        triangles.swap(tri);
-        TriBoundFunc bFunc(vertices);
-        meshTree.build(triangles, bFunc);
+        TriBoundFunc bFunc(vert);
+        meshTree.build(tri, bFunc);
+        vertices.assign(vert);
+        triangles.assign(tri);
+        buildTriangleBlocks();
+    }
+
+    bool GroupModel::simdIntersection = true;
+
+    void GroupModel::buildTriangleBlocks()
+    {
+        triangleBlocks.clear();
+        triangleStride = 0;
+#ifdef __SSE2__
+        uint32 count = meshTree.primCount();
+        if (!count || count != triangles.size())
+            return;
+
+        // every leaf can be loaded 4 triangles at a time, padding has zero edges and never hits
+        triangleStride = (count + 6) & ~3;
+        std::vector<float> blocks(9 * triangleStride, 0.0f);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const MeshTriangle &tri = triangles[meshTree.primIndex(i)];
+            const Vector3 e1 = vertices[tri.idx1] - vertices[tri.idx0];
+            const Vector3 e2 = vertices[tri.idx2] - vertices[tri.idx0];
+            const Vector3 row[3] = { vertices[tri.idx0], e1, e2 };
+            for (uint32 r = 0; r < 3; ++r)
+                for (uint32 c = 0; c < 3; ++c)
+                    blocks[(r * 3 + c) * triangleStride + i] = row[r][c];
+        }
+        triangleBlocks.assign(blocks);
+#endif
     }
 
-    bool GroupModel::writeToFile(FILE *wf)
+    bool GroupModel::writeToFile(FILE *wf, bool aligned)
     {
         bool result = true;
         uint32 chunkSize, count;
@@ -274,7 +327,7 @@ namespace VMAP
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result && fwrite(&vertices[0], sizeof(Vector3), count, wf) != count) result = false;
+        if (result && fwrite(vertices.data(), sizeof(Vector3), count, wf) != count) result = false;
 
         // write triangle mesh
         if (result && fwrite("TRIM", 1, 4, wf) != 4) result = false;
@@ -282,12 +335,21 @@ namespace VMAP
         chunkSize = sizeof(uint32)+ sizeof(MeshTriangle)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
-        if (result && fwrite(&triangles[0], sizeof(MeshTriangle), count, wf) != count) result = false;
+        if (result && fwrite(triangles.data(), sizeof(MeshTriangle), count, wf) != count) result = false;
 
         // write mesh BIH
         if (result && fwrite("MBIH", 1, 4, wf) != 4) result = false;
         if (result) result = meshTree.writeToFile(wf);
 
+        // write triangle blocks, stride 0 when built without SSE2
+        if (aligned)
+        {
+            if (result && fwrite("TBLK", 1, 4, wf) != 4) result = false;
+            if (result && fwrite(&triangleStride, sizeof(uint32), 1, wf) != 1) result = false;
+            count = triangleBlocks.size();
+            if (result && count && fwrite(triangleBlocks.data(), sizeof(float), count, wf) != count) result = false;
+        }
+
         // write liquid data
         if (result && fwrite("LIQU", 1, 4, wf) != 4) result = false;
         if (!iLiquid)
@@ -299,71 +361,206 @@ namespace VMAP
         chunkSize = iLiquid->GetFileSize();
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result) result = iLiquid->writeToFile(wf);
+        if (result && aligned) result = writePadding(wf);
 
         return result;
     }
 
-    bool GroupModel::readFromFile(FILE *rf)
+    bool GroupModel::readFromFile(ChunkReader &reader, bool aligned)
     {
-        char chunk[8];
         bool result = true;
-        uint32 chunkSize, count;
+        uint32 chunkSize, count = 0;
         triangles.clear();
         vertices.clear();
+        triangleBlocks.clear();
+        triangleStride = 0;
         delete iLiquid;
         iLiquid = 0;
 
-        if (result && fread(&iBound, sizeof(G3D::AABox), 1, rf) != 1) result = false;
-        if (result && fread(&iMogpFlags, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&iGroupWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.read(&iBound, sizeof(G3D::AABox))) result = false;
+        if (result && !reader.read(&iMogpFlags, sizeof(uint32))) result = false;
+        if (result && !reader.read(&iGroupWMOID, sizeof(uint32))) result = false;
 
         // read vertices
-        if (result && !readChunk(rf, chunk, "VERT", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.readChunk("VERT", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && !reader.read(&count, sizeof(uint32))) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result) vertices.resize(count);
-        if (result && fread(&vertices[0], sizeof(Vector3), count, rf) != count) result = false;
+        if (result && !reader.readArray(vertices, count)) result = false;
 
         // read triangle mesh
-        if (result && !readChunk(rf, chunk, "TRIM", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result) triangles.resize(count);
-        if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+        if (result && !reader.readChunk("TRIM", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && !reader.read(&count, sizeof(uint32))) result = false;
+        if (result && !reader.readArray(triangles, count)) result = false;
 
         // read mesh BIH
-        if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
-        if (result) result = meshTree.readFromFile(rf);
+        if (result && !reader.readChunk("MBIH", 4)) result = false;
+        if (result) result = meshTree.readFromFile(reader);
 
-        // write liquid data
-        if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
+        // read triangle blocks, build them when missing or made for other BIH
+        if (result && aligned)
+        {
+            uint32 stride = 0;
+            if (result && !reader.readChunk("TBLK", 4)) result = false;
+            if (result && !reader.read(&stride, sizeof(uint32))) result = false;
+#ifdef __SSE2__
+            if (result && stride && stride == ((meshTree.primCount() + 6) & ~3) && meshTree.primCount() == triangles.size())
+            {
+                triangleStride = stride;
+                result = reader.readArray(triangleBlocks, 9 * stride);
+            }
+            else
+#endif
+            if (result && !reader.skip(9 * stride * sizeof(float))) result = false;
+        }
+        if (result && triangleBlocks.empty()) buildTriangleBlocks();
+
+        // read liquid data
+        if (result && !reader.readChunk("LIQU", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
         if (result && chunkSize > 0)
-            result = WmoLiquid::readFromFile(rf, iLiquid);
+        {
+            result = WmoLiquid::readFromFile(reader, iLiquid);
+            if (result && aligned) result = reader.skipPadding();
+        }
         return result;
     }
 
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) {}
+        GModelRayCallback(const MappedArray<MeshTriangle> &tris, const MappedArray<Vector3> &vert):
+            vertices(vert.data()), triangles(tris.data()), hit(false) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit)
         {
             bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
             if (result)  hit=true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        const Vector3 *vertices;
+        const MeshTriangle *triangles;
         bool hit;
     };
 
+#ifdef __SSE2__
+    /**
+    Tests whole BIH leaf against the ray, 4 triangles at a time.
+    Same steps and operation order as IntersectTriangle, so hits and distances match the scalar test;
+    of several hits in one block the closest is taken.
+    */
+    struct GModelBlockRayCallback
+    {
+        GModelBlockRayCallback(const G3D::Ray &ray, const MappedArray<float> &blocks, uint32 stride):
+            triangleBlocks(blocks.data()), triangleStride(stride), hit(false)
+        {
+            ox = _mm_set1_ps(ray.origin().x);
+            oy = _mm_set1_ps(ray.origin().y);
+            oz = _mm_set1_ps(ray.origin().z);
+            dx = _mm_set1_ps(ray.direction().x);
+            dy = _mm_set1_ps(ray.direction().y);
+            dz = _mm_set1_ps(ray.direction().z);
+        }
+
+        bool operator()(const G3D::Ray& /*ray*/, uint32 first, uint32 count, float& distance, bool pStopAtFirstHit)
+        {
+            for (uint32 i = 0; i < count; i += 4)
+            {
+                if (IntersectBlock(first + i, std::min(count - i, uint32(4)), distance))
+                    hit = true;
+                if (hit && pStopAtFirstHit)
+                    return true;
+            }
+            return false;
+        }
+
+        bool IntersectBlock(uint32 first, uint32 lanes, float &distance) const
+        {
+            const float *b = triangleBlocks + first;
+            const __m128 v0x = _mm_loadu_ps(b);
+            const __m128 v0y = _mm_loadu_ps(b + triangleStride);
+            const __m128 v0z = _mm_loadu_ps(b + 2 * triangleStride);
+            const __m128 e1x = _mm_loadu_ps(b + 3 * triangleStride);
+            const __m128 e1y = _mm_loadu_ps(b + 4 * triangleStride);
+            const __m128 e1z = _mm_loadu_ps(b + 5 * triangleStride);
+            const __m128 e2x = _mm_loadu_ps(b + 6 * triangleStride);
+            const __m128 e2y = _mm_loadu_ps(b + 7 * triangleStride);
+            const __m128 e2z = _mm_loadu_ps(b + 8 * triangleStride);
+
+            // lanes past the leaf belong to other leaves
+            __m128 mask = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(lanes), _mm_set_epi32(3, 2, 1, 0)));
+
+            // p = dir x e2, a = e1 . p
+            const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            const __m128 a = Dot(e1x, e1y, e1z, px, py, pz);
+
+            const __m128 absA = _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(absA, _mm_set1_ps(1e-5f)));
+            if (!_mm_movemask_ps(mask))
+                return false;
+
+            const __m128 f = _mm_div_ps(_mm_set1_ps(1.0f), a);
+            const __m128 sx = _mm_sub_ps(ox, v0x);
+            const __m128 sy = _mm_sub_ps(oy, v0y);
+            const __m128 sz = _mm_sub_ps(oz, v0z);
+            const __m128 u = _mm_mul_ps(f, Dot(sx, sy, sz, px, py, pz));
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+            if (!_mm_movemask_ps(mask))
+                return false;
+
+            // q = s x e1
+            const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            const __m128 v = _mm_mul_ps(f, Dot(dx, dy, dz, qx, qy, qz));
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+            const __m128 t = _mm_mul_ps(f, Dot(e2x, e2y, e2z, qx, qy, qz));
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+
+            int hits = _mm_movemask_ps(mask);
+            if (!hits)
+                return false;
+
+            float tValues[4];
+            _mm_storeu_ps(tValues, t);
+            for (uint32 i = 0; i < 4; ++i)
+                if ((hits & (1 << i)) && tValues[i] < distance)
+                    distance = tValues[i];
+
+            return true;
+        }
+
+        static __m128 Dot(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        }
+
+        const float *triangleBlocks;
+        uint32 triangleStride;
+        __m128 ox, oy, oz;
+        __m128 dx, dy, dz;
+        bool hit;
+    };
+#endif
+
     bool GroupModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const
     {
         if (!triangles.size())
             return false;
+#ifdef __SSE2__
+        if (simdIntersection && !triangleBlocks.empty())
+        {
+            GModelBlockRayCallback blockCallback(ray, triangleBlocks, triangleStride);
+            meshTree.intersectRayLeaves(ray, blockCallback, distance, stopAtFirstHit);
+            return blockCallback.hit;
+        }
+#endif
         GModelRayCallback callback(triangles, vertices);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
@@ -400,6 +597,15 @@ namespace VMAP
 
     // ===================== WorldModel ==================================
 
+    bool WorldModel::memoryMapping = false;
+
+    WorldModel::~WorldModel()
+    {
+        // drop views into the mapping before unmapping it
+        groupModels.clear();
+        delete iMappedFile;
+    }
+
     void WorldModel::setGroupModels(std::vector<GroupModel> &models)
     {
         groupModels.swap(models);
@@ -501,7 +707,7 @@ namespace VMAP
         return false;
     }
 
-    bool WorldModel::writeFile(const std::string &filename)
+    bool WorldModel::writeFile(const std::string &filename, bool aligned)
     {
         FILE *wf = fopen(filename.c_str(), "wb");
         if (!wf)
@@ -509,7 +715,7 @@ namespace VMAP
 
         bool result = true;
         uint32 chunkSize, count;
-        result = fwrite(VMAP_MAGIC,1,8,wf) == 8;
+        result = fwrite(aligned ? VMAP_ALIGNED_MAGIC : VMAP_MAGIC,1,8,wf) == 8;
         if (result && fwrite("WMOD", 1, 4, wf) != 4) result = false;
         chunkSize = sizeof(uint32) + sizeof(uint32);
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
@@ -524,7 +730,7 @@ namespace VMAP
             //if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
             if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
             for (uint32 i=0; i<groupModels.size() && result; ++i)
-                result = groupModels[i].writeToFile(wf);
+                result = groupModels[i].writeToFile(wf, aligned);
 
             // write group BIH
             if (result && fwrite("GBIH", 1, 4, wf) != 4) result = false;
@@ -537,36 +743,67 @@ namespace VMAP
 
     bool WorldModel::readFile(const std::string &filename)
     {
+        if (memoryMapping)
+        {
+            // pages are loaded on first touch and shared by all processes mapping the file
+            ACE_Mem_Map *mappedFile = new ACE_Mem_Map();
+            if (mappedFile->map(filename.c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == 0)
+            {
+                mappedFile->close_handle();
+                iMappedFile = mappedFile;
+                ChunkReader reader((const char*)mappedFile->addr(), mappedFile->size(), true);
+                return readFromReader(reader);
+            }
+            delete mappedFile;
+        }
+
         FILE *rf = fopen(filename.c_str(), "rb");
         if (!rf)
             return false;
 
+        std::vector<char> buffer;
+        bool result = fseek(rf, 0, SEEK_END) == 0;
+        long size = result ? ftell(rf) : -1;
+        if (size <= 0 || fseek(rf, 0, SEEK_SET) != 0)
+            result = false;
+        if (result)
+        {
+            buffer.resize(size);
+            result = fread(&buffer[0], 1, size, rf) == size_t(size);
+        }
+        fclose(rf);
+
+        if (!result)
+            return false;
+
+        ChunkReader reader(&buffer[0], buffer.size(), false);
+        return readFromReader(reader);
+    }
+
+    bool WorldModel::readFromReader(ChunkReader &reader)
+    {
         bool result = true;
         uint32 chunkSize, count;
-        char chunk[8];                          // Ignore the added magic header
-        if (!readChunk(rf, chunk, VMAP_MAGIC, 8)) result = false;
+        bool aligned = reader.readChunk(VMAP_ALIGNED_MAGIC, 8);
+        if (!aligned && !reader.readChunk(VMAP_MAGIC, 8)) result = false;
 
-        if (result && !readChunk(rf, chunk, "WMOD", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&RootWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && !reader.readChunk("WMOD", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && !reader.read(&RootWMOID, sizeof(uint32))) result = false;
 
         // read group models
-        if (result && readChunk(rf, chunk, "GMOD", 4))
+        if (result && reader.readChunk("GMOD", 4))
         {
-            //if (fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-
-            if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
+            if (result && !reader.read(&count, sizeof(uint32))) result = false;
             if (result) groupModels.resize(count);
-            //if (result && fread(&groupModels[0], sizeof(GroupModel), count, rf) != count) result = false;
             for (uint32 i=0; i<count && result; ++i)
-                result = groupModels[i].readFromFile(rf);
+                result = groupModels[i].readFromFile(reader, aligned);
 
             // read group BIH
-            if (result && !readChunk(rf, chunk, "GBIH", 4)) result = false;
-            if (result) result = groupTree.readFromFile(rf);
+            if (result && !reader.readChunk("GBIH", 4)) result = false;
+            if (result) result = groupTree.readFromFile(reader);
         }
 
-        fclose(rf);
         return result;
     }
 }
@@ -25,9 +25,12 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include "BIH.h"
+#include "MappedFile.h"
 
 #include "Platform/Define.h"
 
+class ACE_Mem_Map;
+
 namespace VMAP
 {
     class TreeNode;
@@ -58,7 +61,7 @@ namespace VMAP
             uint8 *GetFlagsStorage() { return iFlags; }
             uint32 GetFileSize();
             bool writeToFile(FILE *wf);
-            static bool readFromFile(FILE *rf, WmoLiquid *&liquid);
+            static bool readFromFile(ChunkReader &reader, WmoLiquid *&liquid);
         private:
             WmoLiquid(): iHeight(0), iFlags(0) {};
             uint32 iTilesX;  //!< number of tiles in x direction, each
@@ -77,10 +80,10 @@ namespace VMAP
     class GroupModel
     {
         public:
-            GroupModel(): iLiquid(0) {}
+            GroupModel(): triangleStride(0), iLiquid(0) {}
             GroupModel(const GroupModel &other);
             GroupModel(uint32 mogpFlags, uint32 groupWMOID, const AABox &bound):
-                        iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iLiquid(0) {}
+                        iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), triangleStride(0), iLiquid(0) {}
             ~GroupModel() { delete iLiquid; }
 
             //! pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry!
@@ -90,20 +93,32 @@ namespace VMAP
             bool IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const;
             bool GetLiquidLevel(const Vector3 &pos, float &liqHeight) const;
             uint32 GetLiquidType() const;
-            bool writeToFile(FILE *wf);
-            bool readFromFile(FILE *rf);
+            //! aligned files can be used in place when memory mapped and carry prebuilt triangle blocks
+            bool writeToFile(FILE *wf, bool aligned);
+            bool readFromFile(ChunkReader &reader, bool aligned);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
+
+            //! switch between 4-wide and scalar triangle tests, both give the same hits
+            static void setSimdIntersection(bool enable) { simdIntersection = enable; }
+            static bool isSimdIntersectionEnabled() { return simdIntersection; }
         protected:
+            void buildTriangleBlocks();
+
             G3D::AABox iBound;
             uint32 iMogpFlags;// 0x8 outdor; 0x2000 indoor
             uint32 iGroupWMOID;
-            std::vector<Vector3> vertices;
-            std::vector<MeshTriangle> triangles;
+            MappedArray<Vector3> vertices;
+            MappedArray<MeshTriangle> triangles;
             BIH meshTree;
+            //! triangles in meshTree leaf order as rows of v0.xyz, e1.xyz, e2.xyz, each triangleStride long (SSE2 builds only)
+            MappedArray<float> triangleBlocks;
+            uint32 triangleStride;
             WmoLiquid *iLiquid;
 
+            static bool simdIntersection;
+
 #ifdef MMAP_GENERATOR
         public:
             void getMeshData(std::vector<Vector3> &vertices, std::vector<MeshTriangle> &triangles, WmoLiquid* &liquid);
@@ -113,7 +128,8 @@ namespace VMAP
     class WorldModel
     {
         public:
-            WorldModel(): RootWMOID(0) {}
+            WorldModel(): RootWMOID(0), iMappedFile(0) {}
+            ~WorldModel();
 
             //! pass group models to WorldModel and create BIH. Passed vector is swapped with old geometry!
             void setGroupModels(std::vector<GroupModel> &models);
@@ -121,12 +137,25 @@ namespace VMAP
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
             bool IntersectPoint(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, LocationInfo &info) const;
-            bool writeFile(const std::string &filename);
+            bool writeFile(const std::string &filename, bool aligned = false);
             bool readFile(const std::string &filename);
+
+            //! map model files instead of reading them, geometry is then shared with other processes using the same file
+            static void setMemoryMapping(bool enable) { memoryMapping = enable; }
+            static bool isMemoryMappingEnabled() { return memoryMapping; }
         protected:
+            bool readFromReader(ChunkReader &reader);
+
             uint32 RootWMOID;
             std::vector<GroupModel> groupModels;
             BIH groupTree;
+            ACE_Mem_Map *iMappedFile;
+
+            static bool memoryMapping;
+        private:
+            // group models may point into iMappedFile
+            WorldModel(const WorldModel &);
+            WorldModel& operator=(const WorldModel &);
 
 #ifdef MMAP_GENERATOR
         public:
@@ -32,6 +32,8 @@
 #include "Log.h"
 #include "Master.h"
 #include "vmap/VMapCluster.h"
+#include "vmap/WorldModel.h"
+#include "vmap/TileAssembler.h"
 
 #include <ace/Get_Opt.h>
 
@@ -66,6 +68,7 @@ void usage(const char *prog)
     sLog.outString("Usage: \n %s [<options>]\n"
         "    -v, --version            print version and exit\n\r"
         "    -c config_file           use config_file as configuration file\n\r"
+        "    -m vmaps_dir             convert vmap model files for memory mapping and exit\n\r"
         #ifdef WIN32
         "    Running as service functions:\n\r"
         "    -s run                run as service\n\r"
@@ -81,7 +84,7 @@ extern int main(int argc, char **argv)
     ///- Command line parsing
     char const* cfg_file = _HELLGROUND_CORE_CONFIG;
 
-    char const *options = ":a:c:s:p:i:";
+    char const *options = ":a:c:s:p:i:m:";
 
     char const *process = 0;
     int process_id = 0;
@@ -135,6 +138,8 @@ extern int main(int argc, char **argv)
                 process_id = atoi(cmd_opts.opt_arg());
                 break;
             }
+            case 'm':
+                return VMAP::TileAssembler::convertModelsForMapping(cmd_opts.opt_arg()) ? 0 : 1;
             case ':':
                 printf("Runtime-Error: -%c option requires an input argument\n", cmd_opts.opt_opt());
                 usage(argv[0]);
@@ -172,6 +177,9 @@ extern int main(int argc, char **argv)
     int vmapProcesses = sConfig.GetIntDefault("vmap.clusterProcesses", 1);
     bool vmapCluster = sConfig.GetBoolDefault("vmap.enableCluster", false);
 
+    // set before cluster processes start, so they share model geometry with world process
+    VMAP::WorldModel::setMemoryMapping(sConfig.GetBoolDefault("vmap.mapModelFiles", true));
+
     if(process)
     {
         if(strcmp(process, VMAP_CLUSTER_MANAGER_PROCESS) == 0)
@@ -55,7 +55,12 @@ void WorldRunnable::run()
 
         uint32 diff = WorldTimer::tick();
 
-        sWorld.Update(diff);
+        {
+            TraceZone traceTick("World::Update", World::m_worldLoopCounter);
+            sWorld.Update(diff);
+        }
+
+        sTickTracer.EndTick(WorldTimer::getMSTimeDiffToNow(realCurrTime));
         realPrevTime = realCurrTime;
 
         // diff (D0) include time of previous sleep (d0) + tick time (t0)
@@ -0,0 +1,1036 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "BotClient.h"
+#include "BotOpcodes.h"
+#include "SharedDefines.h"
+#include "WorldPacket.h"
+#include "Auth/Sha1.h"
+#include "Util.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <ace/Reactor.h>
+#include <ace/SOCK_Connector.h>
+#include <ace/INET_Addr.h>
+
+#define BOT_CLIENT_BUILD        8606
+#define BOT_RUN_SPEED           7.0f
+#define BOT_HEARTBEAT_INTERVAL  500
+#define BOT_MOVEFLAG_FORWARD    0x00000001
+#define BOT_TARGET_FLAG_UNIT    0x00000002
+#define BOT_SRP_SECURITY_NONE   0x00
+#define BOT_RACEMASK_ALLIANCE   0x44D                       // human, dwarf, night elf, gnome, draenei
+#define BOT_WHO_MAX_LEVEL       100
+
+static uint32 const BotSrpMultiplier = 3;
+
+BotClient::BotClient(BotConfig const& config, ACE_Reactor* reactor, uint32 index) : ACE_Event_Handler(reactor),
+    m_config(config), m_index(index), m_state(BOT_STATE_IDLE), m_stateTime(0), m_startTime(0), m_loginStart(0),
+    m_connecting(false), m_outScheduled(false), m_headerRead(false), m_packetSize(0), m_packetOpcode(0),
+    m_guid(0), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_o(0.0f), m_walking(false), m_onTaxi(false), m_walkEnd(0), m_lastMove(0),
+    m_nextAction(0), m_nextPing(0), m_pingSeq(0), m_lastLatency(0), m_chatSeq(0)
+{
+    std::ostringstream account;
+    account << config.accountPrefix << (config.firstAccount + index);
+    m_account = account.str();
+    m_password = config.password;
+
+    // realm and world use upper case names in SRP6 and session hashes
+    std::transform(m_account.begin(), m_account.end(), m_account.begin(), ::toupper);
+    std::transform(m_password.begin(), m_password.end(), m_password.begin(), ::toupper);
+
+    memset(m_M2, 0, sizeof(m_M2));
+    memset(m_pending, 0, sizeof(m_pending));
+
+    sLoadStats.AddBot();
+}
+
+BotClient::~BotClient()
+{
+    Disconnect();
+}
+
+void BotClient::SetState(BotState state, uint32 now)
+{
+    if (m_state == state)
+        return;
+
+    sLoadStats.ChangeState(m_state, state);
+    m_state = state;
+    m_stateTime = now;
+}
+
+void BotClient::Start(uint32 now)
+{
+    m_loginStart = now;
+    m_in.clear();
+    m_out.clear();
+
+    SetState(BOT_STATE_REALM, now);
+
+    if (!Connect(m_config.realmAddress))
+    {
+        Fail("can't connect to realm");
+        return;
+    }
+
+    SendLogonChallenge();
+}
+
+void BotClient::Stop()
+{
+    Disconnect();
+}
+
+void BotClient::Fail(char const* reason)
+{
+    sLoadStats.RecordFailure(reason);
+    Disconnect();
+
+    uint32 now = WorldTimer::getMSTime();
+    m_walking = false;
+    memset(m_pending, 0, sizeof(m_pending));
+
+    if (m_config.reconnectDelay)
+    {
+        m_startTime = now + m_config.reconnectDelay;
+        SetState(BOT_STATE_IDLE, now);
+    }
+    else
+        SetState(BOT_STATE_FAILED, now);
+}
+
+bool BotClient::Connect(std::string const& address)
+{
+    Disconnect();
+
+    ACE_INET_Addr addr;
+    if (addr.set(address.c_str()) == -1)
+        return false;
+
+    // zero timeout makes connector return at once with connect in progress
+    ACE_SOCK_Connector connector;
+    if (connector.connect(m_peer, addr, &ACE_Time_Value::zero) == -1 && errno != EWOULDBLOCK && errno != EINPROGRESS)
+        return false;
+
+    m_connecting = true;
+    m_outScheduled = true;
+    m_headerRead = false;
+    m_in.clear();
+    m_out.clear();
+
+    if (reactor()->register_handler(this, ACE_Event_Handler::READ_MASK | ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        m_peer.close();
+        return false;
+    }
+
+    return true;
+}
+
+bool BotClient::CompleteConnect()
+{
+    ACE_SOCK_Connector connector;
+    if (connector.complete(m_peer, NULL, &ACE_Time_Value::zero) == -1)
+        return false;
+
+    m_connecting = false;
+    m_peer.enable(ACE_NONBLOCK);
+    return true;
+}
+
+void BotClient::Disconnect()
+{
+    if (m_peer.get_handle() == ACE_INVALID_HANDLE)
+        return;
+
+    reactor()->remove_handler(this, ACE_Event_Handler::ALL_EVENTS_MASK | ACE_Event_Handler::DONT_CALL);
+    m_peer.close();
+
+    m_connecting = false;
+    m_outScheduled = false;
+    m_crypt = AuthCrypt();
+}
+
+int BotClient::handle_input(ACE_HANDLE)
+{
+    if (m_connecting && !CompleteConnect())
+    {
+        Fail("connect failed");
+        return 0;
+    }
+
+    uint8 buf[4096];
+    for (;;)
+    {
+        ssize_t n = m_peer.recv(buf, sizeof(buf));
+        if (n > 0)
+        {
+            m_in.insert(m_in.end(), buf, buf + n);
+            continue;
+        }
+
+        if (n == 0 || (errno != EWOULDBLOCK && errno != EAGAIN))
+        {
+            Fail("connection closed by server");
+            return 0;
+        }
+
+        break;
+    }
+
+    bool ok;
+    try
+    {
+        ok = m_state == BOT_STATE_REALM ? HandleRealmInput() : HandleWorldInput();
+    }
+    catch (ByteBufferException&)
+    {
+        ok = false;
+    }
+
+    if (!ok)
+        Fail("malformed or refused answer");
+
+    return 0;
+}
+
+int BotClient::handle_output(ACE_HANDLE)
+{
+    if (m_connecting && !CompleteConnect())
+    {
+        Fail("connect failed");
+        return 0;
+    }
+
+    if (!Flush())
+        Fail("send failed");
+
+    return 0;
+}
+
+bool BotClient::Flush()
+{
+    if (m_connecting)
+        return true;
+
+    while (!m_out.empty())
+    {
+        ssize_t n = m_peer.send(&m_out[0], m_out.size());
+        if (n < 0)
+        {
+            if (errno != EWOULDBLOCK && errno != EAGAIN)
+                return false;
+
+            break;
+        }
+
+        m_out.erase(m_out.begin(), m_out.begin() + n);
+    }
+
+    bool wanted = !m_out.empty();
+    if (wanted != m_outScheduled)
+    {
+        if (wanted)
+            reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK);
+        else
+            reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK);
+
+        m_outScheduled = wanted;
+    }
+
+    return true;
+}
+
+void BotClient::SendRaw(uint8 const* data, size_t size)
+{
+    m_out.insert(m_out.end(), data, data + size);
+
+    if (!Flush())
+        Fail("send failed");
+}
+
+void BotClient::SendPacket(WorldPacket const& packet)
+{
+    if (m_peer.get_handle() == ACE_INVALID_HANDLE)
+        return;
+
+    // client header: uint16 big endian size including opcode, uint32 opcode
+    uint8 header[AuthCrypt::CRYPTED_RECV_LEN];
+    uint16 size = packet.size() + 4;
+    uint32 opcode = packet.GetOpcode();
+    header[0] = uint8(size >> 8);
+    header[1] = uint8(size);
+    memcpy(&header[2], &opcode, sizeof(opcode));
+    EndianConvert(*((uint32*)&header[2]));
+
+    m_crypt.EncryptClientSend(header, sizeof(header));
+
+    m_out.insert(m_out.end(), header, header + sizeof(header));
+    SendRaw(packet.size() ? packet.contents() : NULL, packet.size());
+}
+
+void BotClient::SendLogonChallenge()
+{
+    ByteBuffer pkt;
+    pkt << uint8(BOT_CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(0);
+    pkt << uint16(30 + m_account.size());                   // rest of packet
+    pkt.append("WoW", 4);
+    pkt << uint8(2) << uint8(4) << uint8(3);
+    pkt << uint16(BOT_CLIENT_BUILD);
+    pkt.append("68x", 4);                                   // four character codes are sent reversed
+    pkt.append("niW", 4);
+    pkt.append("SUne", 4);
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint8(127) << uint8(0) << uint8(0) << uint8(1);  // local ip
+    pkt << uint8(m_account.size());
+    pkt.append(m_account.c_str(), m_account.size());
+
+    SendRaw(pkt.contents(), pkt.size());
+}
+
+bool BotClient::HandleRealmInput()
+{
+    while (!m_in.empty() && m_state == BOT_STATE_REALM)
+    {
+        size_t used = 0;
+        bool ok;
+
+        switch (m_in[0])
+        {
+            case BOT_CMD_AUTH_LOGON_CHALLENGE:  ok = HandleLogonChallenge(used); break;
+            case BOT_CMD_AUTH_LOGON_PROOF:      ok = HandleLogonProof(used);     break;
+            case BOT_CMD_REALM_LIST:            ok = HandleRealmList(used);      break;
+            default:                            ok = false;                      break;
+        }
+
+        if (!ok)
+            return false;
+
+        // wait for the rest
+        if (!used)
+            return true;
+
+        // realm list moves bot to world, its input is gone already
+        if (m_state == BOT_STATE_REALM)
+            m_in.erase(m_in.begin(), m_in.begin() + used);
+    }
+
+    return true;
+}
+
+bool BotClient::HandleLogonChallenge(size_t& used)
+{
+    if (m_in.size() < 3)
+        return true;
+
+    if (m_in[2] != 0)                                       // WOW_SUCCESS
+        return false;
+
+    // B[32], g_len, g, N_len, N, s[32], unk[16], security flags
+    size_t pos = 3 + 32;
+    if (m_in.size() < pos + 1)
+        return true;
+
+    uint8 gLen = m_in[pos];
+    pos += 1 + gLen;
+    if (m_in.size() < pos + 1)
+        return true;
+
+    uint8 nLen = m_in[pos];
+    pos += 1 + nLen;
+    if (m_in.size() < pos + 32 + 16 + 1)
+        return true;
+
+    used = pos + 32 + 16 + 1;
+
+    // pin, matrix and token input need a human
+    if (m_in[pos + 32 + 16] != BOT_SRP_SECURITY_NONE)
+        return false;
+
+    BigNumber B, g, N, s;
+    B.SetBinary(&m_in[3], 32);
+    g.SetBinary(&m_in[3 + 32 + 1], gLen);
+    N.SetBinary(&m_in[3 + 32 + 1 + gLen + 1], nLen);
+    s.SetBinary(&m_in[pos], 32);
+
+    if (B.isZero() || N.isZero())
+        return false;
+
+    BigNumber a;
+    a.SetRand(19 * 8);
+    m_A = g.ModExp(a, N);
+
+    // x = H(s, H(ACCOUNT:PASSWORD))
+    Sha1Hash sha;
+    sha.UpdateData(m_account + ":" + m_password);
+    sha.Finalize();
+    uint8 passHash[SHA_DIGEST_LENGTH];
+    memcpy(passHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(&m_in[pos], 32);
+    sha.UpdateData(passHash, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_A, &B, NULL);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    // S = (B - k * g^x) ^ (a + u * x), kept positive before exponentiation
+    BigNumber kv = g.ModExp(x, N) * BotSrpMultiplier;
+    BigNumber base = ((B + N * BotSrpMultiplier) - kv) % N;
+    BigNumber S = base.ModExp(a + u * x, N);
+
+    // session key interleaves hashes of even and odd bytes of S, as realm does
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+
+    m_K.SetBinary(vK, 40);
+
+    // M1 = H(H(N) xor H(g), H(ACCOUNT), s, A, B, K)
+    uint8 hash[20];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, NULL);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(m_account);
+    sha.Finalize();
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, NULL);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &m_A, &B, &m_K, NULL);
+    sha.Finalize();
+    BigNumber M;
+    M.SetBinary(sha.GetDigest(), 20);
+
+    ByteBuffer pkt;
+    pkt << uint8(BOT_CMD_AUTH_LOGON_PROOF);
+    pkt.append(m_A.AsByteArray(32), 32);
+    pkt.append(sha.GetDigest(), 20);
+    uint8 crcHash[20] = { 0 };                              // not checked
+    pkt.append(crcHash, sizeof(crcHash));
+    pkt << uint8(0);                                        // number of keys
+    pkt << uint8(BOT_SRP_SECURITY_NONE);
+
+    // realm proves it knows the verifier with H(A, M, K)
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_A, &M, &m_K, NULL);
+    sha.Finalize();
+    memcpy(m_M2, sha.GetDigest(), 20);
+
+    SendRaw(pkt.contents(), pkt.size());
+    return true;
+}
+
+bool BotClient::HandleLogonProof(size_t& used)
+{
+    if (m_in.size() < 2)
+        return true;
+
+    // unknown account or wrong password
+    if (m_in[1] != 0)
+        return false;
+
+    // cmd, error, M2[20], account flags, survey id, unk flags
+    if (m_in.size() < 32)
+        return true;
+
+    used = 32;
+
+    if (memcmp(&m_in[2], m_M2, 20))
+        return false;
+
+    ByteBuffer pkt;
+    pkt << uint8(BOT_CMD_REALM_LIST);
+    pkt << uint32(0);
+    SendRaw(pkt.contents(), pkt.size());
+    return true;
+}
+
+bool BotClient::HandleRealmList(size_t& used)
+{
+    if (m_in.size() < 3)
+        return true;
+
+    uint16 size = m_in[1] | (m_in[2] << 8);
+    if (m_in.size() < 3u + size)
+        return true;
+
+    used = 3 + size;
+
+    ByteBuffer list;
+    list.append(&m_in[3], size);
+
+    uint32 unused;
+    uint16 count;
+    list >> unused >> count;
+
+    std::string address;
+    for (uint16 i = 0; i < count; ++i)
+    {
+        uint8 icon, lock, flags, characters, timezone, id;
+        std::string name, realmAddress;
+        float population;
+
+        list >> icon >> lock >> flags >> name >> realmAddress >> population >> characters >> timezone >> id;
+
+        if (flags & 0x04)                                   // REALM_FLAG_SPECIFYBUILD
+            list.read_skip(5);
+
+        if (address.empty() && (m_config.realmName.empty() || m_config.realmName == name))
+            address = realmAddress;
+    }
+
+    if (!m_config.worldAddress.empty())
+        address = m_config.worldAddress;
+
+    if (address.empty())
+        return false;
+
+    uint32 now = WorldTimer::getMSTime();
+    sLoadStats.Record(LOAD_STAT_REALM_LOGIN, WorldTimer::getMSTimeDiff(m_loginStart, now));
+
+    m_worldAddress = address;
+    m_loginStart = now;
+    SetState(BOT_STATE_WORLD_AUTH, now);
+
+    if (!Connect(m_worldAddress))
+        Fail("can't connect to world");
+
+    return true;
+}
+
+bool BotClient::HandleWorldInput()
+{
+    size_t pos = 0;
+
+    while (m_peer.get_handle() != ACE_INVALID_HANDLE)
+    {
+        if (!m_headerRead)
+        {
+            if (m_in.size() - pos < AuthCrypt::CRYPTED_SEND_LEN)
+                break;
+
+            // server header: uint16 big endian size including opcode, uint16 opcode
+            uint8* header = &m_in[pos];
+            m_crypt.DecryptClientRecv(header, AuthCrypt::CRYPTED_SEND_LEN);
+
+            m_packetSize = (header[0] << 8) | header[1];
+            m_packetOpcode = header[2] | (header[3] << 8);
+            pos += AuthCrypt::CRYPTED_SEND_LEN;
+
+            if (m_packetSize < 2)
+                return false;
+
+            m_packetSize -= 2;
+            m_headerRead = true;
+        }
+
+        if (m_in.size() - pos < m_packetSize)
+            break;
+
+        WorldPacket packet(m_packetOpcode, m_packetSize);
+        if (m_packetSize)
+            packet.append(&m_in[pos], m_packetSize);
+
+        pos += m_packetSize;
+        m_headerRead = false;
+
+        if (!HandlePacket(packet))
+            return false;
+    }
+
+    if (m_peer.get_handle() != ACE_INVALID_HANDLE)
+        m_in.erase(m_in.begin(), m_in.begin() + pos);
+
+    return true;
+}
+
+bool BotClient::HandlePacket(WorldPacket& packet)
+{
+    switch (packet.GetOpcode())
+    {
+        case BOT_SMSG_AUTH_CHALLENGE:       return HandleAuthChallenge(packet);
+        case BOT_SMSG_AUTH_RESPONSE:        return HandleAuthResponse(packet);
+        case BOT_SMSG_CHAR_ENUM:            return HandleCharEnum(packet);
+        case BOT_SMSG_CHAR_CREATE:          return HandleCharCreate(packet);
+        case BOT_SMSG_LOGIN_VERIFY_WORLD:   HandleLoginVerifyWorld(packet);       break;
+        case BOT_SMSG_MESSAGECHAT:          HandleMessageChat(packet);            break;
+        case BOT_SMSG_SPELL_START:          HandleSpellStart(packet);             break;
+        case BOT_SMSG_CAST_FAILED:          HandleCastFailed(packet);             break;
+        case BOT_SMSG_ACTIVATETAXIREPLY:    HandleActivateTaxiReply(packet);      break;
+        case BOT_SMSG_PONG:                 Response(LOAD_STAT_PING);             break;
+        case BOT_SMSG_WHO:                  Response(LOAD_STAT_WHO);              break;
+        case BOT_SMSG_AUCTION_LIST_RESULT:  Response(LOAD_STAT_AUCTION);          break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+bool BotClient::HandleAuthChallenge(WorldPacket& packet)
+{
+    uint32 serverSeed;
+    packet >> serverSeed;
+
+    uint32 clientSeed = urand(1, 0xFFFFFFFE);
+    uint32 unk = 0;
+
+    Sha1Hash sha;
+    sha.UpdateData(m_account);
+    sha.UpdateData((uint8*)&unk, 4);
+    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&serverSeed, 4);
+    sha.UpdateBigNumbers(&m_K, NULL);
+    sha.Finalize();
+
+    // no addon data, server skips addon info then
+    WorldPacket data(BOT_CMSG_AUTH_SESSION, 4 + 4 + m_account.size() + 1 + 4 + 20);
+    data << uint32(BOT_CLIENT_BUILD);
+    data << uint32(unk);
+    data << m_account;
+    data << uint32(clientSeed);
+    data.append(sha.GetDigest(), 20);
+    SendPacket(data);
+
+    // everything after auth session is encrypted both ways
+    m_crypt.SetKey(&m_K);
+    m_crypt.Init();
+    return true;
+}
+
+bool BotClient::HandleAuthResponse(WorldPacket& packet)
+{
+    uint8 code;
+    packet >> code;
+
+    uint32 now = WorldTimer::getMSTime();
+    switch (code)
+    {
+        case AUTH_OK:
+        {
+            SetState(BOT_STATE_CHAR_SELECT, now);
+            WorldPacket data(BOT_CMSG_CHAR_ENUM, 0);
+            SendPacket(data);
+            return true;
+        }
+        case AUTH_WAIT_QUEUE:
+            // login queue is server working as configured, restart login timeout
+            m_stateTime = now;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool BotClient::HandleCharEnum(WorldPacket& packet)
+{
+    uint8 count;
+    packet >> count;
+
+    if (count)
+    {
+        packet >> m_guid;
+
+        WorldPacket data(BOT_CMSG_PLAYER_LOGIN, 8);
+        data << uint64(m_guid);
+        SendPacket(data);
+
+        SetState(BOT_STATE_LOGIN, WorldTimer::getMSTime());
+        return true;
+    }
+
+    // names take letters only, made of account number so they stay unique
+    std::string name = "Bot";
+    for (uint32 id = m_config.firstAccount + m_index; id; id /= 26)
+        name += char('a' + id % 26);
+
+    WorldPacket data(BOT_CMSG_CHAR_CREATE, name.size() + 1 + 9);
+    data << name;
+    data << uint8(m_config.race);
+    data << uint8(m_config.botClass);
+    data << uint8(m_index % 2);                             // gender
+    data << uint8(0) << uint8(0) << uint8(0) << uint8(0) << uint8(0);
+    data << uint8(0);                                       // outfit
+    SendPacket(data);
+    return true;
+}
+
+bool BotClient::HandleCharCreate(WorldPacket& packet)
+{
+    uint8 code;
+    packet >> code;
+
+    if (code != CHAR_CREATE_SUCCESS)
+        return false;
+
+    WorldPacket data(BOT_CMSG_CHAR_ENUM, 0);
+    SendPacket(data);
+    return true;
+}
+
+void BotClient::HandleLoginVerifyWorld(WorldPacket& packet)
+{
+    uint32 mapId;
+    packet >> mapId >> m_x >> m_y >> m_z >> m_o;
+
+    // also sent after far teleports, only first one finishes login
+    if (m_state != BOT_STATE_LOGIN)
+        return;
+
+    uint32 now = WorldTimer::getMSTime();
+    sLoadStats.Record(LOAD_STAT_WORLD_LOGIN, WorldTimer::getMSTimeDiff(m_loginStart, now));
+    SetState(BOT_STATE_IN_WORLD, now);
+
+    m_walking = false;
+    m_onTaxi = false;
+    m_nextAction = now + urand(0, m_config.actionInterval);
+    m_nextPing = now + m_config.pingInterval;
+}
+
+void BotClient::HandleMessageChat(WorldPacket& packet)
+{
+    uint8 type;
+    uint32 language;
+    uint64 sender;
+    packet >> type >> language >> sender;
+
+    if (type == CHAT_MSG_SAY && sender == m_guid)
+        Response(LOAD_STAT_CHAT);
+}
+
+void BotClient::HandleSpellStart(WorldPacket& packet)
+{
+    packet.readPackGUID();                                  // cast item or caster
+    uint64 caster = packet.readPackGUID();
+    uint32 spellId;
+    packet >> spellId;
+
+    if (caster == m_guid && spellId == m_config.castSpell)
+        Response(LOAD_STAT_CAST);
+}
+
+void BotClient::HandleCastFailed(WorldPacket& packet)
+{
+    uint32 spellId;
+    packet >> spellId;
+
+    if (spellId == m_config.castSpell)
+        Response(LOAD_STAT_CAST);
+}
+
+void BotClient::HandleActivateTaxiReply(WorldPacket& packet)
+{
+    uint32 result;
+    packet >> result;
+
+    Response(LOAD_STAT_TAXI);
+
+    if (result == 0)                                        // ERR_TAXIOK
+    {
+        m_onTaxi = true;
+        m_walking = false;
+    }
+}
+
+void BotClient::Update(uint32 now)
+{
+    switch (m_state)
+    {
+        case BOT_STATE_IDLE:
+            if (m_startTime && int32(now - m_startTime) >= 0)
+                Start(now);
+            return;
+        case BOT_STATE_FAILED:
+            return;
+        case BOT_STATE_IN_WORLD:
+            break;
+        default:
+            if (WorldTimer::getMSTimeDiff(m_stateTime, now) > m_config.loginTimeout)
+                Fail("login timeout");
+            return;
+    }
+
+    for (uint8 i = 0; i < MAX_LOAD_STATS; ++i)
+    {
+        if (m_pending[i] && WorldTimer::getMSTimeDiff(m_pending[i], now) > m_config.responseTimeout)
+        {
+            sLoadStats.RecordTimeout(LoadStatType(i));
+            m_pending[i] = 0;
+        }
+    }
+
+    if (m_config.pingInterval && int32(now - m_nextPing) >= 0)
+    {
+        SendPing(now);
+        m_nextPing = now + m_config.pingInterval;
+    }
+
+    if (m_walking)
+    {
+        UpdateWalk(now);
+        return;
+    }
+
+    if (int32(now - m_nextAction) >= 0)
+    {
+        DoAction(now);
+        m_nextAction = now + m_config.actionInterval / 2 + urand(0, m_config.actionInterval);
+    }
+}
+
+void BotClient::DoAction(uint32 now)
+{
+    uint32 weights[MAX_BOT_ACTIONS];
+    uint32 total = 0;
+
+    for (uint8 i = 0; i < MAX_BOT_ACTIONS; ++i)
+    {
+        weights[i] = m_config.actionWeight[i];
+        total += weights[i];
+    }
+
+    // walking after a flight would look like teleport to anticheat
+    if (m_onTaxi)
+    {
+        total -= weights[BOT_ACTION_WALK] + weights[BOT_ACTION_TAXI];
+        weights[BOT_ACTION_WALK] = weights[BOT_ACTION_TAXI] = 0;
+    }
+
+    if (!total)
+        return;
+
+    uint32 roll = urand(0, total - 1);
+    uint8 action = 0;
+    for (; action < MAX_BOT_ACTIONS - 1; ++action)
+    {
+        if (roll < weights[action])
+            break;
+
+        roll -= weights[action];
+    }
+
+    switch (action)
+    {
+        case BOT_ACTION_WALK:       StartWalk(now);         break;
+        case BOT_ACTION_CHAT:       SendChat(now);          break;
+        case BOT_ACTION_CAST:       SendCast(now);          break;
+        case BOT_ACTION_WHO:        SendWho(now);           break;
+        case BOT_ACTION_AUCTION:    SendAuctionList(now);   break;
+        case BOT_ACTION_TAXI:       SendTaxi(now);          break;
+    }
+}
+
+void BotClient::StartWalk(uint32 now)
+{
+    // turn around with some spread, so bots keep close to where they logged in
+    m_o += float(M_PI) + float(rand_norm() - 0.5);
+    if (m_o > 2 * M_PI)
+        m_o -= 2 * M_PI;
+
+    m_walking = true;
+    m_walkEnd = now + m_config.walkTime;
+    m_lastMove = now;
+    SendMovement(BOT_MSG_MOVE_START_FORWARD, BOT_MOVEFLAG_FORWARD, now);
+}
+
+void BotClient::UpdateWalk(uint32 now)
+{
+    bool done = int32(now - m_walkEnd) >= 0;
+    if (!done && WorldTimer::getMSTimeDiff(m_lastMove, now) < BOT_HEARTBEAT_INTERVAL)
+        return;
+
+    float dist = BOT_RUN_SPEED * WorldTimer::getMSTimeDiff(m_lastMove, now) / 1000.0f;
+    m_x += cos(m_o) * dist;
+    m_y += sin(m_o) * dist;
+    m_lastMove = now;
+
+    if (done)
+    {
+        m_walking = false;
+        SendMovement(BOT_MSG_MOVE_STOP, 0, now);
+    }
+    else
+        SendMovement(BOT_MSG_MOVE_HEARTBEAT, BOT_MOVEFLAG_FORWARD, now);
+}
+
+void BotClient::SendMovement(uint16 opcode, uint32 moveFlags, uint32 now)
+{
+    WorldPacket data(opcode, 4 + 1 + 4 + 4 * 4 + 4);
+    data << uint32(moveFlags);
+    data << uint8(0);
+    data << uint32(now);
+    data << m_x << m_y << m_z << m_o;
+    data << uint32(0);                                      // fall time
+    SendPacket(data);
+}
+
+void BotClient::SendChat(uint32 now)
+{
+    // universal language is refused for players
+    uint32 language = (BOT_RACEMASK_ALLIANCE & (1 << (m_config.race - 1))) ? LANG_COMMON : LANG_ORCISH;
+
+    std::ostringstream message;
+    message << "load test " << m_index << " " << ++m_chatSeq;
+
+    WorldPacket data(BOT_CMSG_MESSAGECHAT, 4 + 4 + message.str().size() + 1);
+    data << uint32(CHAT_MSG_SAY);
+    data << uint32(language);
+    data << message.str();
+    SendPacket(data);
+
+    Request(LOAD_STAT_CHAT, now);
+}
+
+void BotClient::SendCast(uint32 now)
+{
+    if (!m_config.castSpell)
+        return;
+
+    WorldPacket data(BOT_CMSG_CAST_SPELL, 4 + 1 + 4 + 9);
+    data << uint32(m_config.castSpell);
+    data << uint8(0);                                       // cast count
+    if (m_config.castTarget)
+    {
+        data << uint32(BOT_TARGET_FLAG_UNIT);
+        data.appendPackGUID(m_config.castTarget);
+    }
+    else
+        data << uint32(0);                                  // TARGET_FLAG_SELF
+    SendPacket(data);
+
+    Request(LOAD_STAT_CAST, now);
+}
+
+void BotClient::SendWho(uint32 now)
+{
+    WorldPacket data(BOT_CMSG_WHO, 4 * 6 + 2);
+    data << uint32(0) << uint32(BOT_WHO_MAX_LEVEL);
+    data << std::string() << std::string();                 // player and guild name
+    data << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF);       // race and class mask
+    data << uint32(0);                                      // zones
+    data << uint32(0);                                      // strings
+    SendPacket(data);
+
+    Request(LOAD_STAT_WHO, now);
+}
+
+void BotClient::SendAuctionList(uint32 now)
+{
+    if (!m_config.auctioneer)
+        return;
+
+    WorldPacket data(BOT_CMSG_AUCTION_LIST_ITEMS, 8 + 4 + 1 + 2 + 4 * 4 + 3);
+    data << uint64(m_config.auctioneer);
+    data << uint32(urand(0, 3) * 50);                       // list from, pages of 50
+    data << std::string();
+    data << uint8(0) << uint8(0);                           // level range
+    data << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF);
+    data << uint8(0) << uint8(0) << uint8(0);               // usable, full list, sort count
+    SendPacket(data);
+
+    Request(LOAD_STAT_AUCTION, now);
+}
+
+void BotClient::SendTaxi(uint32 now)
+{
+    if (!m_config.taxiMaster || m_config.taxiNodes.size() < 2)
+        return;
+
+    WorldPacket data(BOT_CMSG_ACTIVATETAXIEXPRESS, 8 + 4 + 4 + 4 * m_config.taxiNodes.size());
+    data << uint64(m_config.taxiMaster);
+    data << uint32(0);                                      // total cost, server counts its own
+    data << uint32(m_config.taxiNodes.size());
+    for (std::vector<uint32>::const_iterator itr = m_config.taxiNodes.begin(); itr != m_config.taxiNodes.end(); ++itr)
+        data << uint32(*itr);
+    SendPacket(data);
+
+    Request(LOAD_STAT_TAXI, now);
+}
+
+void BotClient::SendPing(uint32 now)
+{
+    WorldPacket data(BOT_CMSG_PING, 8);
+    data << uint32(++m_pingSeq);
+    data << uint32(m_lastLatency);
+    SendPacket(data);
+
+    Request(LOAD_STAT_PING, now);
+}
+
+void BotClient::Request(LoadStatType type, uint32 now)
+{
+    // one request of a type is timed at once, 0 means none pending
+    if (!m_pending[type])
+        m_pending[type] = now ? now : 1;
+}
+
+void BotClient::Response(LoadStatType type)
+{
+    if (!m_pending[type])
+        return;
+
+    uint32 latency = WorldTimer::getMSTimeDiffToNow(m_pending[type]);
+    m_pending[type] = 0;
+
+    if (type == LOAD_STAT_PING)
+        m_lastLatency = latency;
+
+    sLoadStats.Record(type, latency);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_BOTCLIENT_H
+#define HELLGROUND_BOTCLIENT_H
+
+#include "Common.h"
+#include "LoadStats.h"
+#include "Auth/AuthCrypt.h"
+#include "Auth/BigNumber.h"
+
+#include <ace/Event_Handler.h>
+#include <ace/SOCK_Stream.h>
+
+class WorldPacket;
+
+enum BotAction
+{
+    BOT_ACTION_WALK         = 0,
+    BOT_ACTION_CHAT         = 1,
+    BOT_ACTION_CAST         = 2,
+    BOT_ACTION_WHO          = 3,
+    BOT_ACTION_AUCTION      = 4,
+    BOT_ACTION_TAXI         = 5,
+    MAX_BOT_ACTIONS
+};
+
+// settings shared by all bots, read once from hellgroundloadgen.conf
+struct BotConfig
+{
+    std::string realmAddress;                               // host:port
+    std::string realmName;                                  // empty - first realm of realm list
+    std::string worldAddress;                               // empty - address from realm list
+    std::string accountPrefix;
+    std::string password;
+    uint32 firstAccount;
+    uint8 race;
+    uint8 botClass;
+
+    uint32 loginTimeout;
+    uint32 responseTimeout;
+    uint32 reconnectDelay;                                  // 0 - failed bots stay offline
+    uint32 pingInterval;
+
+    uint32 actionInterval;
+    uint32 actionWeight[MAX_BOT_ACTIONS];
+    uint32 walkTime;
+    uint32 castSpell;
+    uint64 castTarget;                                      // 0 - self cast
+    uint64 taxiMaster;
+    std::vector<uint32> taxiNodes;
+    uint64 auctioneer;
+};
+
+/**
+ * BotClient - one headless client, logs in through realm and world protocol and plays scripted actions.
+ *
+ * Bots are owned and updated by one BotWorker thread and registered with its reactor, so
+ * nothing in a bot is locked. Sockets are non blocking: output not accepted by kernel waits
+ * in m_out for handle_output. Every request with a known answer is timed into sLoadStats.
+ */
+class BotClient : public ACE_Event_Handler
+{
+    public:
+        BotClient(BotConfig const& config, ACE_Reactor* reactor, uint32 index);
+        ~BotClient();
+
+        void Start(uint32 now);
+        void Stop();
+        void Update(uint32 now);
+
+        BotState GetState() const { return m_state; }
+
+        virtual ACE_HANDLE get_handle() const { return m_peer.get_handle(); }
+        virtual int handle_input(ACE_HANDLE = ACE_INVALID_HANDLE);
+        virtual int handle_output(ACE_HANDLE = ACE_INVALID_HANDLE);
+
+    private:
+        void SetState(BotState state, uint32 now);
+        void Fail(char const* reason);
+
+        bool Connect(std::string const& address);
+        bool CompleteConnect();
+        void Disconnect();
+        bool Flush();
+        void SendRaw(uint8 const* data, size_t size);
+        void SendPacket(WorldPacket const& packet);
+
+        // realm protocol, false on malformed or refused answer
+        void SendLogonChallenge();
+        bool HandleRealmInput();
+        bool HandleLogonChallenge(size_t& used);
+        bool HandleLogonProof(size_t& used);
+        bool HandleRealmList(size_t& used);
+
+        // world protocol
+        bool HandleWorldInput();
+        bool HandlePacket(WorldPacket& packet);
+        bool HandleAuthChallenge(WorldPacket& packet);
+        bool HandleAuthResponse(WorldPacket& packet);
+        bool HandleCharEnum(WorldPacket& packet);
+        bool HandleCharCreate(WorldPacket& packet);
+        void HandleLoginVerifyWorld(WorldPacket& packet);
+        void HandleMessageChat(WorldPacket& packet);
+        void HandleSpellStart(WorldPacket& packet);
+        void HandleCastFailed(WorldPacket& packet);
+        void HandleActivateTaxiReply(WorldPacket& packet);
+
+        // scripted actions
+        void DoAction(uint32 now);
+        void StartWalk(uint32 now);
+        void UpdateWalk(uint32 now);
+        void SendMovement(uint16 opcode, uint32 moveFlags, uint32 now);
+        void SendChat(uint32 now);
+        void SendCast(uint32 now);
+        void SendWho(uint32 now);
+        void SendAuctionList(uint32 now);
+        void SendTaxi(uint32 now);
+        void SendPing(uint32 now);
+
+        void Request(LoadStatType type, uint32 now);
+        void Response(LoadStatType type);
+
+        BotConfig const& m_config;
+        uint32 m_index;
+        std::string m_account;
+        std::string m_password;
+
+        BotState m_state;
+        uint32 m_stateTime;
+        uint32 m_startTime;                                 // next start of idle bot
+        uint32 m_loginStart;
+
+        ACE_SOCK_Stream m_peer;
+        bool m_connecting;
+        bool m_outScheduled;
+        std::vector<uint8> m_in;
+        std::vector<uint8> m_out;
+
+        // SRP6 values kept between challenge and proof
+        BigNumber m_A;
+        BigNumber m_K;
+        uint8 m_M2[20];
+        std::string m_worldAddress;
+
+        AuthCrypt m_crypt;
+        bool m_headerRead;
+        uint16 m_packetSize;
+        uint16 m_packetOpcode;
+
+        uint64 m_guid;
+        float m_x, m_y, m_z, m_o;
+        bool m_walking;
+        bool m_onTaxi;                                      // position unknown after flight, no more walking
+        uint32 m_walkEnd;
+        uint32 m_lastMove;
+
+        uint32 m_nextAction;
+        uint32 m_nextPing;
+        uint32 m_pingSeq;
+        uint32 m_lastLatency;
+        uint32 m_chatSeq;
+        uint32 m_pending[MAX_LOAD_STATS];                   // request send time, 0 if nothing pending
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_BOTOPCODES_H
+#define HELLGROUND_BOTOPCODES_H
+
+// realm protocol commands used by bots, see AuthSocket
+enum BotRealmCommands
+{
+    BOT_CMD_AUTH_LOGON_CHALLENGE    = 0x00,
+    BOT_CMD_AUTH_LOGON_PROOF        = 0x01,
+    BOT_CMD_REALM_LIST              = 0x10
+};
+
+// world opcodes used by bots, values as in game/Opcodes.h which can't be used without WorldSession
+enum BotOpcodes
+{
+    BOT_CMSG_CHAR_CREATE            = 0x036,
+    BOT_CMSG_CHAR_ENUM              = 0x037,
+    BOT_SMSG_CHAR_CREATE            = 0x03A,
+    BOT_SMSG_CHAR_ENUM              = 0x03B,
+    BOT_CMSG_PLAYER_LOGIN           = 0x03D,
+    BOT_CMSG_WHO                    = 0x062,
+    BOT_SMSG_WHO                    = 0x063,
+    BOT_CMSG_MESSAGECHAT            = 0x095,
+    BOT_SMSG_MESSAGECHAT            = 0x096,
+    BOT_MSG_MOVE_START_FORWARD      = 0x0B5,
+    BOT_MSG_MOVE_STOP               = 0x0B7,
+    BOT_MSG_MOVE_HEARTBEAT          = 0x0EE,
+    BOT_CMSG_CAST_SPELL             = 0x12E,
+    BOT_SMSG_CAST_FAILED            = 0x130,
+    BOT_SMSG_SPELL_START            = 0x131,
+    BOT_SMSG_ACTIVATETAXIREPLY      = 0x1AE,
+    BOT_CMSG_PING                   = 0x1DC,
+    BOT_SMSG_PONG                   = 0x1DD,
+    BOT_SMSG_AUTH_CHALLENGE         = 0x1EC,
+    BOT_CMSG_AUTH_SESSION           = 0x1ED,
+    BOT_SMSG_AUTH_RESPONSE          = 0x1EE,
+    BOT_SMSG_LOGIN_VERIFY_WORLD     = 0x236,
+    BOT_CMSG_AUCTION_LIST_ITEMS     = 0x258,
+    BOT_SMSG_AUCTION_LIST_RESULT    = 0x25C,
+    BOT_CMSG_ACTIVATETAXIEXPRESS    = 0x312
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "BotWorker.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <ace/Dev_Poll_Reactor.h>
+#include <ace/TP_Reactor.h>
+
+BotWorker::BotWorker(BotConfig const& config) : m_config(config), m_reactor(NULL)
+{
+    ACE_Reactor_Impl* imp = 0;
+
+    #if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+
+    imp = new ACE_Dev_Poll_Reactor();
+
+    imp->max_notify_iterations(128);
+    imp->restart(1);
+
+    #else
+
+    imp = new ACE_TP_Reactor();
+    imp->max_notify_iterations(128);
+
+    #endif
+
+    m_reactor = new ACE_Reactor(imp, 1);
+}
+
+BotWorker::~BotWorker()
+{
+    Stop();
+    Wait();
+
+    for (std::vector<BotClient*>::iterator itr = m_bots.begin(); itr != m_bots.end(); ++itr)
+        delete *itr;
+
+    delete m_reactor;
+}
+
+int BotWorker::Start()
+{
+    return activate();
+}
+
+void BotWorker::Stop()
+{
+    m_reactor->end_reactor_event_loop();
+}
+
+void BotWorker::AddBot(uint32 index)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_newBotsLock);
+
+    m_newBots.push_back(index);
+}
+
+void BotWorker::StartNewBots()
+{
+    std::vector<uint32> newBots;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_newBotsLock);
+
+        if (m_newBots.empty())
+            return;
+
+        newBots.swap(m_newBots);
+    }
+
+    uint32 now = WorldTimer::getMSTime();
+    for (std::vector<uint32>::const_iterator itr = newBots.begin(); itr != newBots.end(); ++itr)
+    {
+        BotClient* bot = new BotClient(m_config, m_reactor, *itr);
+        m_bots.push_back(bot);
+        bot->Start(now);
+    }
+}
+
+int BotWorker::svc()
+{
+    DEBUG_LOG("Bot Worker Thread Starting");
+
+    while (!m_reactor->reactor_event_loop_done())
+    {
+        // dont be too smart to move this outside the loop
+        // the run_reactor_event_loop will modify interval
+        ACE_Time_Value interval(0, 10000);
+
+        if (m_reactor->run_reactor_event_loop(interval) == -1)
+            break;
+
+        StartNewBots();
+
+        uint32 now = WorldTimer::getMSTime();
+        for (std::vector<BotClient*>::iterator itr = m_bots.begin(); itr != m_bots.end(); ++itr)
+            (*itr)->Update(now);
+    }
+
+    // close sockets while reactor still exists
+    for (std::vector<BotClient*>::iterator itr = m_bots.begin(); itr != m_bots.end(); ++itr)
+        (*itr)->Stop();
+
+    DEBUG_LOG("Bot Worker Thread Exitting");
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_BOTWORKER_H
+#define HELLGROUND_BOTWORKER_H
+
+#include "Common.h"
+#include "BotClient.h"
+
+#include <ace/Task.h>
+#include <ace/Reactor.h>
+#include <ace/Thread_Mutex.h>
+
+/**
+ * BotWorker - network thread of bot clients, the same way ReactorRunnable serves world sockets.
+ *
+ * Runs own reactor for socket events of its bots and updates them between reactor runs,
+ * so a bot is only touched by its worker thread. Main thread hands new bots over through
+ * m_newBots during ramp up.
+ */
+class BotWorker : protected ACE_Task_Base
+{
+    public:
+        BotWorker(BotConfig const& config);
+        virtual ~BotWorker();
+
+        int Start();
+        void Stop();
+        void Wait() { ACE_Task_Base::wait(); }
+
+        void AddBot(uint32 index);
+
+    protected:
+        virtual int svc();
+
+    private:
+        void StartNewBots();
+
+        BotConfig const& m_config;
+        ACE_Reactor* m_reactor;
+
+        ACE_Thread_Mutex m_newBotsLock;
+        std::vector<uint32> m_newBots;
+
+        std::vector<BotClient*> m_bots;
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "LoadStats.h"
+
+static char const* statNames[MAX_LOAD_STATS] =
+{
+    "realm login",
+    "world login",
+    "ping",
+    "chat",
+    "who",
+    "auction",
+    "cast",
+    "taxi"
+};
+
+static char const* stateNames[MAX_BOT_STATES] =
+{
+    "idle",
+    "realm",
+    "world auth",
+    "char select",
+    "login",
+    "in world",
+    "failed"
+};
+
+void LoadStats::Histogram::Reset()
+{
+    std::fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+    sum = 0;
+    max = 0;
+    timeouts = 0;
+}
+
+uint32 LoadStats::Histogram::Percentile(uint32 percent) const
+{
+    uint64 wanted = (count * percent + 99) / 100;
+    uint64 seen = 0;
+
+    for (uint32 i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= wanted)
+            return i;
+    }
+
+    return LOAD_STATS_MAX_LATENCY;
+}
+
+LoadStats::LoadStats()
+{
+    memset(m_states, 0, sizeof(m_states));
+}
+
+void LoadStats::Record(LoadStatType type, uint32 latency)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    Histogram* histograms[2] = { &m_interval[type], &m_total[type] };
+    for (uint8 i = 0; i < 2; ++i)
+    {
+        Histogram& histogram = *histograms[i];
+        ++histogram.buckets[std::min<uint32>(latency, LOAD_STATS_MAX_LATENCY)];
+        ++histogram.count;
+        histogram.sum += latency;
+        histogram.max = std::max(histogram.max, latency);
+    }
+}
+
+void LoadStats::RecordTimeout(LoadStatType type)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    ++m_interval[type].timeouts;
+    ++m_total[type].timeouts;
+}
+
+void LoadStats::RecordFailure(char const* reason)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    ++m_failures[reason];
+}
+
+void LoadStats::AddBot()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    ++m_states[BOT_STATE_IDLE];
+}
+
+void LoadStats::ChangeState(BotState oldState, BotState newState)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    --m_states[oldState];
+    ++m_states[newState];
+}
+
+void LoadStats::BuildReport(std::vector<std::string>& lines, bool total)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    std::ostringstream states;
+    states << "bots:";
+    for (uint8 i = 0; i < MAX_BOT_STATES; ++i)
+        states << " " << stateNames[i] << " " << m_states[i] << (i + 1 < MAX_BOT_STATES ? "," : "");
+    lines.push_back(states.str());
+
+    for (uint8 i = 0; i < MAX_LOAD_STATS; ++i)
+    {
+        Histogram& histogram = total ? m_total[i] : m_interval[i];
+        BuildLine(lines, statNames[i], histogram);
+
+        if (!total)
+            histogram.Reset();
+    }
+
+    if (total)
+    {
+        for (std::map<std::string, uint32>::const_iterator itr = m_failures.begin(); itr != m_failures.end(); ++itr)
+        {
+            std::ostringstream failure;
+            failure << "failed " << itr->second << " times: " << itr->first;
+            lines.push_back(failure.str());
+        }
+    }
+}
+
+void LoadStats::BuildLine(std::vector<std::string>& lines, char const* name, Histogram const& histogram)
+{
+    if (!histogram.count && !histogram.timeouts)
+        return;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%-12s " UI64FMTD " responses, avg %u ms, p50 %u ms, p95 %u ms, p99 %u ms, max %u ms, " UI64FMTD " timeouts",
+        name, histogram.count, histogram.count ? uint32(histogram.sum / histogram.count) : 0,
+        histogram.Percentile(50), histogram.Percentile(95), histogram.Percentile(99), histogram.max, histogram.timeouts);
+    lines.push_back(buf);
+}
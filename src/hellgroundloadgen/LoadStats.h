@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_LOADSTATS_H
+#define HELLGROUND_LOADSTATS_H
+
+#include "Common.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+
+// latency histograms have 1 ms buckets, slower responses share the last one
+#define LOAD_STATS_MAX_LATENCY  10000
+
+enum LoadStatType
+{
+    LOAD_STAT_REALM_LOGIN   = 0,                            // realm connect to realm list
+    LOAD_STAT_WORLD_LOGIN   = 1,                            // world connect to SMSG_LOGIN_VERIFY_WORLD
+    LOAD_STAT_PING          = 2,
+    LOAD_STAT_CHAT          = 3,                            // own say echo
+    LOAD_STAT_WHO           = 4,
+    LOAD_STAT_AUCTION       = 5,
+    LOAD_STAT_CAST          = 6,                            // spell start or cast failed
+    LOAD_STAT_TAXI          = 7,
+    MAX_LOAD_STATS
+};
+
+enum BotState
+{
+    BOT_STATE_IDLE          = 0,                            // waiting for start or reconnect
+    BOT_STATE_REALM         = 1,
+    BOT_STATE_WORLD_AUTH    = 2,
+    BOT_STATE_CHAR_SELECT   = 3,
+    BOT_STATE_LOGIN         = 4,
+    BOT_STATE_IN_WORLD      = 5,
+    BOT_STATE_FAILED        = 6,                            // no reconnect configured
+    MAX_BOT_STATES
+};
+
+/**
+ * LoadStats - response latencies and bot counts shared by all bot workers.
+ *
+ * Every latency type keeps a histogram of the current report interval and one of the whole
+ * run, so interval reports show changes under growing load and final report the total.
+ */
+class LoadStats
+{
+    public:
+        LoadStats();
+
+        void Record(LoadStatType type, uint32 latency);
+        void RecordTimeout(LoadStatType type);
+        void RecordFailure(char const* reason);
+        void AddBot();
+        void ChangeState(BotState oldState, BotState newState);
+
+        void BuildReport(std::vector<std::string>& lines, bool total);
+
+    private:
+        struct Histogram
+        {
+            Histogram() : buckets(LOAD_STATS_MAX_LATENCY + 1, 0), count(0), sum(0), max(0), timeouts(0) {}
+
+            void Reset();
+            uint32 Percentile(uint32 percent) const;
+
+            std::vector<uint32> buckets;
+            uint64 count;
+            uint64 sum;
+            uint32 max;
+            uint64 timeouts;
+        };
+
+        void BuildLine(std::vector<std::string>& lines, char const* name, Histogram const& histogram);
+
+        ACE_Thread_Mutex m_lock;
+        Histogram m_interval[MAX_LOAD_STATS];
+        Histogram m_total[MAX_LOAD_STATS];
+        uint32 m_states[MAX_BOT_STATES];
+        std::map<std::string, uint32> m_failures;
+};
+
+#define sLoadStats (*ACE_Singleton<LoadStats, ACE_Thread_Mutex>::instance())
+
+#endif
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/// \addtogroup loadgen Bot Load Generator
+/// @{
+/// \file
+
+#include "Common.h"
+#include "Config/Config.h"
+#include "Log.h"
+#include "Timer.h"
+#include "Util.h"
+#include "SystemConfig.h"
+#include "revision.h"
+#include "BotWorker.h"
+#include "LoadStats.h"
+
+#include <ace/Get_Opt.h>
+#include <ace/ACE.h>
+#include <ace/OS_NS_unistd.h>
+
+bool stopEvent = false;                                     ///< Setting it to true stops the bots
+
+void OnSignal(int s);
+void HookSignals();
+void UnhookSignals();
+
+/// Print out the usage string for this program on the console.
+void usage(const char *prog)
+{
+    sLog.outString("Usage: \n %s [<options>]\n"
+        "    -v, --version            print version and exist\n\r"
+        "    -c config_file           use config_file as configuration file\n\r"
+        ,prog);
+}
+
+/// Read object guid written in hex, as shown by .npc info
+uint64 ReadGuid(char const* name)
+{
+    uint64 guid = 0;
+    std::istringstream in(sConfig.GetStringDefault(name, ""));
+    in >> std::hex >> guid;
+    return guid;
+}
+
+/// Fill bot settings from configuration file
+void LoadBotConfig(BotConfig& config)
+{
+    config.realmAddress = sConfig.GetStringDefault("LoadGen.RealmAddress", "127.0.0.1:3724");
+    config.realmName = sConfig.GetStringDefault("LoadGen.RealmName", "");
+    config.worldAddress = sConfig.GetStringDefault("LoadGen.WorldAddress", "");
+    config.accountPrefix = sConfig.GetStringDefault("LoadGen.AccountPrefix", "BOT");
+    config.password = sConfig.GetStringDefault("LoadGen.Password", "BOT");
+    config.firstAccount = sConfig.GetIntDefault("LoadGen.FirstAccount", 1);
+    config.race = sConfig.GetIntDefault("LoadGen.Character.Race", 1);
+    config.botClass = sConfig.GetIntDefault("LoadGen.Character.Class", 1);
+
+    config.loginTimeout = sConfig.GetIntDefault("LoadGen.LoginTimeout", 30000);
+    config.responseTimeout = sConfig.GetIntDefault("LoadGen.ResponseTimeout", 5000);
+    config.reconnectDelay = sConfig.GetIntDefault("LoadGen.ReconnectDelay", 10000);
+    config.pingInterval = sConfig.GetIntDefault("LoadGen.PingInterval", 30000);
+
+    config.actionInterval = std::max(sConfig.GetIntDefault("LoadGen.ActionInterval", 5000), 100);
+    config.actionWeight[BOT_ACTION_WALK] = sConfig.GetIntDefault("LoadGen.Weight.Walk", 40);
+    config.actionWeight[BOT_ACTION_CHAT] = sConfig.GetIntDefault("LoadGen.Weight.Chat", 15);
+    config.actionWeight[BOT_ACTION_CAST] = sConfig.GetIntDefault("LoadGen.Weight.Cast", 15);
+    config.actionWeight[BOT_ACTION_WHO] = sConfig.GetIntDefault("LoadGen.Weight.Who", 10);
+    config.actionWeight[BOT_ACTION_AUCTION] = sConfig.GetIntDefault("LoadGen.Weight.Auction", 10);
+    config.actionWeight[BOT_ACTION_TAXI] = sConfig.GetIntDefault("LoadGen.Weight.Taxi", 0);
+
+    config.walkTime = sConfig.GetIntDefault("LoadGen.WalkTime", 3000);
+    config.castSpell = sConfig.GetIntDefault("LoadGen.Cast.Spell", 0);
+    config.castTarget = ReadGuid("LoadGen.Cast.Target");
+    config.taxiMaster = ReadGuid("LoadGen.Taxi.Master");
+    config.auctioneer = ReadGuid("LoadGen.Auctioneer");
+
+    Tokens nodes = StrSplit(sConfig.GetStringDefault("LoadGen.Taxi.Nodes", ""), " ");
+    for (Tokens::const_iterator itr = nodes.begin(); itr != nodes.end(); ++itr)
+        config.taxiNodes.push_back(atoi(itr->c_str()));
+}
+
+/// Log report lines of the interval or the whole run
+void Report(bool total)
+{
+    std::vector<std::string> lines;
+    sLoadStats.BuildReport(lines, total);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        sLog.outString("%s%s", total ? "TOTAL " : "", itr->c_str());
+}
+
+/// Launch the bots
+extern int main(int argc, char **argv)
+{
+    ///- Command line parsing
+    char const* cfg_file = _HELLGROUND_LOADGEN_CONFIG;
+
+    char const *options = ":c:";
+
+    ACE_Get_Opt cmd_opts(argc, argv, options);
+    cmd_opts.long_option("version", 'v');
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        switch (option)
+        {
+            case 'c':
+                cfg_file = cmd_opts.opt_arg();
+                break;
+            case 'v':
+                printf("%s\n", _FULLVERSION);
+                return 0;
+            case ':':
+                printf("Runtime-Error: -%c option requires an input argument", cmd_opts.opt_opt());
+                usage(argv[0]);
+                return 1;
+            default:
+                printf("Runtime-Error: bad format of commandline arguments");
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!sConfig.SetSource(cfg_file))
+    {
+        printf("Could not find configuration file %s.", cfg_file);
+        return 1;
+    }
+
+    sLog.Initialize();
+
+    sLog.outString("%s (loadgen)", _FULLVERSION);
+    sLog.outString("<Ctrl-C> to stop.\n");
+    sLog.outString("Using configuration file %s.", cfg_file);
+
+    BotConfig config;
+    LoadBotConfig(config);
+
+    uint32 botCount = sConfig.GetIntDefault("LoadGen.Bots", 100);
+    uint32 threadCount = std::max(sConfig.GetIntDefault("LoadGen.Threads", 4), 1);
+    uint32 rampRate = std::max(sConfig.GetIntDefault("LoadGen.RampRate", 20), 1);
+    uint32 duration = sConfig.GetIntDefault("LoadGen.Duration", 0) * IN_MILISECONDS;
+    uint32 reportInterval = std::max(sConfig.GetIntDefault("LoadGen.ReportInterval", 10), 1) * IN_MILISECONDS;
+
+    // every bot holds a realm or world socket
+    ACE::set_handle_limit(-1);
+    sLog.outBasic("Max allowed open files is %d", ACE::max_handles());
+    if (uint32(ACE::max_handles()) < botCount + 64)
+        sLog.outLog(LOG_DEFAULT, "ERROR: %u bots need more open files than allowed, raise hard limit (ulimit -n)", botCount);
+
+    std::vector<BotWorker*> workers;
+    for (uint32 i = 0; i < threadCount; ++i)
+    {
+        BotWorker* worker = new BotWorker(config);
+        if (worker->Start() == -1)
+        {
+            sLog.outLog(LOG_DEFAULT, "ERROR: Can't start bot worker thread");
+            delete worker;
+            break;
+        }
+
+        workers.push_back(worker);
+    }
+
+    if (workers.empty())
+        return 1;
+
+    sLog.outString("Starting %u bots as %s%u.. on %u threads, %u bots per second, realm %s",
+        botCount, config.accountPrefix.c_str(), config.firstAccount, uint32(workers.size()), rampRate, config.realmAddress.c_str());
+
+    ///- Catch termination signals
+    HookSignals();
+
+    uint32 startTime = WorldTimer::getMSTime();
+    uint32 lastReport = startTime;
+    uint32 started = 0;
+
+    while (!stopEvent)
+    {
+        ACE_OS::sleep(ACE_Time_Value(0, 100000));
+
+        uint32 now = WorldTimer::getMSTime();
+        uint32 elapsed = WorldTimer::getMSTimeDiff(startTime, now);
+
+        ///- Ramp up, bots are spread over workers in turn
+        uint32 wanted = std::min<uint64>(botCount, uint64(elapsed) * rampRate / IN_MILISECONDS + 1);
+        for (; started < wanted; ++started)
+            workers[started % workers.size()]->AddBot(started);
+
+        if (WorldTimer::getMSTimeDiff(lastReport, now) >= reportInterval)
+        {
+            lastReport = now;
+            Report(false);
+        }
+
+        if (duration && elapsed >= duration)
+            stopEvent = true;
+    }
+
+    sLog.outString("Stopping bots...");
+
+    for (std::vector<BotWorker*>::iterator itr = workers.begin(); itr != workers.end(); ++itr)
+        (*itr)->Stop();
+
+    for (std::vector<BotWorker*>::iterator itr = workers.begin(); itr != workers.end(); ++itr)
+        delete *itr;
+
+    Report(true);
+
+    ///- Remove signal handling before leaving
+    UnhookSignals();
+
+    sLog.outString("Halting process...");
+    return 0;
+}
+
+/// Handle termination signals
+/** Put the global variable stopEvent to 'true' if a termination signal is caught **/
+void OnSignal(int s)
+{
+    switch (s)
+    {
+        case SIGINT:
+        case SIGTERM:
+            stopEvent = true;
+            break;
+        #ifdef _WIN32
+        case SIGBREAK:
+            stopEvent = true;
+            break;
+        #endif
+    }
+
+    signal(s, OnSignal);
+}
+
+/// Define hook 'OnSignal' for all termination signals
+void HookSignals()
+{
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+    #ifdef _WIN32
+    signal(SIGBREAK, OnSignal);
+    #endif
+}
+
+/// Unhook the signals before leaving
+void UnhookSignals()
+{
+    signal(SIGINT, 0);
+    signal(SIGTERM, 0);
+    #ifdef _WIN32
+    signal(SIGBREAK, 0);
+    #endif
+}
+
+/// @}
@@ -133,7 +133,7 @@ uint32 GetEncounterForEntry(uint32 entry)
 
 void instance_karazhan::HandleInitCreatureState(Creature * mob)
 {
-    if (!mob->GetTerrain()->IsLineOfSightEnabled())
+    if (!mob->GetMap()->IsLineOfSightEnabled())
         mob->SetAggroRange(15);
 
     InstanceData::HandleInitCreatureState(mob);
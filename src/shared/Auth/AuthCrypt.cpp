@@ -37,7 +37,36 @@ void AuthCrypt::DecryptRecv(uint8 *data, size_t len)
     if (!_initialized) return;
     if (len < CRYPTED_RECV_LEN) return;
 
-    for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
+    Decrypt(data, CRYPTED_RECV_LEN);
+}
+
+void AuthCrypt::EncryptSend(uint8 *data, size_t len)
+{
+    if (!_initialized) return;
+    if (len < CRYPTED_SEND_LEN) return;
+
+    Encrypt(data, CRYPTED_SEND_LEN);
+}
+
+void AuthCrypt::EncryptClientSend(uint8 *data, size_t len)
+{
+    if (!_initialized) return;
+    if (len < CRYPTED_RECV_LEN) return;
+
+    Encrypt(data, CRYPTED_RECV_LEN);
+}
+
+void AuthCrypt::DecryptClientRecv(uint8 *data, size_t len)
+{
+    if (!_initialized) return;
+    if (len < CRYPTED_SEND_LEN) return;
+
+    Decrypt(data, CRYPTED_SEND_LEN);
+}
+
+void AuthCrypt::Decrypt(uint8 *data, size_t len)
+{
+    for (size_t t = 0; t < len; t++)
     {
         _recv_i %= _key.size();
         uint8 x = (data[t] - _recv_j) ^ _key[_recv_i];
@@ -47,12 +76,9 @@ void AuthCrypt::DecryptRecv(uint8 *data, size_t len)
     }
 }
 
-void AuthCrypt::EncryptSend(uint8 *data, size_t len)
+void AuthCrypt::Encrypt(uint8 *data, size_t len)
 {
-    if (!_initialized) return;
-    if (len < CRYPTED_SEND_LEN) return;
-
-    for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+    for (size_t t = 0; t < len; t++)
     {
         _send_i %= _key.size();
         uint8 x = (data[t] ^ _key[_send_i]) + _send_j;
@@ -42,11 +42,18 @@ class AuthCrypt
         void DecryptRecv(uint8 *, size_t);
         void EncryptSend(uint8 *, size_t);
 
+        // client side of the same stream, used by bots: client sends 6 byte headers and receives 4 byte ones
+        void EncryptClientSend(uint8 *, size_t);
+        void DecryptClientRecv(uint8 *, size_t);
+
         bool IsInitialized() { return _initialized; }
 
         static void GenerateKey(uint8 *, BigNumber *);
 
     private:
+        void Decrypt(uint8 *, size_t);
+        void Encrypt(uint8 *, size_t);
+
         std::vector<uint8> _key;
         uint8 _send_i, _send_j, _recv_i, _recv_j;
         bool _initialized;
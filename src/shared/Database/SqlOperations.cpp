@@ -21,6 +21,7 @@
 #include "SqlDelayThread.h"
 #include "DatabaseEnv.h"
 #include "DatabaseImpl.h"
+#include "TickTracer.h"
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
 
@@ -102,6 +103,7 @@ void SqlResultQueue::Update()
     Hellground::IQueryCallback* callback = NULL;
     while (next(callback))
     {
+        TraceZone traceCallback("SqlResultQueue::Callback");
         callback->Execute();
         delete callback;
     }
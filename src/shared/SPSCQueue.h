@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <tbb/atomic.h>
+
+namespace ACE_Based
+{
+    /// Bounded lock free queue for one producer and one consumer thread.
+    /// push() must be called only by the producer, front()/pop_front() only by the consumer.
+    /// Threads may change as long as handover between them is synchronized elsewhere.
+    template <class T, unsigned int Size>
+        class SPSCQueue
+    {
+        //! Storage, one slot is always left empty to tell full from empty
+        T _items[Size];
+
+        //! Next slot to read, written only by consumer
+        tbb::atomic<unsigned int> _head;
+
+        //! Next slot to write, written only by producer
+        tbb::atomic<unsigned int> _tail;
+
+        public:
+
+            SPSCQueue()
+            {
+                _head = 0;
+                _tail = 0;
+            }
+
+            //! Adds an item, returns false when queue is full.
+            bool push(const T& item)
+            {
+                const unsigned int tail = _tail;
+                const unsigned int next = (tail + 1) % Size;
+
+                if (next == _head)
+                    return false;
+
+                _items[tail] = item;
+                _tail = next;                               // release, item is visible before new tail
+                return true;
+            }
+
+            //! Copies oldest item without removing it, returns false when queue is empty.
+            bool front(T& result) const
+            {
+                const unsigned int head = _head;
+
+                if (head == _tail)                          // acquire, see item written before tail
+                    return false;
+
+                result = _items[head];
+                return true;
+            }
+
+            //! Removes oldest item, queue must not be empty.
+            void pop_front()
+            {
+                _head = (_head + 1) % Size;
+            }
+
+            //! Removes and returns oldest item, returns false when queue is empty.
+            bool next(T& result)
+            {
+                if (!front(result))
+                    return false;
+
+                pop_front();
+                return true;
+            }
+
+            bool empty() const
+            {
+                return _head == _tail;
+            }
+    };
+}
+#endif
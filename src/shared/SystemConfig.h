@@ -50,6 +50,7 @@
 
 #define _HELLGROUND_CORE_CONFIG SYSCONFDIR "hellgroundcore.conf"
 #define _HELLGROUND_REALM_CONFIG SYSCONFDIR "hellgroundrealm.conf"
+#define _HELLGROUND_LOADGEN_CONFIG SYSCONFDIR "hellgroundloadgen.conf"
 
 // Format is YYYYMMDDRR where RR is the change in the conf file
 // for that day.
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "TickTracer.h"
+#include "Log.h"
+#include "Config/Config.h"
+
+#include <ace/OS_NS_sys_time.h>
+
+TraceBuffer::TraceBuffer(uint32 capacity, uint32 threadIndex) : m_capacity(capacity), m_threadIndex(threadIndex)
+{
+    m_events = new TraceEvent[capacity];
+    m_written = 0;
+}
+
+TraceBuffer::~TraceBuffer()
+{
+    delete [] m_events;
+}
+
+void TraceBuffer::CopyEvents(ACE_hrtime_t cutoff, std::vector<TraceEvent>& events) const
+{
+    uint64 written = m_written;
+    uint64 first = written > m_capacity ? written - m_capacity : 0;
+
+    size_t copyStart = events.size();
+    for (uint64 i = first; i < written; ++i)
+        events.push_back(m_events[i % m_capacity]);
+
+    // owner kept writing while we copied, oldest copied events may be torn
+    uint64 writtenAfter = m_written;
+    uint64 firstValid = writtenAfter > m_capacity ? writtenAfter - m_capacity : 0;
+    size_t skip = firstValid > first ? size_t(firstValid - first) : 0;
+
+    std::vector<TraceEvent>::iterator dest = events.begin() + copyStart;
+    for (std::vector<TraceEvent>::iterator itr = dest + std::min(skip, events.size() - copyStart); itr != events.end(); ++itr)
+    {
+        if (itr->start >= cutoff)
+            *dest++ = *itr;
+    }
+
+    events.erase(dest, events.end());
+}
+
+TickTracer::TickTracer() : m_bufferSize(131072), m_dumpThreshold(0), m_dumpSeconds(5), m_lastAutoDump(0)
+{
+    m_enabled = false;
+    m_startTicks = Now();
+    m_startTime = ACE_OS::gettimeofday();
+}
+
+TickTracer::~TickTracer()
+{
+    if (m_writer.activated())
+        m_writer.deactivate();
+
+    for (std::vector<TraceBuffer*>::iterator itr = m_buffers.begin(); itr != m_buffers.end(); ++itr)
+        delete *itr;
+}
+
+void TickTracer::Configure(uint32 bufferSize, uint32 dumpThreshold, uint32 dumpSeconds)
+{
+    // already created buffers keep their size
+    m_bufferSize = bufferSize ? bufferSize : 1;
+    m_dumpThreshold = dumpThreshold;
+    m_dumpSeconds = dumpSeconds ? dumpSeconds : 1;
+}
+
+TraceBuffer* TickTracer::CreateThreadBuffer()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_buffersLock, NULL);
+
+    TraceBuffer* buffer = new TraceBuffer(m_bufferSize, m_buffers.size());
+    m_buffers.push_back(buffer);
+    return buffer;
+}
+
+double TickTracer::GetTicksPerMicrosecond() const
+{
+    ACE_hrtime_t ticks = Now() - m_startTicks;
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - m_startTime;
+
+    uint64 usec = uint64(elapsed.sec()) * 1000000 + elapsed.usec();
+    if (!usec || !ticks)
+        return 1.0;
+
+    return double(ticks) / double(usec);
+}
+
+class TraceWriteRequest : public ACE_Method_Request
+{
+    public:
+        TraceWriteRequest(TraceSnapshot* snapshot, uint32 tickTime, uint32 seconds) : m_snapshot(snapshot), m_tickTime(tickTime), m_seconds(seconds) {}
+        ~TraceWriteRequest() { delete m_snapshot; }
+
+        virtual int call()
+        {
+            std::string fileName = sTickTracer.Write(*m_snapshot);
+            if (!fileName.empty())
+                sLog.outLog(LOG_DIFF, "Tick took %u ms, trace of last %u seconds written to %s", m_tickTime, m_seconds, fileName.c_str());
+            return 0;
+        }
+
+    private:
+        TraceSnapshot* m_snapshot;
+        uint32 m_tickTime;
+        uint32 m_seconds;
+};
+
+void TickTracer::EndTick(uint32 tickTime)
+{
+    if (!m_enabled || !m_dumpThreshold || tickTime < m_dumpThreshold)
+        return;
+
+    time_t now = time(NULL);
+    if (now < m_lastAutoDump + TICK_TRACE_AUTO_DUMP_COOLDOWN)
+        return;
+
+    m_lastAutoDump = now;
+
+    TraceSnapshot* snapshot = new TraceSnapshot;
+    if (!Collect(m_dumpSeconds, *snapshot))
+    {
+        delete snapshot;
+        return;
+    }
+
+    if (!m_writer.activated() && m_writer.activate(1) == -1)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: TickTracer: can't start trace writer thread");
+        delete snapshot;
+        return;
+    }
+
+    // executor deletes request on failure
+    m_writer.execute(new TraceWriteRequest(snapshot, tickTime, m_dumpSeconds));
+}
+
+static void WriteJsonString(FILE* file, char const* str)
+{
+    fputc('"', file);
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+            fputc('\\', file);
+
+        if (uint8(*str) >= 0x20)
+            fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+std::string TickTracer::Dump(uint32 seconds)
+{
+    TraceSnapshot snapshot;
+    if (!Collect(seconds, snapshot))
+        return "";
+
+    return Write(snapshot);
+}
+
+bool TickTracer::Collect(uint32 seconds, TraceSnapshot& snapshot)
+{
+    snapshot.ticksPerUsec = GetTicksPerMicrosecond();
+    ACE_hrtime_t now = Now();
+    ACE_hrtime_t window = ACE_hrtime_t(double(seconds) * 1000000.0 * snapshot.ticksPerUsec);
+    ACE_hrtime_t cutoff = now - m_startTicks > window ? now - window : m_startTicks;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_buffersLock, false);
+
+    snapshot.threadCount = m_buffers.size();
+
+    for (std::vector<TraceBuffer*>::const_iterator itr = m_buffers.begin(); itr != m_buffers.end(); ++itr)
+    {
+        (*itr)->CopyEvents(cutoff, snapshot.events);
+        snapshot.eventThreads.resize(snapshot.events.size(), (*itr)->GetThreadIndex());
+    }
+
+    return true;
+}
+
+std::string TickTracer::Write(TraceSnapshot const& snapshot) const
+{
+    std::vector<TraceEvent> const& events = snapshot.events;
+    std::vector<uint32> const& eventThreads = snapshot.eventThreads;
+    uint32 threadCount = snapshot.threadCount;
+    double ticksPerUsec = snapshot.ticksPerUsec;
+
+    std::string fileName = sConfig.GetStringDefault("LogsDir", "");
+    if (!fileName.empty() && fileName[fileName.size() - 1] != '/' && fileName[fileName.size() - 1] != '\\')
+        fileName.push_back('/');
+
+    fileName += "ticktrace_" + Log::GetTimestampStr() + ".json";
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outLog(LOG_DEFAULT, "ERROR: TickTracer: can't open %s for writing", fileName.c_str());
+        return "";
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        TraceEvent const& event = events[i];
+        double start = double(event.start - m_startTicks) / ticksPerUsec;
+        double duration = event.end > event.start ? double(event.end - event.start) / ticksPerUsec : 0.0;
+
+        fprintf(file, "{\"name\":");
+        WriteJsonString(file, event.name);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"arg\":%u}},\n",
+            eventThreads[i], start, duration, event.arg);
+    }
+
+    // thread names, also closes event list without trailing comma
+    for (uint32 i = 0; i < threadCount; ++i)
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}%s\n",
+            i, i, i + 1 < threadCount ? "," : "");
+
+    fprintf(file, "]}\n");
+    fclose(file);
+
+    return fileName;
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2008-2014 Hellground <http://hellground.net/>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef HELLGROUND_TICKTRACER_H
+#define HELLGROUND_TICKTRACER_H
+
+#include "Common.h"
+#include "DelayExecutor.h"
+
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/TSS_T.h>
+#include <ace/OS_NS_time.h>
+#include <tbb/atomic.h>
+
+#include <vector>
+
+// minimal time between two dumps triggered by slow ticks (in seconds)
+#define TICK_TRACE_AUTO_DUMP_COOLDOWN 60
+
+struct TraceEvent
+{
+    char const* name;                                       // must point to static storage (literal, opcode table)
+    uint32 arg;
+    ACE_hrtime_t start;
+    ACE_hrtime_t end;
+};
+
+/// Events copied out of thread rings, written to file by Dump or by background writer
+struct TraceSnapshot
+{
+    std::vector<TraceEvent> events;
+    std::vector<uint32> eventThreads;                       // thread index of each event
+    uint32 threadCount;
+    double ticksPerUsec;
+};
+
+/// Ring of last events recorded by one thread, only owning thread writes to it
+class TraceBuffer
+{
+    public:
+        TraceBuffer(uint32 capacity, uint32 threadIndex);
+        ~TraceBuffer();
+
+        void Push(char const* name, uint32 arg, ACE_hrtime_t start, ACE_hrtime_t end)
+        {
+            uint64 written = m_written;
+            TraceEvent& event = m_events[written % m_capacity];
+            event.name = name;
+            event.arg = arg;
+            event.start = start;
+            event.end = end;
+            m_written = written + 1;                        // release, event is complete before counter moves
+        }
+
+        // copies events started after cutoff, events overwritten during copy are dropped
+        void CopyEvents(ACE_hrtime_t cutoff, std::vector<TraceEvent>& events) const;
+
+        uint32 GetThreadIndex() const { return m_threadIndex; }
+
+    private:
+        TraceEvent* m_events;
+        uint32 m_capacity;
+        uint32 m_threadIndex;
+        tbb::atomic<uint64> m_written;
+};
+
+/**
+ * TickTracer - low overhead timeline of world/map tick phases.
+ *
+ * Zones are recorded to per thread rings only while tracing is enabled, otherwise
+ * each zone costs a single flag check. Last seconds of all threads can be written
+ * as Chrome trace JSON (chrome://tracing, ui.perfetto.dev) on demand or automatically
+ * when world tick takes longer than configured threshold.
+ */
+class TickTracer
+{
+    friend class ACE_Singleton<TickTracer, ACE_Thread_Mutex>;
+    TickTracer();
+    ~TickTracer();
+
+    public:
+        static ACE_hrtime_t Now() { return ACE_OS::gethrtime(); }
+
+        void Configure(uint32 bufferSize, uint32 dumpThreshold, uint32 dumpSeconds);
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        bool IsEnabled() const { return m_enabled; }
+
+        uint32 GetDumpThreshold() const { return m_dumpThreshold; }
+        void SetDumpThreshold(uint32 threshold) { m_dumpThreshold = threshold; }
+        uint32 GetDumpSeconds() const { return m_dumpSeconds; }
+
+        void Record(char const* name, uint32 arg, ACE_hrtime_t start, ACE_hrtime_t end)
+        {
+            if (TraceBuffer* buffer = GetThreadBuffer())
+                buffer->Push(name, arg, start, end);
+        }
+
+        // called by world thread after each tick, queues dump to writer thread if tick was too long
+        void EndTick(uint32 tickTime);
+
+        // writes events from last seconds to new file in logs dir, returns file name or empty string on failure
+        std::string Dump(uint32 seconds);
+
+        // copies events from last seconds, cheap part of dump done by calling thread
+        bool Collect(uint32 seconds, TraceSnapshot& snapshot);
+        std::string Write(TraceSnapshot const& snapshot) const;
+
+    private:
+        struct BufferSlot
+        {
+            BufferSlot() : buffer(NULL) {}
+            TraceBuffer* buffer;
+        };
+
+        TraceBuffer* GetThreadBuffer()
+        {
+            BufferSlot* slot = m_threadSlot.ts_object();
+            if (!slot)
+            {
+                slot = new BufferSlot;
+                m_threadSlot.ts_object(slot);
+            }
+
+            // stays NULL if buffer couldn't be registered, tried again on next zone
+            if (!slot->buffer)
+                slot->buffer = CreateThreadBuffer();
+            return slot->buffer;
+        }
+
+        TraceBuffer* CreateThreadBuffer();
+        double GetTicksPerMicrosecond() const;
+
+        tbb::atomic<bool> m_enabled;
+        uint32 m_bufferSize;
+        uint32 m_dumpThreshold;
+        uint32 m_dumpSeconds;
+        time_t m_lastAutoDump;
+
+        // reference point to convert hrtime ticks to wall clock microseconds
+        ACE_hrtime_t m_startTicks;
+        ACE_Time_Value m_startTime;
+
+        ACE_TSS<BufferSlot> m_threadSlot;
+
+        // buffers are owned by tracer and outlive their threads
+        ACE_Thread_Mutex m_buffersLock;
+        std::vector<TraceBuffer*> m_buffers;
+
+        // writes automatic dumps, so slow tick isn't made longer by file output
+        DelayExecutor m_writer;
+};
+
+#define sTickTracer (*ACE_Singleton<TickTracer, ACE_Thread_Mutex>::instance())
+
+/// Scoped zone, name must be a string with static storage
+class TraceZone
+{
+    public:
+        explicit TraceZone(char const* name, uint32 arg = 0) : m_name(name), m_arg(arg), m_start(sTickTracer.IsEnabled() ? TickTracer::Now() : 0) {}
+        ~TraceZone()
+        {
+            if (m_start)
+                sTickTracer.Record(m_name, m_arg, m_start, TickTracer::Now());
+        }
+
+    private:
+        char const* m_name;
+        uint32 m_arg;
+        ACE_hrtime_t m_start;
+};
+
+/// Sequence of phases, each Mark() closes phase started by previous Mark() or construction
+class TraceMarker
+{
+    public:
+        explicit TraceMarker(uint32 arg = 0) : m_arg(arg) { Reset(); }
+
+        void Mark(char const* name)
+        {
+            if (!sTickTracer.IsEnabled())
+            {
+                m_start = 0;
+                return;
+            }
+
+            ACE_hrtime_t now = TickTracer::Now();
+            if (m_start && *name)
+                sTickTracer.Record(name, m_arg, m_start, now);
+
+            m_start = now;
+        }
+
+        void Reset() { m_start = sTickTracer.IsEnabled() ? TickTracer::Now() : 0; }
+
+    private:
+        uint32 m_arg;
+        ACE_hrtime_t m_start;
+};
+
+#endif
@@ -23,6 +23,7 @@
 
 #include "Common.h"
 #include "Log.h"
+#include "TickTracer.h"
 #include <ace/OS_NS_sys_time.h>
 
 class WorldTimer
@@ -51,6 +52,13 @@ class WorldTimer
             return getMSTimeDiff(oldMSTime, WorldTimer::getMSTime());
         }
 
+        // Get time difference between two high precision timestamps in microseconds
+        static inline uint32 getUSTimeDiff(const ACE_Time_Value& start, const ACE_Time_Value& end)
+        {
+            ACE_Time_Value elapsed = end - start;
+            return elapsed.sec() * 1000000 + elapsed.usec();
+        }
+
         // Get last world tick time
         static uint32 tickTime();
         // Get previous world tick time
@@ -211,8 +219,11 @@ class DiffRecorder
             _startTime = WorldTimer::getMSTime();
         }
 
+        // fmt is also used as tick trace zone name, so it has to be a literal
         inline uint32 RecordTimeFor(char const* fmt, ...)
         {
+            _trace.Mark(fmt);
+
             uint32 diffTime = WorldTimer::getMSTimeDiffToNow(_startTime);
 
             _startTime = WorldTimer::getMSTime();
@@ -234,10 +245,13 @@ class DiffRecorder
         inline void ResetDiff()
         {
             _startTime = WorldTimer::getMSTime();
+            _trace.Reset();
         }
 
     private:
 
+        TraceMarker _trace;
+
         std::string ownerName;
         uint32 _startTime;
         uint32 _diffTresholdForFile;